@@ -7,6 +7,7 @@
 #include "http_response.hpp"
 #include "http_utility.hpp"
 #include "json_html_serializer.hpp"
+#include "json_stream_serializer.hpp"
 #include "logging.hpp"
 #include "security_headers.hpp"
 
@@ -33,6 +34,21 @@ inline bool attemptZstdCompression(Response& res)
         return true;
     }
 
+    if (res.response.body().isShared())
+    {
+        // Shared contents are precompressed where it's worthwhile, and
+        // compressing them per request would defeat sharing them
+        return true;
+    }
+
+    if (res.response.body().isJson())
+    {
+        // Compressed on the fly as the json is serialized
+        res.addHeader(boost::beast::http::field::content_encoding, "zstd");
+        res.response.body().clientCompressionType = Zstd;
+        return true;
+    }
+
     std::string& strBody = res.response.body().str();
     if (strBody.empty())
     {
@@ -132,6 +148,12 @@ inline void completeResponseFields(
     BMCWEB_LOG_INFO("Response: {}", res.resultInt());
     addSecurityHeaders(res);
 
+    if (res.jsonValue.is_structured())
+    {
+        // The body below depends on Accept, including when it turns into a
+        // 304
+        res.addHeader(boost::beast::http::field::vary, "Accept");
+    }
     res.setResponseEtagAndHandleNotModified();
     if (res.jsonValue.is_structured())
     {
@@ -159,8 +181,20 @@ inline void completeResponseFields(
             // backward compatibility.
             res.addHeader(boost::beast::http::field::content_type,
                           "application/json");
-            res.write(res.jsonValue.dump(
-                2, ' ', true, nlohmann::json::error_handler_t::replace));
+            int indent =
+                http_helpers::getResponseJsonIndent(accepts, preferred);
+            if (bmcweb::countJsonNodes(res.jsonValue,
+                                       bmcweb::jsonStreamMinNodes) >=
+                bmcweb::jsonStreamMinNodes)
+            {
+                // Large enough that holding the whole serialized body, and
+                // possibly a compressed copy, is worth avoiding.
+                res.response.body().setJson(std::move(res.jsonValue), indent);
+            }
+            else
+            {
+                res.write(bmcweb::serializeJson(res.jsonValue, indent));
+            }
         }
     }
 
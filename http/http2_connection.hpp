@@ -26,6 +26,7 @@
 #include <boost/beast/http/field.hpp>
 #include <boost/beast/http/fields.hpp>
 #include <boost/beast/http/message.hpp>
+#include <boost/beast/http/status.hpp>
 #include <boost/beast/http/verb.hpp>
 #include <boost/optional/optional.hpp>
 #include <boost/system/error_code.hpp>
@@ -36,6 +37,7 @@
 #include <cstddef>
 #include <cstdint>
 #include <functional>
+#include <iterator>
 #include <map>
 #include <memory>
 #include <optional>
@@ -69,7 +71,8 @@ class HTTP2Connection :
   public:
     HTTP2Connection(
         boost::asio::ssl::stream<Adaptor>&& adaptorIn, Handler* handlerIn,
-        std::function<std::string()>& getCachedDateStrF, HttpType httpTypeIn,
+        std::function<std::string_view()>& getCachedDateStrF,
+        HttpType httpTypeIn,
         const std::shared_ptr<persistent_data::UserSession>& mtlsSessionIn,
         boost::asio::ip::address ipIn) :
         httpType(httpTypeIn), adaptor(std::move(adaptorIn)),
@@ -237,12 +240,26 @@ class HTTP2Connection :
         boost::beast::http::fields& fields = res.fields();
         std::string code = std::to_string(res.resultInt());
         std::vector<nghttp2_nv> hdr;
+        hdr.reserve(
+            static_cast<size_t>(std::distance(fields.begin(), fields.end())) +
+            1);
         hdr.emplace_back(
             headerFromStringViews(":status", code, NGHTTP2_NV_FLAG_NONE));
+        // The fields stay in stream.res, untouched, until the stream closes,
+        // so nghttp2 can point at the values instead of copying them.  Names
+        // are still copied, because that is where nghttp2 lowercases them
+        // as HTTP/2 requires.
+        constexpr uint8_t noCopy = NGHTTP2_NV_FLAG_NO_COPY_VALUE;
         for (const boost::beast::http::fields::value_type& header : fields)
         {
-            hdr.emplace_back(headerFromStringViews(
-                header.name_string(), header.value(), NGHTTP2_NV_FLAG_NONE));
+            // Bodies of unknown length are marked chunked for HTTP/1.1, but
+            // HTTP/2 frames the data itself and forbids the header.
+            if (header.name() == boost::beast::http::field::transfer_encoding)
+            {
+                continue;
+            }
+            hdr.emplace_back(headerFromStringViews(header.name_string(),
+                                                   header.value(), noCopy));
         }
         http::response<bmcweb::HttpBody>& fbody = res.response;
         stream.writer.emplace(fbody.base(), fbody.body());
@@ -327,32 +344,60 @@ class HTTP2Connection :
 
         auto asyncResp =
             std::make_shared<bmcweb::AsyncResp>(std::move(it->second.res));
+        it->second.req->ipAddress = ip;
         if constexpr (!BMCWEB_INSECURE_DISABLE_AUTH)
         {
-            thisReq.session = authentication::authenticate(
-                ip, asyncResp->res, thisReq.method(), thisReq.req, mtlsSession);
-            if (!authentication::isOnAllowlist(thisReq.url().path(),
-                                               thisReq.method()) &&
-                thisReq.session == nullptr)
-            {
-                BMCWEB_LOG_WARNING("Authentication failed");
-                forward_unauthorized::sendUnauthorized(
-                    thisReq.url().encoded_path(),
-                    thisReq.getHeaderValue("X-Requested-With"),
-                    thisReq.getHeaderValue("Accept"), asyncResp->res);
-                return 0;
-            }
+            // Basic auth runs PAM off of the io_context, so this may complete
+            // asynchronously
+            authentication::authenticate(
+                ip, asyncResp->res, thisReq.method(), thisReq.req, mtlsSession,
+                std::bind_front(&self_type::afterAuthenticate, this,
+                                shared_from_this(), it->second.req,
+                                asyncResp));
+            return 0;
         }
+        handleAuthenticated(it->second.req, asyncResp);
+        return 0;
+    }
+
+    void afterAuthenticate(
+        const std::shared_ptr<self_type>& /*self*/,
+        const std::shared_ptr<Request>& req,
+        const std::shared_ptr<bmcweb::AsyncResp>& asyncResp,
+        const std::shared_ptr<persistent_data::UserSession>& session)
+    {
+        req->session = session;
+        if (asyncResp->res.result() ==
+            boost::beast::http::status::service_unavailable)
+        {
+            // Too busy to check the credentials
+            return;
+        }
+        if (!authentication::isOnAllowlist(req->url().path(), req->method()) &&
+            req->session == nullptr)
+        {
+            BMCWEB_LOG_WARNING("Authentication failed");
+            forward_unauthorized::sendUnauthorized(
+                req->url().encoded_path(),
+                req->getHeaderValue("X-Requested-With"),
+                req->getHeaderValue("Accept"), asyncResp->res);
+            return;
+        }
+        handleAuthenticated(req, asyncResp);
+    }
+
+    void handleAuthenticated(
+        const std::shared_ptr<Request>& req,
+        const std::shared_ptr<bmcweb::AsyncResp>& asyncResp)
+    {
         std::string_view expectedEtag =
-            thisReq.getHeaderValue(boost::beast::http::field::if_none_match);
+            req->getHeaderValue(boost::beast::http::field::if_none_match);
         BMCWEB_LOG_DEBUG("Setting expected etag {}", expectedEtag);
         if (!expectedEtag.empty())
         {
             asyncResp->res.setExpectedEtag(expectedEtag);
         }
-        it->second.req->ipAddress = ip;
-        handler->handle(it->second.req, asyncResp);
-        return 0;
+        handler->handle(req, asyncResp);
     }
 
     int onDataChunkRecvCallback(uint8_t /*flags*/, int32_t streamId,
@@ -712,7 +757,7 @@ class HTTP2Connection :
     nghttp2_session ngSession;
 
     Handler* handler;
-    std::function<std::string()>& getCachedDateStr;
+    std::function<std::string_view()>& getCachedDateStr;
 
     std::shared_ptr<persistent_data::UserSession> mtlsSession;
     boost::asio::ip::address ip;
@@ -3,6 +3,7 @@
 #pragma once
 
 #include "duplicatable_file_handle.hpp"
+#include "json_stream_serializer.hpp"
 #include "logging.hpp"
 #include "multipart_parser.hpp"
 #include "utility.hpp"
@@ -21,6 +22,7 @@
 #include <boost/none.hpp>
 #include <boost/optional/optional.hpp>
 #include <boost/system/error_code.hpp>
+#include <nlohmann/json.hpp>
 
 #include <algorithm>
 #include <array>
@@ -28,7 +30,9 @@
 #include <cstdint>
 #include <functional>
 #include <limits>
+#include <memory>
 #include <optional>
+#include <span>
 #include <string>
 #include <string_view>
 #include <utility>
@@ -72,12 +76,27 @@ struct MultiPartBody
     std::vector<FormPart> parts;
 };
 
+// Immutable contents shared between responses, like cached static files
+struct SharedBody
+{
+    std::shared_ptr<const std::string> data;
+};
+
+// A json document that is serialized as it is written out, so that large
+// responses never need to exist as one string.
+struct JsonBody
+{
+    nlohmann::json json;
+    int indent = 2;
+};
+
 class HttpBody::value_type
 {
     friend HttpBody::reader;
     friend HttpBody::writer;
 
-    std::variant<std::string, FileBody, MultiPartBody> bodyData;
+    std::variant<std::string, FileBody, MultiPartBody, JsonBody, SharedBody>
+        bodyData;
 
     std::span<const FormPart> getMimeFields() const
     {
@@ -97,6 +116,23 @@ class HttpBody::value_type
         return {};
     }
 
+    // Body contents held in memory, either owned or shared
+    std::string_view memoryView() const
+    {
+        if (const auto* s = std::get_if<std::string>(&bodyData))
+        {
+            return *s;
+        }
+        if (const auto* shared = std::get_if<SharedBody>(&bodyData))
+        {
+            if (shared->data)
+            {
+                return *shared->data;
+            }
+        }
+        return {};
+    }
+
   public:
     value_type() = default;
     explicit value_type(std::string_view s) : bodyData(std::string(s)) {}
@@ -145,6 +181,26 @@ class HttpBody::value_type
         return emptyString;
     }
 
+    bool isJson() const
+    {
+        return std::holds_alternative<JsonBody>(bodyData);
+    }
+
+    void setJson(nlohmann::json&& json, int indent)
+    {
+        bodyData = JsonBody{std::move(json), indent};
+    }
+
+    bool isShared() const
+    {
+        return std::holds_alternative<SharedBody>(bodyData);
+    }
+
+    void setShared(std::shared_ptr<const std::string> data)
+    {
+        bodyData = SharedBody{std::move(data)};
+    }
+
     std::span<FormPart> multipart()
     {
         if (auto* multiPartBody = std::get_if<MultiPartBody>(&bodyData))
@@ -160,6 +216,10 @@ class HttpBody::value_type
         {
             return s->size();
         }
+        if (isShared())
+        {
+            return memoryView().size();
+        }
         if (const auto* fileBody = std::get_if<FileBody>(&bodyData))
         {
             if (fileBody->fileHandle.fileHandle.is_open() && fileBody->fileSize)
@@ -242,6 +302,12 @@ class HttpBody::writer
 
     std::optional<ZstdDecompressor> zstdDecompressor;
     std::optional<ZstdCompressor> zstdCompressor;
+    std::optional<JsonStreamSerializer> jsonSerializer;
+
+    // Compressed output not yet handed out, and whether the compressor has
+    // been given the end of the body.
+    std::span<const uint8_t> compressedRemaining;
+    bool compressionDone = false;
 
     value_type& body;
     size_t sent = 0;
@@ -257,6 +323,10 @@ class HttpBody::writer
     writer(boost::beast::http::header<IsRequest, Fields>& /*header*/,
            value_type& bodyIn) : body(bodyIn)
     {
+        if (JsonBody* jsonBody = std::get_if<JsonBody>(&body.bodyData))
+        {
+            jsonSerializer.emplace(jsonBody->json, jsonBody->indent);
+        }
         // If zstd compressed and client doesn't support zstd, need to
         // decompress
         if (body.compressionType == CompressionType::Zstd &&
@@ -268,12 +338,12 @@ class HttpBody::writer
             body.clientCompressionType == CompressionType::Zstd)
         {
             std::optional<size_t> size = body.payloadSize();
-            if (size)
+            if (size || jsonSerializer)
             {
                 BMCWEB_LOG_DEBUG(
-                    "Body is raw, client supports zstd, and paylod is not streaming.  Compressing.");
+                    "Body is raw and client supports zstd.  Compressing.");
                 zstdCompressor.emplace();
-                if (!zstdCompressor->init(*size))
+                if (!zstdCompressor->init(size))
                 {
                     BMCWEB_LOG_ERROR("Failed to initialize Zstd Compressor");
                     zstdCompressor = std::nullopt;
@@ -295,16 +365,86 @@ class HttpBody::writer
 
     boost::optional<std::pair<const_buffers_type, bool>> getWithMaxSize(
         boost::beast::error_code& ec, size_t maxSize)
+    {
+        if (zstdCompressor)
+        {
+            return getCompressed(ec, maxSize);
+        }
+        return getUncompressed(ec, maxSize);
+    }
+
+  private:
+    boost::optional<std::pair<const_buffers_type, bool>> getCompressed(
+        boost::beast::error_code& ec, size_t maxSize)
+    {
+        // Compressed output can be larger than the input that produced it,
+        // or empty while zstd buffers, so compress whole chunks and hand the
+        // output out in pieces no larger than maxSize.
+        while (compressedRemaining.empty() && !compressionDone)
+        {
+            boost::optional<std::pair<const_buffers_type, bool>> raw =
+                getUncompressed(ec, readBufSize);
+            if (!raw)
+            {
+                return boost::none;
+            }
+            BMCWEB_LOG_DEBUG("Compressing body more={}", raw->second);
+            std::span<const uint8_t> spanIn(
+                static_cast<const uint8_t*>(raw->first.data()),
+                raw->first.size());
+            std::optional<std::span<const uint8_t>> compressed =
+                zstdCompressor->compress(spanIn, raw->second);
+            if (!compressed)
+            {
+                return boost::none;
+            }
+            compressedRemaining = *compressed;
+            compressionDone = !raw->second;
+        }
+
+        std::pair<const_buffers_type, bool> ret;
+        size_t toReturn = std::min(maxSize, compressedRemaining.size());
+        ret.first = const_buffers_type(compressedRemaining.data(), toReturn);
+        compressedRemaining = compressedRemaining.subspan(toReturn);
+        ret.second = !compressedRemaining.empty() || !compressionDone;
+        BMCWEB_LOG_INFO("Returning {} bytes more={}", ret.first.size(),
+                        ret.second);
+        return ret;
+    }
+
+    std::pair<const_buffers_type, bool> getJson(size_t maxSize)
+    {
+        std::pair<const_buffers_type, bool> ret;
+        if (sent == buf.size())
+        {
+            buf.clear();
+            sent = 0;
+            jsonSerializer->next(buf, readBufSize);
+        }
+        size_t toReturn = std::min(maxSize, buf.size() - sent);
+        ret.first = const_buffers_type(&buf[sent], toReturn);
+        sent += toReturn;
+        ret.second = sent < buf.size() || !jsonSerializer->done();
+        return ret;
+    }
+
+    boost::optional<std::pair<const_buffers_type, bool>> getUncompressed(
+        boost::beast::error_code& ec, size_t maxSize)
     {
         std::pair<const_buffers_type, bool> ret;
-        if (!body.file().is_open())
+        if (jsonSerializer)
+        {
+            ret = getJson(maxSize);
+        }
+        else if (!body.file().is_open())
         {
-            size_t remain = body.str().size() - sent;
+            std::string_view data = body.memoryView();
+            size_t remain = data.size() - sent;
             size_t toReturn = std::min(maxSize, remain);
-            ret.first = const_buffers_type(&body.str()[sent], toReturn);
+            ret.first = const_buffers_type(data.substr(sent).data(), toReturn);
 
             sent += toReturn;
-            ret.second = sent < body.str().size();
+            ret.second = sent < data.size();
         }
         else
         {
@@ -359,20 +499,6 @@ class HttpBody::writer
             }
             ret.first = *decompressed;
         }
-        if (zstdCompressor)
-        {
-            BMCWEB_LOG_DEBUG("Compressing body more={}", ret.second);
-            std::span<const uint8_t> spanIn(
-                static_cast<const uint8_t*>(ret.first.data()),
-                ret.first.size());
-            std::optional<std::span<const uint8_t>> compressed =
-                zstdCompressor->compress(spanIn, ret.second);
-            if (!compressed)
-            {
-                return boost::none;
-            }
-            ret.first = *compressed;
-        }
         BMCWEB_LOG_INFO("Returning {} bytes more={}", ret.first.size(),
                         ret.second);
         return ret;
@@ -9,6 +9,7 @@
 #include "boost_formatters.hpp"
 #include "http_body.hpp"
 #include "http_response.hpp"
+#include "io_context_singleton.hpp"
 #include "logging.hpp"
 #include "ssl_key_handler.hpp"
 
@@ -41,6 +42,7 @@
 #include <boost/url/url.hpp>
 #include <boost/url/url_view_base.hpp>
 
+#include <algorithm>
 #include <chrono>
 #include <cstdint>
 #include <cstdlib>
@@ -59,8 +61,10 @@ namespace crow
 {
 // With Redfish Aggregation it is assumed we will connect to another
 // instance of BMCWeb which can handle 100 simultaneous connections.
-constexpr size_t maxPoolSize = 20;
-constexpr size_t maxRequestQueueSize = 500;
+constexpr size_t maxPoolSize =
+    static_cast<size_t>(BMCWEB_HTTP_CLIENT_POOL_SIZE);
+constexpr size_t maxRequestQueueSize =
+    static_cast<size_t>(BMCWEB_HTTP_CLIENT_REQUEST_QUEUE_SIZE);
 constexpr unsigned int httpReadBodyLimit = 131072;
 constexpr unsigned int httpReadBufferSize = 4096;
 
@@ -80,8 +84,6 @@ enum class ConnState
     recvFailed,
     idle,
     closed,
-    suspended,
-    terminated,
     abortConnection,
     sslInitFailed,
     retry
@@ -119,14 +121,20 @@ struct ConnectionPolicy
         invalidResp = defaultRetryHandler;
 };
 
+// Called with whether to keep the connection alive, the connection's id, the
+// response, and whether the retry policy gave up on the request, in which
+// case the response is a 502 made up by the client
+using ConnectionCallback = std::function<void(bool, uint32_t, Response&, bool)>;
+
 struct PendingRequest
 {
     boost::beast::http::request<bmcweb::HttpBody> req;
-    std::function<void(bool, uint32_t, Response&)> callback;
-    PendingRequest(
-        boost::beast::http::request<bmcweb::HttpBody>&& reqIn,
-        const std::function<void(bool, uint32_t, Response&)>& callbackIn) :
-        req(std::move(reqIn)), callback(callbackIn)
+    ConnectionCallback callback;
+    std::shared_ptr<ConnectionPolicy> policy;
+    PendingRequest(boost::beast::http::request<bmcweb::HttpBody>&& reqIn,
+                   const ConnectionCallback& callbackIn,
+                   const std::shared_ptr<ConnectionPolicy>& policyIn) :
+        req(std::move(reqIn)), callback(callbackIn), policy(policyIn)
     {}
 };
 
@@ -137,6 +145,8 @@ class ConnectionInfo : public std::enable_shared_from_this<ConnectionInfo>
     ConnState state = ConnState::initialized;
     uint32_t retryCount = 0;
     std::string subId;
+    // The policy of whoever sent the current request, since pools can be
+    // shared between senders with different retry policies
     std::shared_ptr<ConnectionPolicy> connPolicy;
     boost::urls::url host;
     ensuressl::VerifyCertificate verifyCert;
@@ -149,7 +159,7 @@ class ConnectionInfo : public std::enable_shared_from_this<ConnectionInfo>
     Response res;
 
     // Async callables
-    std::function<void(bool, uint32_t, Response&)> callback;
+    ConnectionCallback callback;
 
     boost::asio::io_context& ioc;
 
@@ -439,7 +449,7 @@ class ConnectionInfo : public std::enable_shared_from_this<ConnectionInfo>
         res.response = parser->release();
         if (callback)
         {
-            callback(parser->keep_alive(), connId, res);
+            callback(parser->keep_alive(), connId, res, false);
         }
         res.clear();
     }
@@ -475,22 +485,15 @@ class ConnectionInfo : public std::enable_shared_from_this<ConnectionInfo>
             BMCWEB_LOG_ERROR("Maximum number of retries reached. {}", host);
             BMCWEB_LOG_DEBUG("Retry policy: {}", connPolicy->retryPolicyAction);
 
-            if (connPolicy->retryPolicyAction == "TerminateAfterRetries")
-            {
-                // TODO: delete subscription
-                state = ConnState::terminated;
-            }
-            if (connPolicy->retryPolicyAction == "SuspendRetries")
-            {
-                state = ConnState::suspended;
-            }
-
             // We want to return a 502 to indicate there was an error with
-            // the external server
+            // the external server, and flag that the retries ran out.  What
+            // that means under the retry policy is up to the sender; the
+            // connection itself goes back to the pool once the callback has
+            // closed it, since other senders share it.
             res.result(boost::beast::http::status::bad_gateway);
             if (callback)
             {
-                callback(false, connId, res);
+                callback(false, connId, res, true);
             }
             res.clear();
 
@@ -710,6 +713,7 @@ class ConnectionPool : public std::enable_shared_from_this<ConnectionPool>
         PendingRequest& nextReq = requestQueue.front();
         conn.req = std::move(nextReq.req);
         conn.callback = std::move(nextReq.callback);
+        conn.connPolicy = std::move(nextReq.policy);
 
         BMCWEB_LOG_DEBUG("Setting properties for connection {}, id: {}",
                          conn.host, conn.connId);
@@ -778,21 +782,57 @@ class ConnectionPool : public std::enable_shared_from_this<ConnectionPool>
         }
     }
 
-    void sendData(std::string&& data, const boost::urls::url_view_base& destUri,
-                  const boost::beast::http::fields& httpHeader,
-                  const boost::beast::http::verb verb,
-                  const std::function<void(Response&)>& resHandler)
+    static boost::beast::http::request<bmcweb::HttpBody> makeRequest(
+        const boost::urls::url_view_base& destUri,
+        const boost::beast::http::fields& httpHeader,
+        const boost::beast::http::verb verb)
     {
-        // Construct the request to be sent
         boost::beast::http::request<bmcweb::HttpBody> thisReq(
             verb, destUri.encoded_target(), 11, "", httpHeader);
         thisReq.set(boost::beast::http::field::host,
                     destUri.encoded_host_address());
         thisReq.keep_alive(true);
+        return thisReq;
+    }
+
+    void sendData(std::string&& data, const boost::urls::url_view_base& destUri,
+                  const boost::beast::http::fields& httpHeader,
+                  const boost::beast::http::verb verb,
+                  const std::function<void(Response&)>& resHandler,
+                  const std::shared_ptr<ConnectionPolicy>& policy,
+                  const std::function<void()>& retriesExhausted)
+    {
+        boost::beast::http::request<bmcweb::HttpBody> thisReq =
+            makeRequest(destUri, httpHeader, verb);
         thisReq.body().str() = std::move(data);
+        sendRequest(std::move(thisReq), resHandler, policy, retriesExhausted);
+    }
+
+    // Sends a body that may be shared with other requests, like one event
+    // sent to many subscribers, without copying it
+    void sendData(std::shared_ptr<const std::string> data,
+                  const boost::urls::url_view_base& destUri,
+                  const boost::beast::http::fields& httpHeader,
+                  const boost::beast::http::verb verb,
+                  const std::function<void(Response&)>& resHandler,
+                  const std::shared_ptr<ConnectionPolicy>& policy,
+                  const std::function<void()>& retriesExhausted)
+    {
+        boost::beast::http::request<bmcweb::HttpBody> thisReq =
+            makeRequest(destUri, httpHeader, verb);
+        thisReq.body().setShared(std::move(data));
+        sendRequest(std::move(thisReq), resHandler, policy, retriesExhausted);
+    }
+
+    void sendRequest(boost::beast::http::request<bmcweb::HttpBody>&& thisReq,
+                     const std::function<void(Response&)>& resHandler,
+                     const std::shared_ptr<ConnectionPolicy>& policy,
+                     const std::function<void()>& retriesExhausted)
+    {
         thisReq.prepare_payload();
         auto cb = std::bind_front(&ConnectionPool::afterSendData,
-                                  weak_from_this(), resHandler);
+                                  weak_from_this(), resHandler,
+                                  retriesExhausted);
         // Reuse an existing connection if one is available
         for (unsigned int i = 0; i < connections.size(); i++)
         {
@@ -803,6 +843,7 @@ class ConnectionPool : public std::enable_shared_from_this<ConnectionPool>
             {
                 conn->req = std::move(thisReq);
                 conn->callback = std::move(cb);
+                conn->connPolicy = policy;
                 std::string commonMsg = std::format("{} from pool {}", i, id);
 
                 if (conn->state == ConnState::idle)
@@ -822,19 +863,21 @@ class ConnectionPool : public std::enable_shared_from_this<ConnectionPool>
 
         // All connections in use so create a new connection or add request
         // to the queue
-        if (connections.size() < connPolicy->maxConnections)
+        if (connections.size() < std::min(policy->maxConnections, maxPoolSize))
         {
             BMCWEB_LOG_DEBUG("Adding new connection to pool {}", id);
             auto conn = addConnection();
             conn->req = std::move(thisReq);
             conn->callback = std::move(cb);
+            conn->connPolicy = policy;
             conn->doResolve();
         }
         else if (requestQueue.size() < maxRequestQueueSize)
         {
             BMCWEB_LOG_DEBUG("Max pool size reached. Adding data to queue {}",
                              id);
-            requestQueue.emplace_back(std::move(thisReq), std::move(cb));
+            requestQueue.emplace_back(std::move(thisReq), std::move(cb),
+                                      policy);
         }
         else
         {
@@ -848,9 +891,11 @@ class ConnectionPool : public std::enable_shared_from_this<ConnectionPool>
     }
 
     // Callback to be called once the request has been sent
-    static void afterSendData(const std::weak_ptr<ConnectionPool>& weakSelf,
-                              const std::function<void(Response&)>& resHandler,
-                              bool keepAlive, uint32_t connId, Response& res)
+    static void afterSendData(
+        const std::weak_ptr<ConnectionPool>& weakSelf,
+        const std::function<void(Response&)>& resHandler,
+        const std::function<void()>& retriesExhaustedHandler, bool keepAlive,
+        uint32_t connId, Response& res, bool retriesExhausted)
     {
         // If requests remain in the queue then we want to reuse this
         // connection to send the next request
@@ -865,6 +910,10 @@ class ConnectionPool : public std::enable_shared_from_this<ConnectionPool>
         // Allow provided callback to perform additional processing of the
         // request
         resHandler(res);
+        if (retriesExhausted && retriesExhaustedHandler)
+        {
+            retriesExhaustedHandler();
+        }
 
         self->sendNext(keepAlive, connId);
     }
@@ -896,27 +945,6 @@ class ConnectionPool : public std::enable_shared_from_this<ConnectionPool>
         // Initialize the pool with a single connection
         addConnection();
     }
-
-    // Check whether all connections are terminated
-    bool areAllConnectionsTerminated()
-    {
-        if (connections.empty())
-        {
-            BMCWEB_LOG_DEBUG("There are no connections for pool id:{}", id);
-            return false;
-        }
-        for (const auto& conn : connections)
-        {
-            if (conn != nullptr && conn->state != ConnState::terminated)
-            {
-                BMCWEB_LOG_DEBUG(
-                    "Not all connections of pool id:{} are terminated", id);
-                return false;
-            }
-        }
-        BMCWEB_LOG_INFO("All connections of pool id:{} are terminated", id);
-        return true;
-    }
 };
 
 class HttpClient
@@ -937,6 +965,27 @@ class HttpClient
                          res.resultInt());
     }
 
+    // Finds the pool of connections to destUrl, creating it if needed
+    ConnectionPool& getPool(const boost::urls::url_view_base& destUrl,
+                            ensuressl::VerifyCertificate verifyCert)
+    {
+        std::string_view verify = "ssl_verify";
+        if (verifyCert == ensuressl::VerifyCertificate::NoVerify)
+        {
+            verify = "ssl no verify";
+        }
+        std::string clientKey =
+            std::format("{}{}://{}", verify, destUrl.scheme(),
+                        destUrl.encoded_host_and_port());
+        auto pool = connectionPools.try_emplace(clientKey);
+        if (pool.first->second == nullptr)
+        {
+            pool.first->second = std::make_shared<ConnectionPool>(
+                ioc, clientKey, connPolicy, destUrl, verifyCert);
+        }
+        return *pool.first->second;
+    }
+
   public:
     HttpClient() = delete;
     explicit HttpClient(boost::asio::io_context& iocIn,
@@ -963,49 +1012,51 @@ class HttpClient
     }
 
     // Send request to destIP and use the provided callback to
-    // handle the response
-    void sendDataWithCallback(std::string&& data,
-                              const boost::urls::url_view_base& destUrl,
-                              ensuressl::VerifyCertificate verifyCert,
-                              const boost::beast::http::fields& httpHeader,
-                              const boost::beast::http::verb verb,
-                              const std::function<void(Response&)>& resHandler)
+    // handle the response.  The request is retried according to policy if
+    // one is given, or else the policy the client was created with.  When
+    // the policy gives up, resHandler gets a 502 and retriesExhausted is then
+    // called, so that it can be told apart from a 502 sent by the server.
+    void sendDataWithCallback(
+        std::string&& data, const boost::urls::url_view_base& destUrl,
+        ensuressl::VerifyCertificate verifyCert,
+        const boost::beast::http::fields& httpHeader,
+        const boost::beast::http::verb verb,
+        const std::function<void(Response&)>& resHandler,
+        const std::shared_ptr<ConnectionPolicy>& policy = nullptr,
+        const std::function<void()>& retriesExhausted = nullptr)
     {
-        std::string_view verify = "ssl_verify";
-        if (verifyCert == ensuressl::VerifyCertificate::NoVerify)
-        {
-            verify = "ssl no verify";
-        }
-        std::string clientKey =
-            std::format("{}{}://{}", verify, destUrl.scheme(),
-                        destUrl.encoded_host_and_port());
-        auto pool = connectionPools.try_emplace(clientKey);
-        if (pool.first->second == nullptr)
-        {
-            pool.first->second = std::make_shared<ConnectionPool>(
-                ioc, clientKey, connPolicy, destUrl, verifyCert);
-        }
-        // Send the data using either the existing connection pool or the
-        // newly created connection pool
-        pool.first->second->sendData(std::move(data), destUrl, httpHeader, verb,
-                                     resHandler);
+        getPool(destUrl, verifyCert)
+            .sendData(std::move(data), destUrl, httpHeader, verb, resHandler,
+                      policy != nullptr ? policy : connPolicy,
+                      retriesExhausted);
     }
 
-    // Test whether all connections are terminated (after MaxRetryAttempts)
-    bool isTerminated()
+    // As above, but data is shared rather than copied into the request
+    void sendDataWithCallback(
+        std::shared_ptr<const std::string> data,
+        const boost::urls::url_view_base& destUrl,
+        ensuressl::VerifyCertificate verifyCert,
+        const boost::beast::http::fields& httpHeader,
+        const boost::beast::http::verb verb,
+        const std::function<void(Response&)>& resHandler,
+        const std::shared_ptr<ConnectionPolicy>& policy = nullptr,
+        const std::function<void()>& retriesExhausted = nullptr)
     {
-        for (const auto& pool : connectionPools)
-        {
-            if (pool.second != nullptr &&
-                !pool.second->areAllConnectionsTerminated())
-            {
-                BMCWEB_LOG_DEBUG(
-                    "Not all of client connections are terminated");
-                return false;
-            }
-        }
-        BMCWEB_LOG_DEBUG("All client connections are terminated");
-        return true;
+        getPool(destUrl, verifyCert)
+            .sendData(std::move(data), destUrl, httpHeader, verb, resHandler,
+                      policy != nullptr ? policy : connPolicy,
+                      retriesExhausted);
     }
 };
+
+// A client for senders that would otherwise each open their own connections
+// to the same destination, like event subscriptions.  Pools are shared by
+// scheme, host, port and certificate verification, and each request is
+// retried under the policy it was sent with.
+inline HttpClient& getSharedHttpClient()
+{
+    static HttpClient client(getIoContext(),
+                             std::make_shared<ConnectionPolicy>());
+    return client;
+}
 } // namespace crow
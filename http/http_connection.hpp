@@ -20,8 +20,13 @@
 #include "str_utility.hpp"
 #include "utility.hpp"
 
+#include <sys/sendfile.h>
+#include <sys/types.h>
+#include <unistd.h>
+
 #include <boost/asio/error.hpp>
 #include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/socket_base.hpp>
 #include <boost/asio/ssl/error.hpp>
 #include <boost/asio/ssl/stream.hpp>
 #include <boost/asio/ssl/stream_base.hpp>
@@ -38,16 +43,21 @@
 #include <boost/beast/http/parser.hpp>
 #include <boost/beast/http/read.hpp>
 #include <boost/beast/http/rfc7230.hpp>
+#include <boost/beast/http/serializer.hpp>
 #include <boost/beast/http/status.hpp>
 #include <boost/beast/http/verb.hpp>
+#include <boost/beast/http/write.hpp>
 #include <boost/none.hpp>
 #include <boost/optional/optional.hpp>
 #include <boost/url/url_view.hpp>
 
+#include <algorithm>
 #include <bit>
+#include <cerrno>
 #include <chrono>
 #include <cstddef>
 #include <cstdint>
+#include <deque>
 #include <functional>
 #include <memory>
 #include <optional>
@@ -70,6 +80,10 @@ constexpr uint64_t loggedOutPostBodyLimit = 4096U;
 
 constexpr uint32_t httpHeaderLimit = 8192U;
 
+// Requests read ahead of their responses being written, including the one
+// being written.  Bounds the memory a single connection can pin by pipelining.
+constexpr size_t maxPipelinedRequests = 8U;
+
 enum class DeadlineTimerType
 {
     Default,
@@ -85,7 +99,7 @@ class Connection :
   public:
     Connection(Handler* handlerIn, HttpType httpTypeIn,
                boost::asio::steady_timer&& timerIn,
-               std::function<std::string()>& getCachedDateStrF,
+               std::function<std::string_view()>& getCachedDateStrF,
                boost::asio::ssl::stream<Adaptor>&& adaptorIn) :
         httpType(httpTypeIn), adaptor(std::move(adaptorIn)), handler(handlerIn),
         timer(std::move(timerIn)), getCachedDateStr(getCachedDateStrF)
@@ -312,7 +326,8 @@ class Connection :
     }
 
     // returns whether connection was upgraded
-    bool doUpgrade(const std::shared_ptr<bmcweb::AsyncResp>& asyncResp)
+    bool doUpgrade(const std::shared_ptr<bmcweb::AsyncResp>& asyncResp,
+                   uint64_t responseId)
     {
         using boost::beast::http::field;
         using boost::beast::http::token_list;
@@ -353,7 +368,8 @@ class Connection :
             if (isWebsocket || isSse)
             {
                 asyncResp->res.setCompleteRequestHandler(
-                    [self(shared_from_this())](crow::Response& thisRes) {
+                    [self(shared_from_this()),
+                     responseId](crow::Response& thisRes) {
                         if (thisRes.result() != boost::beast::http::status::ok)
                         {
                             // When any error occurs before handle upgradation,
@@ -362,7 +378,7 @@ class Connection :
                             // which implies successful handle upgrade. Response
                             // needs to be sent over this connection only on
                             // failure.
-                            self->completeRequest(thisRes);
+                            self->completeRequest(responseId, thisRes);
                             return;
                         }
                     });
@@ -383,6 +399,57 @@ class Connection :
         return false;
     }
 
+    // Requests that may take over the socket
+    static bool mayUpgrade(
+        const boost::beast::http::request<bmcweb::HttpBody>& value)
+    {
+        using boost::beast::http::field;
+        return boost::beast::http::token_list{value[field::connection]}.exists(
+                   "upgrade") ||
+               isContentTypeAllowed(value[field::accept],
+                                    http_helpers::ContentType::EventStream,
+                                    false);
+    }
+
+    // Only requests that can't change anything may be handled while earlier
+    // ones are still outstanding (RFC 9112 9.3.2)
+    static bool isSafeMethod(boost::beast::http::verb method)
+    {
+        return method == boost::beast::http::verb::get ||
+               method == boost::beast::http::verb::head;
+    }
+
+    // Whether a request that isn't safe has been read and its response not
+    // yet written
+    bool unsafeRequestOutstanding() const
+    {
+        return (writing && !current.safe) ||
+               std::ranges::any_of(pendingResponses, std::logical_not<>(),
+                                   &PendingResponse::safe);
+    }
+
+    void handleRequest()
+    {
+        readInProgress = false;
+        if (!parser)
+        {
+            return;
+        }
+        // An upgrade hands the socket to something else, and a request that
+        // isn't safe must not run alongside earlier ones, so both wait for
+        // the responses to earlier requests to be written.
+        const auto& value = parser->get();
+        if ((writing || !pendingResponses.empty()) &&
+            (mayUpgrade(value) || !isSafeMethod(value.method())))
+        {
+            BMCWEB_LOG_DEBUG("{} Deferring {} until responses are written",
+                             logPtr(this), value.method_string());
+            handleWhenIdle = true;
+            return;
+        }
+        handle();
+    }
+
     void handle()
     {
         std::error_code reqEc;
@@ -391,17 +458,23 @@ class Connection :
             return;
         }
         req = std::make_shared<Request>(parser->release(), reqEc);
+        PendingResponse& pending = pendingResponses.emplace_back();
+        pending.id = nextResponseId++;
+        pending.req = req;
+        pending.safe = isSafeMethod(req->method());
+        uint64_t responseId = pending.id;
         if (reqEc)
         {
             BMCWEB_LOG_DEBUG("Request failed to construct{}", reqEc.message());
             res.result(boost::beast::http::status::bad_request);
-            completeRequest(res);
+            completeRequest(responseId, res);
             return;
         }
         req->session = userSession;
         using boost::beast::http::field;
-        accept = req->getHeaderValue(field::accept);
-        acceptEncoding = req->getHeaderValue(field::accept_encoding);
+        pending.accept = req->getHeaderValue(field::accept);
+        pending.acceptEncoding = req->getHeaderValue(field::accept_encoding);
+        pending.keepAlive = req->keepAlive();
         // Fetch the client IP address
         req->ipAddress = ip;
 
@@ -411,7 +484,7 @@ class Connection :
             if (req->getHeaderValue(field::host).empty())
             {
                 res.result(boost::beast::http::status::bad_request);
-                completeRequest(res);
+                completeRequest(responseId, res);
                 return;
             }
         }
@@ -423,10 +496,9 @@ class Connection :
 
         if (res.completed)
         {
-            completeRequest(res);
+            completeRequest(responseId, res);
             return;
         }
-        keepAlive = req->keepAlive();
 
         if (authenticationEnabled)
         {
@@ -439,7 +511,7 @@ class Connection :
                     req->url().encoded_path(),
                     req->getHeaderValue("X-Requested-With"),
                     req->getHeaderValue("Accept"), res);
-                completeRequest(res);
+                completeRequest(responseId, res);
                 return;
             }
         }
@@ -447,10 +519,10 @@ class Connection :
         auto asyncResp = std::make_shared<bmcweb::AsyncResp>();
         BMCWEB_LOG_DEBUG("Setting completion handler");
         asyncResp->res.setCompleteRequestHandler(
-            [self(shared_from_this())](Response& thisRes) {
-                self->completeRequest(thisRes);
+            [self(shared_from_this()), responseId](Response& thisRes) {
+                self->completeRequest(responseId, thisRes);
             });
-        if (doUpgrade(asyncResp))
+        if (doUpgrade(asyncResp, responseId))
         {
             return;
         }
@@ -461,6 +533,60 @@ class Connection :
             asyncResp->res.setExpectedEtag(expectedEtag);
         }
         handler->handle(req, asyncResp);
+
+        readNextRequest();
+    }
+
+    // Starts reading the next request while earlier ones are still being
+    // handled or written, up to maxPipelinedRequests.  Nothing is read past
+    // a request that isn't safe until its response has been written.
+    void readNextRequest()
+    {
+        if (readInProgress || peerClosed || handleWhenIdle)
+        {
+            return;
+        }
+        if (unsafeRequestOutstanding())
+        {
+            BMCWEB_LOG_DEBUG("{} Waiting for a write to finish before reading",
+                             logPtr(this));
+            return;
+        }
+        bool lastKeepAlive =
+            pendingResponses.empty() ? (!writing || current.keepAlive)
+                                     : pendingResponses.back().keepAlive;
+        if (!lastKeepAlive)
+        {
+            return;
+        }
+        size_t outstanding = pendingResponses.size() + (writing ? 1U : 0U);
+        if (outstanding >= maxPipelinedRequests)
+        {
+            BMCWEB_LOG_DEBUG("{} {} requests outstanding, pausing reads",
+                             logPtr(this), outstanding);
+            return;
+        }
+        res.clear();
+        userSession = nullptr;
+        initParser();
+        doReadHeaders();
+    }
+
+    // The client has stopped sending.  Responses to requests that were
+    // already read are still written before the socket is closed.
+    void closeAfterPendingResponses()
+    {
+        readInProgress = false;
+        peerClosed = true;
+        if (!writing && pendingResponses.empty())
+        {
+            hardClose();
+            return;
+        }
+        if (writing)
+        {
+            startDeadline(DeadlineTimerType::Default);
+        }
     }
 
     void hardClose()
@@ -503,19 +629,55 @@ class Connection :
         }
     }
 
-    void completeRequest(Response& thisRes)
+    void completeRequest(uint64_t responseId, Response& thisRes)
     {
-        res = std::move(thisRes);
-        res.keepAlive(keepAlive);
-
-        completeResponseFields(accept, acceptEncoding, res);
-        res.addHeader(boost::beast::http::field::date, getCachedDateStr());
+        auto pending = std::ranges::find(pendingResponses, responseId,
+                                         &PendingResponse::id);
+        if (pending == pendingResponses.end())
+        {
+            BMCWEB_LOG_ERROR("{} Response {} is no longer pending",
+                             logPtr(this), responseId);
+            return;
+        }
+        Response& out = pending->res;
+        out = std::move(thisRes);
+        out.keepAlive(pending->keepAlive);
 
-        doWrite();
+        completeResponseFields(pending->accept, pending->acceptEncoding, out);
+        out.addHeader(boost::beast::http::field::date, getCachedDateStr());
 
         // delete lambda with self shared_ptr
         // to enable connection destruction
-        res.setCompleteRequestHandler(nullptr);
+        out.setCompleteRequestHandler(nullptr);
+        pending->ready = true;
+
+        writeNextResponse();
+    }
+
+    // Queues res, which was produced before the request reached a handler
+    void queueResponse(bool keepAliveIn)
+    {
+        PendingResponse& pending = pendingResponses.emplace_back();
+        pending.id = nextResponseId++;
+        pending.keepAlive = keepAliveIn;
+        pending.res = std::move(res);
+        pending.ready = true;
+        res.clear();
+
+        writeNextResponse();
+    }
+
+    // Responses are written in the order their requests were read
+    void writeNextResponse()
+    {
+        if (writing || pendingResponses.empty() ||
+            !pendingResponses.front().ready)
+        {
+            return;
+        }
+        current = std::move(pendingResponses.front());
+        pendingResponses.pop_front();
+        doWrite();
     }
 
     void readClientIp()
@@ -599,8 +761,8 @@ class Connection :
                 res.result(boost::beast::http::status::payload_too_large);
             }
 
-            keepAlive = false;
-            doWrite();
+            readInProgress = false;
+            queueResponse(false);
             return false;
         }
 
@@ -625,13 +787,13 @@ class Connection :
 
                 res.result(boost::beast::http::status::
                                request_header_fields_too_large);
-                keepAlive = false;
-                doWrite();
+                readInProgress = false;
+                queueResponse(false);
                 return;
             }
             BMCWEB_LOG_WARNING("{} End of stream, closing {}", logPtr(this),
                                ec);
-            hardClose();
+            closeAfterPendingResponses();
             return;
         }
 
@@ -640,15 +802,48 @@ class Connection :
             BMCWEB_LOG_ERROR("Parser was unexpectedly null");
             return;
         }
-        auto& parse = *parser;
-        const auto& value = parser->get();
 
         if (authenticationEnabled)
         {
+            const auto& value = parser->get();
             boost::beast::http::verb method = value.method();
-            userSession = authentication::authenticate(
-                ip, res, method, value.base(), mtlsSession);
+            // Basic auth runs PAM off of the io_context, so this may complete
+            // asynchronously
+            authentication::authenticate(
+                ip, res, method, value.base(), mtlsSession,
+                std::bind_front(&self_type::afterAuthenticate, this,
+                                shared_from_this()));
+            return;
+        }
+
+        afterHeadersAuthenticated();
+    }
+
+    void afterAuthenticate(
+        const std::shared_ptr<self_type>& /*self*/,
+        const std::shared_ptr<persistent_data::UserSession>& session)
+    {
+        userSession = session;
+        if (res.result() == boost::beast::http::status::service_unavailable)
+        {
+            // Too busy to check the credentials; answer without reading the
+            // body
+            readInProgress = false;
+            queueResponse(false);
+            return;
         }
+        afterHeadersAuthenticated();
+    }
+
+    void afterHeadersAuthenticated()
+    {
+        if (!parser)
+        {
+            BMCWEB_LOG_ERROR("Parser was unexpectedly null");
+            return;
+        }
+        auto& parse = *parser;
+        const auto& value = parser->get();
 
         if (!handleContentLengthError())
         {
@@ -661,13 +856,13 @@ class Connection :
         if (bmcweb::asciiIEquals(expect, "100-continue"))
         {
             res.result(boost::beast::http::status::continue_);
-            doWrite();
+            queueResponse(true);
             return;
         }
 
         if (parse.is_done())
         {
-            handle();
+            handleRequest();
             return;
         }
 
@@ -678,7 +873,9 @@ class Connection :
     {
         BMCWEB_LOG_DEBUG("{} doReadHeaders", logPtr(this));
 
-        startDeadline(DeadlineTimerType::Keepalive);
+        readInProgress = true;
+        readDeadline = DeadlineTimerType::Keepalive;
+        startDeadline(readDeadline);
 
         if (!parser)
         {
@@ -722,14 +919,14 @@ class Connection :
                                         "available?  Should never happen");
                     res.result(
                         boost::beast::http::status::internal_server_error);
-                    keepAlive = false;
-                    doWrite();
+                    readInProgress = false;
+                    queueResponse(false);
                 }
                 return;
             }
             BMCWEB_LOG_WARNING("{} End of stream, closing {}", logPtr(this),
                                ec);
-            hardClose();
+            closeAfterPendingResponses();
 
             return;
         }
@@ -737,8 +934,9 @@ class Connection :
         // If the user is logged in, allow them to send files
         // incrementally one piece at a time. If authentication is
         // disabled then there is no user session hence always allow to
-        // send one piece at a time.
-        if (userSession != nullptr)
+        // send one piece at a time.  A response being written keeps its
+        // own deadline.
+        if (userSession != nullptr && !writing)
         {
             cancelDeadlineTimer();
         }
@@ -754,8 +952,11 @@ class Connection :
             return;
         }
 
-        cancelDeadlineTimer();
-        handle();
+        if (!writing)
+        {
+            cancelDeadlineTimer();
+        }
+        handleRequest();
     }
 
     void doRead()
@@ -766,7 +967,8 @@ class Connection :
             return;
         }
         auto& parse = *parser;
-        startDeadline(DeadlineTimerType::Default);
+        readDeadline = DeadlineTimerType::Default;
+        startDeadline(readDeadline);
         if (httpType == HttpType::HTTP)
         {
             boost::beast::http::async_read_some(
@@ -790,6 +992,7 @@ class Connection :
         BMCWEB_LOG_DEBUG("{} async_write wrote {} bytes, ec={}", logPtr(this),
                          bytesTransferred, ec);
 
+        writing = false;
         cancelDeadlineTimer();
 
         if (ec == boost::system::errc::operation_would_block ||
@@ -814,21 +1017,21 @@ class Connection :
             return;
         }
 
-        if (res.result() == boost::beast::http::status::switching_protocols)
+        if (current.res.result() ==
+            boost::beast::http::status::switching_protocols)
         {
             upgradeToHttp2();
             return;
         }
 
-        if (res.result() == boost::beast::http::status::continue_)
+        if (current.res.result() == boost::beast::http::status::continue_)
         {
-            // Reset the result to ok
-            res.result(boost::beast::http::status::ok);
+            current.res.clear();
             doRead();
             return;
         }
 
-        if (!keepAlive)
+        if (!current.keepAlive)
         {
             BMCWEB_LOG_DEBUG("{} keepalive not set.  Closing socket",
                              logPtr(this));
@@ -838,32 +1041,70 @@ class Connection :
         }
 
         BMCWEB_LOG_DEBUG("{} Clearing response", logPtr(this));
-        res.clear();
-        initParser();
-
-        userSession = nullptr;
+        current.res.clear();
+        if (current.req != nullptr)
+        {
+            current.req->clear();
+            current.req = nullptr;
+        }
 
-        req->clear();
-        doReadHeaders();
+        if (readInProgress)
+        {
+            // The deadline for the read ahead was replaced by the write's.
+            // A read that got as far as the body keeps the short deadline,
+            // so a client can't trickle a body in under the keepalive one.
+            startDeadline(readDeadline);
+        }
+        writeNextResponse();
+        if (!writing && pendingResponses.empty())
+        {
+            if (peerClosed)
+            {
+                hardClose();
+                return;
+            }
+            if (handleWhenIdle)
+            {
+                handleWhenIdle = false;
+                handle();
+                return;
+            }
+        }
+        readNextRequest();
     }
 
     void doWrite()
     {
         BMCWEB_LOG_DEBUG("{} doWrite", logPtr(this));
 
+        writing = true;
         boost::urls::url_view urlView;
-        if (req != nullptr)
+        if (current.req != nullptr)
         {
-            urlView = req->url();
+            urlView = current.req->url();
         }
-        res.preparePayload(urlView);
+        current.res.preparePayload(urlView);
 
+        if (readInProgress)
+        {
+            // Don't let the write inherit the long deadline of a read ahead
+            cancelDeadlineTimer();
+        }
         startDeadline(DeadlineTimerType::Default);
+        if constexpr (std::is_same_v<Adaptor, boost::asio::ip::tcp::socket>)
+        {
+            if (httpType == HttpType::HTTP && canSendFile())
+            {
+                doWriteWithSendfile();
+                return;
+            }
+        }
         if (httpType == HttpType::HTTP)
         {
             boost::beast::async_write(
                 adaptor.next_layer(),
-                boost::beast::http::message_generator(std::move(res.response)),
+                boost::beast::http::message_generator(
+                    std::move(current.res.response)),
                 std::bind_front(&self_type::afterDoWrite, this,
                                 shared_from_this()));
         }
@@ -871,12 +1112,115 @@ class Connection :
         {
             boost::beast::async_write(
                 adaptor,
-                boost::beast::http::message_generator(std::move(res.response)),
+                boost::beast::http::message_generator(
+                    std::move(current.res.response)),
                 std::bind_front(&self_type::afterDoWrite, this,
                                 shared_from_this()));
         }
     }
 
+    // Files sent as-is over a plain socket can go straight from the page
+    // cache to the socket, rather than being copied through userspace.  TLS
+    // connections can't do this; the asio ssl stream encrypts in userspace
+    // through its own buffers, which kernel TLS can't be attached to.
+    bool canSendFile()
+    {
+        const bmcweb::HttpBody::value_type& body = current.res.response.body();
+        return body.file().is_open() && body.payloadSize() &&
+               body.encodingType == bmcweb::EncodingType::Raw &&
+               body.compressionType == body.clientCompressionType &&
+               !current.res.response.chunked();
+    }
+
+    void doWriteWithSendfile()
+    {
+        int fileFd = current.res.response.body().file().native_handle();
+        off_t offset = lseek(fileFd, 0, SEEK_CUR);
+        sendfileOffset = offset < 0 ? 0 : offset;
+        sendfileRemaining =
+            current.res.response.body().payloadSize().value_or(0);
+        // sendfile needs a non-blocking socket; put it back how it was
+        // afterwards
+        sendfileRestoreNonBlocking = adaptor.next_layer().native_non_blocking();
+        sendfileSerializer.emplace(current.res.response);
+        BMCWEB_LOG_DEBUG("{} Sending {} byte file with sendfile", logPtr(this),
+                         sendfileRemaining);
+        boost::beast::http::async_write_header(
+            adaptor.next_layer(), *sendfileSerializer,
+            std::bind_front(&self_type::afterSendfileWait, this,
+                            shared_from_this()));
+    }
+
+    void afterSendfileWait(const std::shared_ptr<self_type>& self,
+                           const boost::system::error_code& ec,
+                           std::size_t /*bytesTransferred*/ = 0)
+    {
+        if (ec)
+        {
+            finishSendfile(self, ec);
+            return;
+        }
+        boost::system::error_code nbEc;
+        adaptor.next_layer().native_non_blocking(true, nbEc);
+        if (nbEc)
+        {
+            finishSendfile(self, nbEc);
+            return;
+        }
+        int socketFd = adaptor.next_layer().native_handle();
+        int fileFd = current.res.response.body().file().native_handle();
+        while (sendfileRemaining > 0)
+        {
+            ssize_t sent =
+                sendfile(socketFd, fileFd, &sendfileOffset, sendfileRemaining);
+            if (sent < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+                if (errno == EAGAIN || errno == EWOULDBLOCK)
+                {
+                    adaptor.next_layer().async_wait(
+                        boost::asio::socket_base::wait_write,
+                        [this, self](const boost::system::error_code& waitEc) {
+                            afterSendfileWait(self, waitEc);
+                        });
+                    return;
+                }
+                finishSendfile(self,
+                               boost::system::error_code(
+                                   errno, boost::system::system_category()));
+                return;
+            }
+            if (sent == 0)
+            {
+                BMCWEB_LOG_ERROR("{} File ended {} bytes early", logPtr(this),
+                                 sendfileRemaining);
+                finishSendfile(self, boost::beast::http::error::end_of_stream);
+                return;
+            }
+            sendfileRemaining -= static_cast<size_t>(sent);
+        }
+        finishSendfile(self, {});
+    }
+
+    void finishSendfile(const std::shared_ptr<self_type>& self,
+                        const boost::system::error_code& ec)
+    {
+        sendfileSerializer.reset();
+        boost::system::error_code nbEc;
+        adaptor.next_layer().native_non_blocking(sendfileRestoreNonBlocking,
+                                                 nbEc);
+        if (nbEc)
+        {
+            BMCWEB_LOG_WARNING("{} Failed to restore socket mode {}",
+                               logPtr(this), nbEc);
+        }
+        size_t fileSize = current.res.response.body().payloadSize().value_or(0);
+        afterDoWrite(self, ec, fileSize - sendfileRemaining);
+    }
+
     void cancelDeadlineTimer()
     {
         timer.cancel();
@@ -965,22 +1309,58 @@ class Connection :
     boost::beast::flat_static_buffer<8192> buffer;
 
     std::shared_ptr<Request> req;
-    std::string accept;
     std::string http2settings;
-    std::string acceptEncoding;
 
+    // Response to the request being read, before it reaches a handler
     Response res;
 
+    // A request that has been read, and its response once complete
+    struct PendingResponse
+    {
+        uint64_t id = 0;
+        std::shared_ptr<Request> req;
+        std::string accept;
+        std::string acceptEncoding;
+        bool keepAlive = true;
+        // GET or HEAD, or a response queued before reaching a handler
+        bool safe = true;
+        bool ready = false;
+        Response res;
+    };
+
+    // Requests read ahead of the response being written, in request order
+    std::deque<PendingResponse> pendingResponses;
+    uint64_t nextResponseId = 0;
+
+    // The response being written
+    PendingResponse current;
+    bool writing = false;
+
+    bool readInProgress = false;
+    // The deadline for the phase readInProgress is in; headers of the next
+    // request may take as long as keepalive allows, a body may not
+    DeadlineTimerType readDeadline = DeadlineTimerType::Keepalive;
+    // The client stopped sending; close once pending responses are written
+    bool peerClosed = false;
+    // An upgrade or unsafe request is waiting for pending responses to be
+    // written
+    bool handleWhenIdle = false;
+
+    // Writes the headers of a response whose body is sent with sendfile
+    std::optional<boost::beast::http::response_serializer<bmcweb::HttpBody>>
+        sendfileSerializer;
+    off_t sendfileOffset = 0;
+    size_t sendfileRemaining = 0;
+    bool sendfileRestoreNonBlocking = false;
+
     std::shared_ptr<persistent_data::UserSession> userSession;
     std::shared_ptr<persistent_data::UserSession> mtlsSession;
 
     boost::asio::steady_timer timer;
 
-    bool keepAlive = true;
-
     bool timerStarted = false;
 
-    std::function<std::string()>& getCachedDateStr;
+    std::function<std::string_view()>& getCachedDateStr;
 
     using std::enable_shared_from_this<
         Connection<Adaptor, Handler>>::shared_from_this;
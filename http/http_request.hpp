@@ -15,6 +15,7 @@
 #include <boost/url/url.hpp>
 #include <boost/url/url_view.hpp>
 
+#include <cstddef>
 #include <memory>
 #include <optional>
 #include <string>
@@ -22,6 +23,11 @@
 #include <system_error>
 #include <utility>
 
+namespace redfish::query_param
+{
+class ExpandEngine;
+} // namespace redfish::query_param
+
 namespace crow
 {
 
@@ -41,6 +47,17 @@ struct Request
     std::shared_ptr<persistent_data::UserSession> session;
 
     std::string userRole;
+
+    // Set on requests made on behalf of one that has already been authorized,
+    // whose session was populated with the user's privileges while doing so,
+    // so that they aren't fetched again
+    bool userInfoPopulated = false;
+
+    // Set on the sub-requests of an $expand, so that the references in their
+    // responses are expanded by the engine that made them
+    std::shared_ptr<redfish::query_param::ExpandEngine> expandEngine;
+    size_t expandIndex = 0;
+
     Request(Body&& reqIn, std::error_code& ec) : req(std::move(reqIn))
     {
         if (!setUrlInfo())
@@ -82,6 +99,9 @@ struct Request
         ipAddress = boost::asio::ip::address();
         session = nullptr;
         userRole = "";
+        userInfoPopulated = false;
+        expandEngine = nullptr;
+        expandIndex = 0;
     }
 
     boost::beast::http::verb method() const
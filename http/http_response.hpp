@@ -2,7 +2,9 @@
 // SPDX-FileCopyrightText: Copyright OpenBMC Authors
 #pragma once
 #include "http_body.hpp"
+#include "http_utility.hpp"
 #include "logging.hpp"
+#include "resource_generation.hpp"
 #include "utils/hex_utils.hpp"
 
 #include <fcntl.h>
@@ -21,10 +23,12 @@
 #include <filesystem>
 #include <functional>
 #include <iterator>
+#include <memory>
 #include <optional>
 #include <string>
 #include <string_view>
 #include <utility>
+#include <vector>
 
 namespace crow
 {
@@ -87,6 +91,9 @@ struct Response
         response(std::move(res.response)), jsonValue(std::move(res.jsonValue)),
         requestExpectedEtag(std::move(res.requestExpectedEtag)),
         currentOverrideEtag(std::move(res.currentOverrideEtag)),
+        generations(std::move(res.generations)),
+        conditionalGetKey(std::move(res.conditionalGetKey)),
+        generationsIgnored(res.generationsIgnored),
         completed(res.completed)
     {
         // See note in operator= move handler for why this is needed.
@@ -114,6 +121,9 @@ struct Response
         jsonValue = std::move(r.jsonValue);
         requestExpectedEtag = std::move(r.requestExpectedEtag);
         currentOverrideEtag = std::move(r.currentOverrideEtag);
+        generations = std::move(r.generations);
+        conditionalGetKey = std::move(r.conditionalGetKey);
+        generationsIgnored = r.generationsIgnored;
 
         // Only need to move completion handler if not already completed
         // Note, there are cases where we might move out of a Response object
@@ -242,6 +252,9 @@ struct Response
         completed = false;
         requestExpectedEtag = std::nullopt;
         currentOverrideEtag = std::nullopt;
+        generations.clear();
+        conditionalGetKey = std::nullopt;
+        generationsIgnored = false;
     }
 
     void setCurrentOverrideEtag(std::string_view newEtag)
@@ -267,13 +280,21 @@ struct Response
             return "";
         }
 
+        if (conditionalGetKey && !generations.empty())
+        {
+            return makeGenerationEtag(*conditionalGetKey, generations);
+        }
+
+        // The same json is sent compact or indented, or as CBOR or HTML,
+        // depending on Accept, so the tag is weak; it stands for the data
+        // rather than the bytes of any one of those.
         if (currentOverrideEtag)
         {
-            return currentOverrideEtag.value();
+            return "W/" + currentOverrideEtag.value();
         }
 
         size_t hashval = std::hash<nlohmann::json>{}(jsonValue);
-        return std::format("\"{:08X}\"", hashval);
+        return std::format("W/\"{:08X}\"", hashval);
     }
 
     void write(std::string&& bodyPart)
@@ -281,6 +302,15 @@ struct Response
         response.body().str() = std::move(bodyPart);
     }
 
+    // Sends contents that are shared with other responses, without copying
+    // them.  comp is the compression the contents are already in.
+    void write(std::shared_ptr<const std::string> bodyPart,
+               bmcweb::CompressionType comp = bmcweb::CompressionType::Raw)
+    {
+        response.body().setShared(std::move(bodyPart));
+        response.body().compressionType = comp;
+    }
+
     void end()
     {
         if (completed)
@@ -326,7 +356,13 @@ struct Response
         }
         std::string hexVal = getCurrentEtag();
         addHeader(http::field::etag, hexVal);
-        if (requestExpectedEtag && hexVal == *requestExpectedEtag)
+        if (conditionalGetKey && !generations.empty())
+        {
+            ConditionalGetCache::getInstance().insert(*conditionalGetKey,
+                                                      hexVal, generations);
+        }
+        if (requestExpectedEtag &&
+            http_helpers::ifNoneMatchMatches(*requestExpectedEtag, hexVal))
         {
             jsonValue = nullptr;
             result(http::status::not_modified);
@@ -348,6 +384,35 @@ struct Response
         requestExpectedEtag = etag;
     }
 
+    // Records that the response is built from source as it is now.  Only
+    // handlers whose response depends on nothing but their recorded
+    // generations may call this, as it lets later requests be answered
+    // without running them.
+    void addGeneration(const ResourceGeneration& source)
+    {
+        if (generationsIgnored)
+        {
+            return;
+        }
+        generations.emplace_back(&source, source.get());
+    }
+
+    // For responses that also hold data no generation covers, such as
+    // members added by aggregated satellites.  Generations recorded before or
+    // after are dropped, and the json is hashed as for any other response.
+    void ignoreGenerations()
+    {
+        generations.clear();
+        generationsIgnored = true;
+    }
+
+    // Set by the router for requests whose responses may be answered from
+    // the ConditionalGetCache
+    void setConditionalGetKey(std::string key)
+    {
+        conditionalGetKey = std::move(key);
+    }
+
     OpenCode openFile(
         const std::filesystem::path& path,
         bmcweb::EncodingType enc = bmcweb::EncodingType::Raw,
@@ -392,6 +457,9 @@ struct Response
   private:
     std::optional<std::string> requestExpectedEtag;
     std::optional<std::string> currentOverrideEtag;
+    std::vector<GenerationSnapshot> generations;
+    std::optional<std::string> conditionalGetKey;
+    bool generationsIgnored = false;
     bool completed = false;
     std::function<void(Response&)> completeRequestHandler;
 };
@@ -23,6 +23,7 @@
 #include <functional>
 #include <memory>
 #include <string>
+#include <string_view>
 #include <utility>
 #include <vector>
 
@@ -48,7 +49,9 @@ class Server
         signals(getIoContext(), SIGINT, SIGTERM, SIGHUP), handler(handlerIn)
     {}
 
-    std::string getCachedDateStrImpl()
+    // Responses copy the date into their headers; the view is only good
+    // until the next call
+    std::string_view getCachedDateStrImpl()
     {
         std::chrono::steady_clock::time_point now =
             std::chrono::steady_clock::now();
@@ -161,7 +164,7 @@ class Server
     }
 
   private:
-    std::function<std::string()> getCachedDateStr;
+    std::function<std::string_view()> getCachedDateStr;
     std::vector<Acceptor> acceptors;
     boost::asio::signal_set signals;
 
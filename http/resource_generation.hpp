@@ -0,0 +1,158 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+#pragma once
+
+#include <boost/container/flat_map.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <functional>
+#include <optional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace crow
+{
+
+// Counts the changes made to some data that responses are built from.
+// Whatever owns the data bumps it on every change, so a response that
+// records the generation of everything it was built from is known to be
+// current for as long as none of them have moved.  Such a response gets an
+// ETag made from those generations rather than from hashing its json, and a
+// GET that already has that ETag can be answered before its handler runs.
+// Generations must live as long as the process; they're kept by pointer.
+class ResourceGeneration
+{
+  public:
+    void bump()
+    {
+        value++;
+    }
+
+    uint64_t get() const
+    {
+        return value;
+    }
+
+  private:
+    uint64_t value = 0;
+};
+
+struct GenerationSnapshot
+{
+    const ResourceGeneration* source = nullptr;
+    uint64_t value = 0;
+
+    bool operator==(const GenerationSnapshot&) const = default;
+};
+
+inline bool isCurrent(const std::vector<GenerationSnapshot>& generations)
+{
+    return std::ranges::all_of(
+        generations, [](const GenerationSnapshot& generation) {
+            return generation.source->get() == generation.value;
+        });
+}
+
+// The weak ETag of the response for key built from generations.  Counters
+// start again from zero when bmcweb restarts, so a value picked at startup
+// is mixed in to keep ETags from an earlier run from matching.
+inline std::string makeGenerationEtag(
+    std::string_view key, const std::vector<GenerationSnapshot>& generations)
+{
+    static const uint64_t epoch = []() {
+        std::random_device rd;
+        return (static_cast<uint64_t>(rd()) << 32U) | rd();
+    }();
+    uint64_t hash = std::hash<std::string_view>{}(key);
+    auto combine = [&hash](uint64_t value) {
+        hash ^= std::hash<uint64_t>{}(value) + 0x9e3779b97f4a7c15ULL +
+                (hash << 6U) + (hash >> 2U);
+    };
+    combine(epoch);
+    for (const GenerationSnapshot& generation : generations)
+    {
+        combine(std::bit_cast<uintptr_t>(generation.source));
+        combine(generation.value);
+    }
+    return std::format("W/\"G{:016X}\"", hash);
+}
+
+// Remembers the ETag last sent for each GET whose response was built only
+// from generations, so that a request with If-None-Match can be answered
+// with 304 Not Modified without running the handler, as long as nothing it
+// was built from has changed since.
+class ConditionalGetCache
+{
+  public:
+    static constexpr size_t maxEntries = 256;
+
+    static ConditionalGetCache& getInstance()
+    {
+        static ConditionalGetCache cache;
+        return cache;
+    }
+
+    void insert(const std::string& key, const std::string& etag,
+                const std::vector<GenerationSnapshot>& generations)
+    {
+        if (entries.size() >= maxEntries && !entries.contains(key))
+        {
+            for (auto it = entries.begin(); it != entries.end();)
+            {
+                if (isCurrent(it->second.generations))
+                {
+                    it++;
+                    continue;
+                }
+                it = entries.erase(it);
+            }
+            if (entries.size() >= maxEntries)
+            {
+                entries.erase(entries.begin());
+            }
+        }
+        Entry& entry = entries[key];
+        entry.etag = etag;
+        entry.generations = generations;
+    }
+
+    // The ETag last sent for key, if nothing the response was built from
+    // has changed since
+    std::optional<std::string> findCurrentEtag(std::string_view key)
+    {
+        auto entry = entries.find(key);
+        if (entry == entries.end())
+        {
+            return std::nullopt;
+        }
+        if (!isCurrent(entry->second.generations))
+        {
+            entries.erase(entry);
+            return std::nullopt;
+        }
+        return entry->second.etag;
+    }
+
+    size_t size() const
+    {
+        return entries.size();
+    }
+
+  private:
+    struct Entry
+    {
+        std::string etag;
+        std::vector<GenerationSnapshot> generations;
+    };
+
+    boost::container::flat_map<std::string, Entry, std::less<>> entries;
+};
+
+} // namespace crow
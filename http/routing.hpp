@@ -6,18 +6,22 @@
 #include "dbus_privileges.hpp"
 #include "http_request.hpp"
 #include "http_response.hpp"
+#include "http_utility.hpp"
 #include "logging.hpp"
+#include "resource_generation.hpp"
 #include "routing/baserule.hpp"
 #include "routing/dynamicrule.hpp"
+#include "routing/routeparams.hpp"
 #include "routing/taggedrule.hpp"
 #include "routing/trie.hpp"
 #include "verb.hpp"
 
 #include <boost/beast/http/field.hpp>
 #include <boost/beast/http/status.hpp>
+#include <boost/beast/http/verb.hpp>
 
 #include <algorithm>
-#include <array>
+#include <cstddef>
 #include <cstdint>
 #include <cstdlib>
 #include <format>
@@ -27,7 +31,6 @@
 #include <stdexcept>
 #include <string>
 #include <string_view>
-#include <tuple>
 #include <utility>
 #include <vector>
 
@@ -127,19 +130,41 @@ class Router
         }
     };
 
+    // Rules for every verb, stored in a single trie whose nodes hold a rule
+    // index per verb, so that one lookup resolves both the matched rule and
+    // the Allow header.
+    struct AllMethods
+    {
+        std::vector<BaseRule*> rules;
+        Trie<crow::MethodNode> trie;
+        // rule index 0 has special meaning; preallocate it to avoid
+        // duplication.
+        AllMethods() : rules(1) {}
+
+        void internalAdd(std::string_view rule, BaseRule* ruleObject)
+        {
+            rules.emplace_back(ruleObject);
+            unsigned ruleIndex = static_cast<unsigned>(rules.size() - 1U);
+            trie.add(rule, ruleIndex, ruleObject->methodsBitfield);
+            // directory case:
+            //   request to `/about' url matches `/about/' rule
+            if (rule.size() > 2 && rule.back() == '/')
+            {
+                trie.add(rule.substr(0, rule.size() - 1), ruleIndex,
+                         ruleObject->methodsBitfield);
+            }
+        }
+    };
+
     void internalAddRuleObject(const std::string& rule, BaseRule* ruleObject)
     {
         if (ruleObject == nullptr)
         {
             return;
         }
-        for (size_t method = 0; method <= maxVerbIndex; method++)
+        if (ruleObject->methodsBitfield != 0U)
         {
-            size_t methodBit = 1 << method;
-            if ((ruleObject->methodsBitfield & methodBit) > 0U)
-            {
-                perMethods[method].internalAdd(rule, ruleObject);
-            }
+            allMethods.internalAdd(rule, ruleObject);
         }
 
         if (ruleObject->isNotFound)
@@ -173,16 +198,13 @@ class Router
                 internalAddRuleObject(rule->rule, rule.get());
             }
         }
-        for (PerMethod& perMethod : perMethods)
-        {
-            perMethod.trie.validate();
-        }
+        allMethods.trie.validate();
     }
 
     struct FindRoute
     {
         BaseRule* rule = nullptr;
-        std::vector<std::string> params;
+        RouteParams params;
     };
 
     struct FindRouteResponse
@@ -205,7 +227,7 @@ class Router
         if (found.ruleIndex != 0U)
         {
             route.rule = perMethod.rules[found.ruleIndex];
-            route.params = std::move(found.params);
+            route.params = found.params;
         }
         return route;
     }
@@ -214,16 +236,27 @@ class Router
     {
         FindRouteResponse findRoute;
 
-        // Check to see if this url exists at any verb
+        // Verbs we don't route on still need the Allow header populated, so
+        // use an out of range index rather than skipping the lookup.
+        size_t reqMethodIndex = maxVerbIndex + 1;
+        std::optional<HttpVerb> verb = httpVerbFromBoost(req.method());
+        if (verb)
+        {
+            reqMethodIndex = static_cast<size_t>(*verb);
+        }
+
+        Trie<crow::MethodNode>::MethodFindResult found =
+            allMethods.trie.findMethods(req.url().encoded_path(),
+                                        reqMethodIndex);
+        if (found.ruleIndex >= allMethods.rules.size())
+        {
+            throw std::runtime_error("Trie internal structure corrupted!");
+        }
+
         for (size_t perMethodIndex = 0; perMethodIndex <= maxVerbIndex;
              perMethodIndex++)
         {
-            // Make sure it's safe to deference the array at that index
-            static_assert(
-                maxVerbIndex < std::tuple_size_v<decltype(perMethods)>);
-            FindRoute route = findRouteByPerMethod(req.url().encoded_path(),
-                                                   perMethods[perMethodIndex]);
-            if (route.rule == nullptr)
+            if ((found.allowedMethods & (size_t{1} << perMethodIndex)) == 0U)
             {
                 continue;
             }
@@ -235,22 +268,10 @@ class Router
             findRoute.allowHeader += httpVerbToString(thisVerb);
         }
 
-        std::optional<HttpVerb> verb = httpVerbFromBoost(req.method());
-        if (!verb)
-        {
-            return findRoute;
-        }
-        size_t reqMethodIndex = static_cast<size_t>(*verb);
-        if (reqMethodIndex >= perMethods.size())
-        {
-            return findRoute;
-        }
-
-        FindRoute route = findRouteByPerMethod(req.url().encoded_path(),
-                                               perMethods[reqMethodIndex]);
-        if (route.rule != nullptr)
+        if (found.ruleIndex != 0U)
         {
-            findRoute.route = route;
+            findRoute.route.rule = allMethods.rules[found.ruleIndex];
+            findRoute.route.params = found.params;
         }
 
         return findRoute;
@@ -341,50 +362,106 @@ class Router
         }
 
         BaseRule& rule = *foundRoute.route.rule;
-        std::vector<std::string> params = std::move(foundRoute.route.params);
+        // Params view into req's url; req is kept alive by the lambda below.
+        RouteParams params = foundRoute.route.params;
 
         BMCWEB_LOG_DEBUG("Matched rule '{}' {} / {}", rule.rule,
                          req->methodString(), rule.getMethods());
 
+        std::optional<std::string> conditionalKey = conditionalGetKey(*req);
         if (req->session == nullptr)
         {
-            rule.handle(*req, asyncResp, params);
+            if (!answerFromConditionalGetCache(*req, asyncResp->res,
+                                               std::move(conditionalKey)))
+            {
+                rule.handle(*req, asyncResp, params);
+            }
             return;
         }
         validatePrivilege(
             req, asyncResp, rule,
-            [req, asyncResp, &rule, params = std::move(params)]() {
+            [req, asyncResp, &rule, params = std::move(params),
+             conditionalKey = std::move(conditionalKey)]() mutable {
+                if (answerFromConditionalGetCache(*req, asyncResp->res,
+                                                  std::move(conditionalKey)))
+                {
+                    return;
+                }
                 rule.handle(*req, asyncResp, params);
             });
     }
 
     void debugPrint()
     {
-        for (size_t i = 0; i < perMethods.size(); i++)
-        {
-            BMCWEB_LOG_DEBUG("{}", httpVerbToString(static_cast<HttpVerb>(i)));
-            perMethods[i].trie.debugPrint();
-        }
+        allMethods.trie.debugPrint();
     }
 
     std::vector<const std::string*> getRoutes(const std::string& parent)
     {
         std::vector<const std::string*> ret;
 
-        for (const PerMethod& pm : perMethods)
+        std::vector<unsigned> x;
+        allMethods.trie.findRouteIndexes(parent, x);
+        for (unsigned index : x)
         {
-            std::vector<unsigned> x;
-            pm.trie.findRouteIndexes(parent, x);
-            for (unsigned index : x)
-            {
-                ret.push_back(&pm.rules[index]->rule);
-            }
+            ret.push_back(&allMethods.rules[index]->rule);
         }
         return ret;
     }
 
   private:
-    std::array<PerMethod, static_cast<size_t>(HttpVerb::Max)> perMethods;
+    // Only GETs without query parameters are answered from the
+    // ConditionalGetCache; parameters like $expand build the response from
+    // more than the handler records.  Responses can differ by user, so the
+    // user is part of the key.
+    static std::optional<std::string> conditionalGetKey(const Request& req)
+    {
+        if (req.method() != boost::beast::http::verb::get ||
+            req.url().has_query())
+        {
+            return std::nullopt;
+        }
+        std::string key;
+        if (req.session != nullptr)
+        {
+            key = req.session->username;
+        }
+        key += ' ';
+        key += req.url().encoded_path();
+        return key;
+    }
+
+    // Answers a GET whose If-None-Match still matches the response it would
+    // get with 304 Not Modified.  Otherwise lets the response be recorded
+    // for next time, and returns false so the handler runs.
+    static bool answerFromConditionalGetCache(const Request& req,
+                                              Response& res,
+                                              std::optional<std::string> key)
+    {
+        if (!key)
+        {
+            return false;
+        }
+        std::string_view ifNoneMatch =
+            req.getHeaderValue(boost::beast::http::field::if_none_match);
+        if (!ifNoneMatch.empty())
+        {
+            std::optional<std::string> etag =
+                ConditionalGetCache::getInstance().findCurrentEtag(*key);
+            if (etag && http_helpers::ifNoneMatchMatches(ifNoneMatch, *etag))
+            {
+                BMCWEB_LOG_DEBUG("{} is unchanged since ETag {}", *key, *etag);
+                res.addHeader(boost::beast::http::field::etag, *etag);
+                res.addHeader(boost::beast::http::field::vary, "Accept");
+                res.result(boost::beast::http::status::not_modified);
+                return true;
+            }
+        }
+        res.setConditionalGetKey(std::move(*key));
+        return false;
+    }
+
+    AllMethods allMethods;
 
     PerMethod notFoundRoutes;
     PerMethod upgradeRoutes;
@@ -5,6 +5,7 @@
 #include "async_resp.hpp"
 #include "http_request.hpp"
 #include "privileges.hpp"
+#include "routeparams.hpp"
 #include "verb.hpp"
 
 #include <boost/asio/ip/tcp.hpp>
@@ -45,7 +46,7 @@ class BaseRule
 
     virtual void handle(Request& /*req*/,
                         const std::shared_ptr<bmcweb::AsyncResp>&,
-                        const std::vector<std::string>&) = 0;
+                        const RouteParams&) = 0;
     virtual void handleUpgrade(
         const Request& /*req*/,
         const std::shared_ptr<bmcweb::AsyncResp>& asyncResp,
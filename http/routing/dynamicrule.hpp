@@ -5,16 +5,19 @@
 #include "async_resp.hpp"
 #include "baserule.hpp"
 #include "http_request.hpp"
+#include "routeparams.hpp"
 #include "ruleparametertraits.hpp"
 
 #include <boost/callable_traits/args.hpp>
 
+#include <cstddef>
 #include <functional>
 #include <memory>
 #include <stdexcept>
 #include <string>
+#include <string_view>
 #include <tuple>
-#include <vector>
+#include <type_traits>
 
 namespace crow
 {
@@ -32,9 +35,20 @@ struct Wrapped<Func, std::tuple<ArgsWrapped...>>
 
     std::function<void(ArgsWrapped...)> handler;
 
+    // Converts a url parameter to the type the handler accepts.  Handlers that
+    // take std::string_view get a view into the url with no copy; handlers
+    // that take std::string get their own copy.
+    template <size_t Index>
+    static auto param(std::string_view value)
+    {
+        using ParamType = std::remove_cvref_t<
+            std::tuple_element_t<Index, std::tuple<ArgsWrapped...>>>;
+        return ParamType(value);
+    }
+
     void operator()(Request& req,
                     const std::shared_ptr<bmcweb::AsyncResp>& asyncResp,
-                    const std::vector<std::string>& params)
+                    const RouteParams& params)
     {
         if constexpr (sizeof...(ArgsWrapped) == 2)
         {
@@ -42,24 +56,27 @@ struct Wrapped<Func, std::tuple<ArgsWrapped...>>
         }
         else if constexpr (sizeof...(ArgsWrapped) == 3)
         {
-            handler(req, asyncResp, params[0]);
+            handler(req, asyncResp, param<2>(params[0]));
         }
         else if constexpr (sizeof...(ArgsWrapped) == 4)
         {
-            handler(req, asyncResp, params[0], params[1]);
+            handler(req, asyncResp, param<2>(params[0]), param<3>(params[1]));
         }
         else if constexpr (sizeof...(ArgsWrapped) == 5)
         {
-            handler(req, asyncResp, params[0], params[1], params[2]);
+            handler(req, asyncResp, param<2>(params[0]), param<3>(params[1]),
+                    param<4>(params[2]));
         }
         else if constexpr (sizeof...(ArgsWrapped) == 6)
         {
-            handler(req, asyncResp, params[0], params[1], params[2], params[3]);
+            handler(req, asyncResp, param<2>(params[0]), param<3>(params[1]),
+                    param<4>(params[2]), param<5>(params[3]));
         }
         else if constexpr (sizeof...(ArgsWrapped) == 7)
         {
-            handler(req, asyncResp, params[0], params[1], params[2], params[3],
-                    params[4]);
+            handler(req, asyncResp, param<2>(params[0]), param<3>(params[1]),
+                    param<4>(params[2]), param<5>(params[3]),
+                    param<6>(params[4]));
         }
     }
 };
@@ -80,7 +97,7 @@ class DynamicRule : public BaseRule, public RuleParameterTraits<DynamicRule>
 
     void handle(Request& req,
                 const std::shared_ptr<bmcweb::AsyncResp>& asyncResp,
-                const std::vector<std::string>& params) override
+                const RouteParams& params) override
     {
         erasedHandler(req, asyncResp, params);
     }
@@ -94,7 +111,7 @@ class DynamicRule : public BaseRule, public RuleParameterTraits<DynamicRule>
 
   private:
     std::function<void(Request&, const std::shared_ptr<bmcweb::AsyncResp>&,
-                       const std::vector<std::string>&)>
+                       const RouteParams&)>
         erasedHandler;
 };
 
@@ -0,0 +1,22 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+#pragma once
+
+#include <boost/container/static_vector.hpp>
+
+#include <cstddef>
+#include <string_view>
+
+namespace crow
+{
+
+// TaggedRule and DynamicRule support at most this many url parameters
+constexpr size_t maxRouteParams = 5;
+
+// Parameters captured from the url while routing.  Entries are views into the
+// url of the Request being routed, so they are only valid while that Request
+// is alive and its url is unmodified.
+using RouteParams =
+    boost::container::static_vector<std::string_view, maxRouteParams>;
+
+} // namespace crow
@@ -8,6 +8,7 @@
 #include "http_request.hpp"
 #include "http_response.hpp"
 #include "logging.hpp"
+#include "routeparams.hpp"
 #include "server_sent_event_impl.hpp"
 
 #include <boost/asio/ip/tcp.hpp>
@@ -17,7 +18,6 @@
 #include <memory>
 #include <string>
 #include <utility>
-#include <vector>
 
 namespace crow
 {
@@ -33,7 +33,7 @@ void SseSocketRule::validate() {}
 
 void SseSocketRule::handle(Request& /*req*/,
                            const std::shared_ptr<bmcweb::AsyncResp>& asyncResp,
-                           const std::vector<std::string>& /*params*/)
+                           const RouteParams& /*params*/)
 {
     BMCWEB_LOG_ERROR(
         "Handle called on websocket rule.  This should never happen");
@@ -5,6 +5,7 @@
 #include "async_resp.hpp"
 #include "baserule.hpp"
 #include "http_request.hpp"
+#include "routeparams.hpp"
 #include "server_sent_event.hpp"
 
 #include <boost/asio/ip/tcp.hpp>
@@ -13,7 +14,6 @@
 #include <functional>
 #include <memory>
 #include <string>
-#include <vector>
 
 namespace crow
 {
@@ -29,7 +29,7 @@ class SseSocketRule : public BaseRule
 
     void handle(Request& /*req*/,
                 const std::shared_ptr<bmcweb::AsyncResp>& asyncResp,
-                const std::vector<std::string>& /*params*/) override;
+                const RouteParams& /*params*/) override;
 
     void handleUpgrade(const Request& req,
                        const std::shared_ptr<bmcweb::AsyncResp>& /*asyncResp*/,
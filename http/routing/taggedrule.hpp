@@ -4,6 +4,7 @@
 #include "async_resp.hpp"
 #include "baserule.hpp"
 #include "http_request.hpp"
+#include "routeparams.hpp"
 #include "ruleparametertraits.hpp"
 
 #include <functional>
@@ -11,7 +12,6 @@
 #include <stdexcept>
 #include <string>
 #include <type_traits>
-#include <vector>
 
 namespace crow
 {
@@ -52,32 +52,39 @@ class TaggedRule :
 
     void handle(Request& req,
                 const std::shared_ptr<bmcweb::AsyncResp>& asyncResp,
-                const std::vector<std::string>& params) override
+                const RouteParams& params) override
     {
+        // Handlers own their parameters, so the views into the url are only
+        // copied into strings here, once a handler has actually been chosen.
         if constexpr (sizeof...(Args) == 0)
         {
             handler(req, asyncResp);
         }
         else if constexpr (sizeof...(Args) == 1)
         {
-            handler(req, asyncResp, params[0]);
+            handler(req, asyncResp, std::string(params[0]));
         }
         else if constexpr (sizeof...(Args) == 2)
         {
-            handler(req, asyncResp, params[0], params[1]);
+            handler(req, asyncResp, std::string(params[0]),
+                    std::string(params[1]));
         }
         else if constexpr (sizeof...(Args) == 3)
         {
-            handler(req, asyncResp, params[0], params[1], params[2]);
+            handler(req, asyncResp, std::string(params[0]),
+                    std::string(params[1]), std::string(params[2]));
         }
         else if constexpr (sizeof...(Args) == 4)
         {
-            handler(req, asyncResp, params[0], params[1], params[2], params[3]);
+            handler(req, asyncResp, std::string(params[0]),
+                    std::string(params[1]), std::string(params[2]),
+                    std::string(params[3]));
         }
         else if constexpr (sizeof...(Args) == 5)
         {
-            handler(req, asyncResp, params[0], params[1], params[2], params[3],
-                    params[4]);
+            handler(req, asyncResp, std::string(params[0]),
+                    std::string(params[1]), std::string(params[2]),
+                    std::string(params[3]), std::string(params[4]));
         }
         static_assert(sizeof...(Args) <= 5, "More args than are supported");
     }
@@ -4,13 +4,18 @@
 #pragma once
 
 #include "logging.hpp"
+#include "routeparams.hpp"
+#include "verb.hpp"
 
 #include <boost/container/flat_map.hpp>
 #include <boost/container/small_vector.hpp>
 
+#include <algorithm>
+#include <array>
 #include <cstddef>
 #include <format>
 #include <functional>
+#include <optional>
 #include <stdexcept>
 #include <string>
 #include <string_view>
@@ -32,11 +37,61 @@ struct Node
         boost::container::small_vector<std::pair<std::string, unsigned>, 1>>;
     ChildMap children;
 
+    bool hasRule() const
+    {
+        return ruleIndex != 0U;
+    }
+
+    void getRuleIndexes(std::vector<unsigned>& routeIndexes) const
+    {
+        routeIndexes.push_back(ruleIndex);
+    }
+
+    bool isSimpleNode() const
+    {
+        return !hasRule() && stringParamChild == 0 && pathParamChild == 0;
+    }
+};
+
+// A node that can terminate a different rule for every HttpVerb.  This allows
+// a single trie to hold the rules for all verbs, so that one traversal can
+// resolve both the rule for the requested verb, and the set of verbs that are
+// allowed for the url.
+struct MethodNode
+{
+    // Index into the rule table for each HttpVerb.  0 means no rule.
+    std::array<unsigned, static_cast<size_t>(HttpVerb::Max)> ruleIndexes{};
+
+    size_t stringParamChild = 0U;
+    size_t pathParamChild = 0U;
+
+    using ChildMap = Node::ChildMap;
+    ChildMap children;
+
+    bool hasRule() const
+    {
+        return std::ranges::any_of(ruleIndexes,
+                                   [](unsigned index) { return index != 0U; });
+    }
+
+    void getRuleIndexes(std::vector<unsigned>& routeIndexes) const
+    {
+        for (unsigned index : ruleIndexes)
+        {
+            if (index != 0U && std::ranges::find(routeIndexes, index) ==
+                                   routeIndexes.end())
+            {
+                routeIndexes.push_back(index);
+            }
+        }
+    }
+
     bool isSimpleNode() const
     {
-        return ruleIndex == 0 && stringParamChild == 0 && pathParamChild == 0;
+        return !hasRule() && stringParamChild == 0 && pathParamChild == 0;
     }
 };
+
 template <typename ContainedType>
 class Trie
 {
@@ -117,9 +172,9 @@ class Trie
             const ContainedType& child = nodes[kv.second];
             if (reqUrl.empty())
             {
-                if (child.ruleIndex != 0 && fragment != "/")
+                if (child.hasRule() && fragment != "/")
                 {
-                    routeIndexes.push_back(child.ruleIndex);
+                    child.getRuleIndexes(routeIndexes);
                 }
                 findRouteIndexesHelper(reqUrl, routeIndexes, child);
             }
@@ -143,13 +198,13 @@ class Trie
     struct FindResult
     {
         unsigned ruleIndex = 0;
-        std::vector<std::string> params;
+        RouteParams params;
     };
 
   private:
     FindResult findHelper(const std::string_view reqUrl,
                           const ContainedType& node,
-                          std::vector<std::string>& params) const
+                          RouteParams& params) const
     {
         if (reqUrl.empty())
         {
@@ -167,7 +222,8 @@ class Trie
                 }
             }
 
-            if (epos != 0)
+            // Rules can't accept more params than fit, so don't descend
+            if (epos != 0 && params.size() < params.capacity())
             {
                 params.emplace_back(reqUrl.substr(0, epos));
                 FindResult ret = findHelper(
@@ -180,7 +236,7 @@ class Trie
             }
         }
 
-        if (node.pathParamChild != 0U)
+        if (node.pathParamChild != 0U && params.size() < params.capacity())
         {
             params.emplace_back(reqUrl);
             FindResult ret = findHelper("", nodes[node.pathParamChild], params);
@@ -208,17 +264,112 @@ class Trie
             }
         }
 
-        return {0U, std::vector<std::string>()};
+        return {0U, RouteParams()};
     }
 
   public:
     FindResult find(const std::string_view reqUrl) const
     {
-        std::vector<std::string> start;
+        RouteParams start;
         return findHelper(reqUrl, head(), start);
     }
 
-    void add(std::string_view urlIn, unsigned ruleIndex)
+    struct MethodFindResult
+    {
+        // Rule matched for the requested verb, 0 if none
+        unsigned ruleIndex = 0;
+        // Bitfield of all verbs that have a rule matching the url
+        size_t allowedMethods = 0;
+        RouteParams params;
+    };
+
+  private:
+    // Walks every branch that matches the url in the same precedence order as
+    // findHelper, collecting the allowed verbs from each terminal node, and
+    // keeping the first rule (and its params) that handles verbIndex.
+    void findMethodsHelper(std::string_view reqUrl, const ContainedType& node,
+                           size_t verbIndex, RouteParams& params,
+                           MethodFindResult& result) const
+    {
+        constexpr size_t allMethods =
+            (size_t{1} << static_cast<size_t>(HttpVerb::Max)) - 1U;
+        if (result.ruleIndex != 0U && result.allowedMethods == allMethods)
+        {
+            // Nothing left to learn from the remaining branches
+            return;
+        }
+
+        if (reqUrl.empty())
+        {
+            for (size_t i = 0; i < node.ruleIndexes.size(); i++)
+            {
+                if (node.ruleIndexes[i] != 0U)
+                {
+                    result.allowedMethods |= size_t{1} << i;
+                }
+            }
+            if (result.ruleIndex == 0U && verbIndex < node.ruleIndexes.size() &&
+                node.ruleIndexes[verbIndex] != 0U)
+            {
+                result.ruleIndex = node.ruleIndexes[verbIndex];
+                result.params = params;
+            }
+            return;
+        }
+
+        if (node.stringParamChild != 0U)
+        {
+            size_t epos = reqUrl.find('/');
+            if (epos == std::string_view::npos)
+            {
+                epos = reqUrl.size();
+            }
+
+            if (epos != 0 && params.size() < params.capacity())
+            {
+                params.emplace_back(reqUrl.substr(0, epos));
+                findMethodsHelper(reqUrl.substr(epos),
+                                  nodes[node.stringParamChild], verbIndex,
+                                  params, result);
+                params.pop_back();
+            }
+        }
+
+        if (node.pathParamChild != 0U && params.size() < params.capacity())
+        {
+            params.emplace_back(reqUrl);
+            findMethodsHelper("", nodes[node.pathParamChild], verbIndex, params,
+                              result);
+            params.pop_back();
+        }
+
+        for (const typename ContainedType::ChildMap::value_type& kv :
+             node.children)
+        {
+            const std::string& fragment = kv.first;
+            if (reqUrl.starts_with(fragment))
+            {
+                findMethodsHelper(reqUrl.substr(fragment.size()),
+                                  nodes[kv.second], verbIndex, params, result);
+            }
+        }
+    }
+
+  public:
+    // Finds the rule for verbIndex, as well as the verbs allowed on reqUrl, in
+    // a single traversal.  verbIndex may be out of range for verbs that have
+    // no rules, in which case only allowedMethods is populated.
+    MethodFindResult findMethods(std::string_view reqUrl,
+                                 size_t verbIndex) const
+    {
+        MethodFindResult result;
+        RouteParams params;
+        findMethodsHelper(reqUrl, head(), verbIndex, params, result);
+        return result;
+    }
+
+  private:
+    std::optional<size_t> addPath(std::string_view urlIn)
     {
         size_t idx = 0;
 
@@ -266,7 +417,7 @@ class Trie
                 }
 
                 BMCWEB_LOG_CRITICAL("Can't find tag for {}", urlIn);
-                return;
+                return std::nullopt;
             }
             std::string piece(&c, 1);
             if (!nodes[idx].children.contains(piece))
@@ -277,14 +428,48 @@ class Trie
             idx = nodes[idx].children[piece];
             url.remove_prefix(1);
         }
-        ContainedType& node = nodes[idx];
-        if (node.ruleIndex != 0U)
+        return idx;
+    }
+
+    static void setRuleIndex(unsigned& slot, std::string_view urlIn,
+                             unsigned ruleIndex)
+    {
+        if (slot != 0U)
         {
             BMCWEB_LOG_CRITICAL("handler already exists for \"{}\"", urlIn);
             throw std::runtime_error(
                 std::format("handler already exists for \"{}\"", urlIn));
         }
-        node.ruleIndex = ruleIndex;
+        slot = ruleIndex;
+    }
+
+  public:
+    void add(std::string_view urlIn, unsigned ruleIndex)
+    {
+        std::optional<size_t> idx = addPath(urlIn);
+        if (!idx)
+        {
+            return;
+        }
+        setRuleIndex(nodes[*idx].ruleIndex, urlIn, ruleIndex);
+    }
+
+    // Adds ruleIndex as the handler for every verb set in methodsBitfield
+    void add(std::string_view urlIn, unsigned ruleIndex, size_t methodsBitfield)
+    {
+        std::optional<size_t> idx = addPath(urlIn);
+        if (!idx)
+        {
+            return;
+        }
+        ContainedType& node = nodes[*idx];
+        for (size_t method = 0; method < node.ruleIndexes.size(); method++)
+        {
+            if ((methodsBitfield & (size_t{1} << method)) != 0U)
+            {
+                setRuleIndex(node.ruleIndexes[method], urlIn, ruleIndex);
+            }
+        }
     }
 
   private:
@@ -6,6 +6,7 @@
 #include "baserule.hpp"
 #include "http_request.hpp"
 #include "logging.hpp"
+#include "routeparams.hpp"
 #include "websocket.hpp"
 
 #include <boost/asio/ip/tcp.hpp>
@@ -16,7 +17,6 @@
 #include <memory>
 #include <string>
 #include <string_view>
-#include <vector>
 
 namespace crow
 {
@@ -36,7 +36,7 @@ class WebSocketRule : public BaseRule
 
     void handle(Request& /*req*/,
                 const std::shared_ptr<bmcweb::AsyncResp>& asyncResp,
-                const std::vector<std::string>& /*params*/) override
+                const RouteParams& /*params*/) override
     {
         BMCWEB_LOG_ERROR(
             "Handle called on websocket rule.  This should never happen");
@@ -20,7 +20,7 @@
 namespace bmcweb
 {
 
-bool ZstdCompressor::init([[maybe_unused]] size_t sourceSize)
+bool ZstdCompressor::init([[maybe_unused]] std::optional<size_t> sourceSize)
 {
 #ifdef HAVE_ZSTD
     if (cctx != nullptr)
@@ -59,7 +59,12 @@ bool ZstdCompressor::init([[maybe_unused]] size_t sourceSize)
         return false;
     }
 
-    ret = ZSTD_CCtx_setPledgedSrcSize(cctx, sourceSize);
+    if (!sourceSize)
+    {
+        // Streaming input; the frame won't record the content size
+        return true;
+    }
+    ret = ZSTD_CCtx_setPledgedSrcSize(cctx, *sourceSize);
     if (ZSTD_isError(ret) != 0U)
     {
         BMCWEB_LOG_ERROR("Failed to set pledged src size {}:{}", ret,
@@ -9,6 +9,8 @@
 
 #include <boost/beast/core/flat_buffer.hpp>
 
+#include <cstddef>
+#include <cstdint>
 #include <optional>
 #include <span>
 
@@ -30,8 +32,9 @@ class ZstdCompressor
 
     ZstdCompressor() = default;
 
-    // must be called before compress.
-    bool init(size_t sourceSize);
+    // must be called before compress.  sourceSize is the total size of the
+    // input, if known ahead of time.
+    bool init(std::optional<size_t> sourceSize);
     std::optional<std::span<const uint8_t>> compress(
         std::span<const uint8_t> buffIn, bool more);
     ~ZstdCompressor();
@@ -12,6 +12,7 @@
 #include "utility.hpp"
 #include "utils/ip_utils.hpp"
 #include "webroutes.hpp"
+#include "worker_pool.hpp"
 
 #include <security/_pam_types.h>
 
@@ -23,6 +24,7 @@
 
 #include <cstddef>
 #include <cstring>
+#include <functional>
 #include <memory>
 #include <optional>
 #include <string>
@@ -35,14 +37,58 @@ namespace crow
 namespace authentication
 {
 
-inline std::shared_ptr<persistent_data::UserSession> performBasicAuth(
-    const boost::asio::ip::address& clientIp, std::string_view authHeader)
+using AuthenticateCallback = std::move_only_function<void(
+    const std::shared_ptr<persistent_data::UserSession>&)>;
+
+inline std::shared_ptr<persistent_data::UserSession> getBasicAuthSession(
+    const boost::asio::ip::address& clientIp, const std::string& user,
+    int pamrc)
+{
+    bool isConfigureSelfOnly = pamrc == PAM_NEW_AUTHTOK_REQD;
+    if ((pamrc != PAM_SUCCESS) && !isConfigureSelfOnly)
+    {
+        return nullptr;
+    }
+
+    // Attempt to locate an existing Basic Auth session from the same ip address
+    // and user
+    for (auto& session :
+         persistent_data::SessionStore::getInstance().getSessions())
+    {
+        if (session->sessionType != persistent_data::SessionType::Basic)
+        {
+            continue;
+        }
+        if (session->clientIp != redfish::ip_util::toString(clientIp))
+        {
+            continue;
+        }
+        if (session->username != user)
+        {
+            continue;
+        }
+        return session;
+    }
+
+    return persistent_data::SessionStore::getInstance().generateUserSession(
+        user, clientIp, std::nullopt, persistent_data::SessionType::Basic,
+        isConfigureSelfOnly);
+}
+
+// PAM can take tens of milliseconds per attempt, so it is run on the worker
+// pool rather than the io_context thread.  If the pool already has too much
+// queued, res is set to 503 and callback is called with nullptr without
+// running PAM.  callback may be called before this returns.
+inline void performBasicAuth(const boost::asio::ip::address& clientIp,
+                             std::string_view authHeader, Response& res,
+                             AuthenticateCallback&& callback)
 {
     BMCWEB_LOG_DEBUG("[AuthMiddleware] Basic authentication");
 
     if (!authHeader.starts_with("Basic "))
     {
-        return nullptr;
+        callback(nullptr);
+        return;
     }
 
     std::string_view param = authHeader.substr(strlen("Basic "));
@@ -50,56 +96,52 @@ inline std::shared_ptr<persistent_data::UserSession> performBasicAuth(
 
     if (!crow::utility::base64Decode(param, authData))
     {
-        return nullptr;
+        callback(nullptr);
+        return;
     }
     std::size_t separator = authData.find(':');
     if (separator == std::string::npos)
     {
-        return nullptr;
+        callback(nullptr);
+        return;
     }
 
     std::string user = authData.substr(0, separator);
     separator += 1;
     if (separator > authData.size())
     {
-        return nullptr;
+        callback(nullptr);
+        return;
     }
     std::string pass = authData.substr(separator);
+    // NOLINTNEXTLINE(misc-include-cleaner)
+    explicit_bzero(authData.data(), authData.capacity());
 
     BMCWEB_LOG_DEBUG("[AuthMiddleware] Authenticating user: {}", user);
     BMCWEB_LOG_DEBUG("[AuthMiddleware] User IPAddress: {}",
                      clientIp.to_string());
 
-    int pamrc = pamAuthenticateUser(user, pass, std::nullopt);
-    bool isConfigureSelfOnly = pamrc == PAM_NEW_AUTHTOK_REQD;
-    if ((pamrc != PAM_SUCCESS) && !isConfigureSelfOnly)
+    if (bmcweb::getWorkerPool().isFull())
     {
-        return nullptr;
-    }
-
-    // Attempt to locate an existing Basic Auth session from the same ip address
-    // and user
-    for (auto& session :
-         persistent_data::SessionStore::getInstance().getSessions())
-    {
-        if (session->sessionType != persistent_data::SessionType::Basic)
-        {
-            continue;
-        }
-        if (session->clientIp != redfish::ip_util::toString(clientIp))
-        {
-            continue;
-        }
-        if (session->username != user)
-        {
-            continue;
-        }
-        return session;
+        BMCWEB_LOG_WARNING("[AuthMiddleware] Too many PAM checks queued");
+        // NOLINTNEXTLINE(misc-include-cleaner)
+        explicit_bzero(pass.data(), pass.capacity());
+        res.result(boost::beast::http::status::service_unavailable);
+        res.addHeader(boost::beast::http::field::retry_after, "1");
+        callback(nullptr);
+        return;
     }
 
-    return persistent_data::SessionStore::getInstance().generateUserSession(
-        user, clientIp, std::nullopt, persistent_data::SessionType::Basic,
-        isConfigureSelfOnly);
+    bmcweb::getWorkerPool().run(
+        [user, pass = std::move(pass)]() mutable {
+            int pamrc = pamAuthenticateUser(user, pass, std::nullopt);
+            // NOLINTNEXTLINE(misc-include-cleaner)
+            explicit_bzero(pass.data(), pass.capacity());
+            return pamrc;
+        },
+        [clientIp, user, callback = std::move(callback)](int pamrc) mutable {
+            callback(getBasicAuthSession(clientIp, user, pamrc));
+        });
 }
 
 inline std::shared_ptr<persistent_data::UserSession> performTokenAuth(
@@ -252,13 +294,18 @@ inline bool isOnAllowlist(std::string_view url, boost::beast::http::verb method)
     return false;
 }
 
-inline std::shared_ptr<persistent_data::UserSession> authenticate(
+// Calls callback with the authenticated session, or nullptr.  Basic auth
+// completes asynchronously; every other method calls callback before
+// returning.  If Basic auth can't be attempted because the server is busy,
+// res is set to 503 before callback is called.
+inline void authenticate(
     const boost::asio::ip::address& ipAddress [[maybe_unused]],
     Response& res [[maybe_unused]],
     boost::beast::http::verb method [[maybe_unused]],
     const boost::beast::http::header<true>& reqHeader,
     [[maybe_unused]] const std::shared_ptr<persistent_data::UserSession>&
-        session)
+        session,
+    AuthenticateCallback&& callback)
 {
     const persistent_data::AuthConfigMethods& authMethodsConfig =
         persistent_data::SessionStore::getInstance().getAuthMethodsConfig();
@@ -298,15 +345,11 @@ inline std::shared_ptr<persistent_data::UserSession> authenticate(
     {
         if (sessionOut == nullptr && authMethodsConfig.basic)
         {
-            sessionOut = performBasicAuth(ipAddress, authHeader);
+            performBasicAuth(ipAddress, authHeader, res, std::move(callback));
+            return;
         }
     }
-    if (sessionOut != nullptr)
-    {
-        return sessionOut;
-    }
-
-    return nullptr;
+    callback(sessionOut);
 }
 
 } // namespace authentication
@@ -7,16 +7,20 @@
 #include "error_messages.hpp"
 #include "http_request.hpp"
 #include "http_response.hpp"
+#include "io_context_singleton.hpp"
 #include "logging.hpp"
 #include "privileges.hpp"
 #include "routing/baserule.hpp"
 #include "sessions.hpp"
+#include "user_info_cache.hpp"
 #include "utils/dbus_utils.hpp"
 
+#include <boost/asio/post.hpp>
 #include <boost/beast/http/status.hpp>
 #include <boost/url/format.hpp>
 #include <sdbusplus/unpack_properties.hpp>
 
+#include <cstdint>
 #include <functional>
 #include <memory>
 #include <optional>
@@ -166,24 +170,74 @@ inline void handleRequestUserInfo(
     callback(userInfoMap);
 }
 
-inline void requestUserInfo(
-    const std::string& username,
-    const std::shared_ptr<bmcweb::AsyncResp>& asyncResp,
-    std::move_only_function<void(const dbus::utility::DBusPropertiesMap&)>&&
-        callback)
+using UserInfoCallback = std::move_only_function<void(
+    const boost::system::error_code&, const dbus::utility::DBusPropertiesMap&)>;
+
+// Retrieves user info for a username.  Tests substitute their own in place of
+// the user manager.
+using UserInfoFetcher =
+    std::function<void(const std::string&, UserInfoCallback&&)>;
+
+inline void getUserInfoFromUserManager(const std::string& username,
+                                       UserInfoCallback&& callback)
 {
     dbus::utility::async_method_call(
-        asyncResp,
-        [asyncResp, callback = std::move(callback)](
+        [callback = std::move(callback)](
             const boost::system::error_code& ec,
             const dbus::utility::DBusPropertiesMap& userInfoMap) mutable {
-            handleRequestUserInfo(asyncResp, ec, std::move(callback),
-                                  userInfoMap);
+            callback(ec, userInfoMap);
         },
         "xyz.openbmc_project.User.Manager", "/xyz/openbmc_project/user",
         "xyz.openbmc_project.User.Manager", "GetUserInfo", username);
 }
 
+inline void requestUserInfo(
+    bmcweb::UserInfoCache& cache, const UserInfoFetcher& fetcher,
+    const std::string& username,
+    const std::shared_ptr<bmcweb::AsyncResp>& asyncResp,
+    std::move_only_function<void(const dbus::utility::DBusPropertiesMap&)>&&
+        callback)
+{
+    std::shared_ptr<const dbus::utility::DBusPropertiesMap> cached =
+        cache.find(username);
+    if (cached != nullptr)
+    {
+        BMCWEB_LOG_DEBUG("Using cached user info for {}", username);
+        // Callers expect to be called back later, as they are on a miss, and
+        // some still have work to do after this returns
+        boost::asio::post(getIoContext(),
+                          [cached, callback = std::move(callback)]() mutable {
+                              callback(*cached);
+                          });
+        return;
+    }
+
+    uint64_t generation = cache.beginFetch();
+    fetcher(username,
+            [&cache, username, generation, asyncResp,
+             callback = std::move(callback)](
+                const boost::system::error_code& ec,
+                const dbus::utility::DBusPropertiesMap& userInfoMap) mutable {
+                if (!ec)
+                {
+                    cache.insert(username, generation, userInfoMap);
+                }
+                handleRequestUserInfo(asyncResp, ec, std::move(callback),
+                                      userInfoMap);
+            });
+}
+
+inline void requestUserInfo(
+    const std::string& username,
+    const std::shared_ptr<bmcweb::AsyncResp>& asyncResp,
+    std::move_only_function<void(const dbus::utility::DBusPropertiesMap&)>&&
+        callback)
+{
+    requestUserInfo(bmcweb::UserInfoCache::getInstance(),
+                    getUserInfoFromUserManager, username, asyncResp,
+                    std::move(callback));
+}
+
 inline void validatePrivilege(
     const std::shared_ptr<Request>& req,
     const std::shared_ptr<bmcweb::AsyncResp>& asyncResp, BaseRule& rule,
@@ -194,6 +248,15 @@ inline void validatePrivilege(
         return;
     }
 
+    if (req->userInfoPopulated)
+    {
+        if (isUserPrivileged(*req, asyncResp, rule))
+        {
+            callback();
+        }
+        return;
+    }
+
     requestUserInfo(
         req->session->username, asyncResp,
         [req, asyncResp, &rule, callback = std::move(callback)](
@@ -6,6 +6,8 @@
 #include "async_resp.hpp"
 #include "boost_formatters.hpp"
 #include "dbus_singleton.hpp"
+#include "logging.hpp"
+#include "single_flight.hpp"
 
 #include <boost/system/error_code.hpp>
 #include <sdbusplus/asio/connection.hpp>
@@ -120,15 +122,50 @@ void async_method_call(const std::shared_ptr<bmcweb::AsyncResp>& /*asyncResp*/,
         a...);
 }
 
+namespace details
+{
+// Registers detach to be called by propertiesWritten() with the key prefix
+// of the getProperty calls to detach
+void addPropertyCallsDetacher(std::function<void(std::string_view)>&& detach);
+
+// getProperty calls in flight, for each property type
+template <typename PropertyType>
+bmcweb::SingleFlight<PropertyType>& getPropertyCalls()
+{
+    static bmcweb::SingleFlight<PropertyType> calls;
+    [[maybe_unused]] static const bool registered = []() {
+        addPropertyCallsDetacher([](std::string_view prefix) {
+            calls.detachIf([prefix](std::string_view key) {
+                return key.starts_with(prefix);
+            });
+        });
+        return true;
+    }();
+    return calls;
+}
+} // namespace details
+
 template <typename PropertyType>
 void getProperty(const std::string& service, const std::string& objectPath,
                  const std::string& interface, const std::string& propertyName,
                  std::function<void(const boost::system::error_code&,
                                     const PropertyType&)>&& callback)
 {
-    sdbusplus::asio::getProperty<PropertyType>(
-        *crow::connections::systemBus, service, objectPath, interface,
-        propertyName, std::move(callback));
+    // Keyed like getAllProperties, so that propertiesWritten() finds it
+    bool called = details::getPropertyCalls<PropertyType>().run(
+        bmcweb::singleFlightKey({objectPath, interface, propertyName, service}),
+        std::move(callback),
+        [&service, &objectPath, &interface, &propertyName](
+            typename bmcweb::SingleFlight<PropertyType>::Callback&& reply) {
+            sdbusplus::asio::getProperty<PropertyType>(
+                *crow::connections::systemBus, service, objectPath, interface,
+                propertyName, std::move(reply));
+        });
+    if (!called)
+    {
+        BMCWEB_LOG_DEBUG("Sharing Get {} {} {} {} already in flight", service,
+                         objectPath, interface, propertyName);
+    }
 }
 
 template <typename PropertyType>
@@ -207,5 +244,14 @@ void getManagedObjects(
     const std::string& service, const sdbusplus::object_path& path,
     std::function<void(const boost::system::error_code&,
                        const ManagedObjectType&)>&& callback);
+
+// Watches for objects and services coming and going, and drops cached mapper
+// replies when they do.  Must be called once the system bus is connected.
+void registerMapperCacheSignals();
+
+// A property of interface on path was written by bmcweb.  Get, GetAll and
+// GetManagedObjects calls already in flight may have read the old value, so
+// they aren't shared with anyone asking after this.
+void propertiesWritten(std::string_view path, std::string_view interface);
 } // namespace utility
 } // namespace dbus
@@ -2,6 +2,8 @@
 // SPDX-FileCopyrightText: Copyright OpenBMC Authors
 #pragma once
 
+#include "str_utility.hpp"
+
 #include <boost/spirit/home/x3/char/char.hpp>
 #include <boost/spirit/home/x3/char/char_class.hpp>
 #include <boost/spirit/home/x3/core/parse.hpp>
@@ -18,9 +20,13 @@
 
 #include <algorithm>
 #include <array>
+#include <charconv>
+#include <cstddef>
+#include <optional>
 #include <ranges>
 #include <span>
 #include <string_view>
+#include <system_error>
 #include <vector>
 
 namespace http_helpers
@@ -135,6 +141,122 @@ inline bool isContentTypeAllowed(std::string_view header, ContentType type,
     return type == allowed;
 }
 
+inline std::string_view trimSpaces(std::string_view str)
+{
+    size_t start = str.find_first_not_of(' ');
+    if (start == std::string_view::npos)
+    {
+        return {};
+    }
+    size_t end = str.find_last_not_of(' ');
+    return str.substr(start, end - start + 1);
+}
+
+// Returns the indentation requested through an "indent" parameter on the
+// application/json media range of an Accept header, for example
+// "application/json;indent=2".  Clients that explicitly ask for json get
+// compact output unless they ask for indentation this way.
+inline std::optional<int> getJsonIndent(std::string_view acceptsHeader)
+{
+    constexpr int maxIndent = 8;
+    for (const auto range : std::views::split(acceptsHeader, ','))
+    {
+        std::string_view mediaRange(range.begin(), range.end());
+        size_t semicolon = mediaRange.find(';');
+        if (!bmcweb::asciiIEquals(trimSpaces(mediaRange.substr(0, semicolon)),
+                                  "application/json"))
+        {
+            continue;
+        }
+        while (semicolon != std::string_view::npos)
+        {
+            mediaRange.remove_prefix(semicolon + 1);
+            semicolon = mediaRange.find(';');
+            std::string_view param =
+                trimSpaces(mediaRange.substr(0, semicolon));
+            constexpr std::string_view indentParam = "indent=";
+            if (!param.starts_with(indentParam))
+            {
+                continue;
+            }
+            param.remove_prefix(indentParam.size());
+            int indent = 0;
+            auto [ptr, ec] =
+                std::from_chars(param.begin(), param.end(), indent);
+            if (ec == std::errc() && ptr == param.end() && indent >= 0 &&
+                indent <= maxIndent)
+            {
+                return indent;
+            }
+        }
+        return std::nullopt;
+    }
+    return std::nullopt;
+}
+
+// Returns the indentation json responses are written with for a client that
+// prefers the given content type.  Clients that explicitly ask for json are
+// programs, which have no use for indentation unless they request it.
+// Everyone else, like curl with its default of */*, gets readable output.
+inline int getResponseJsonIndent(std::string_view acceptsHeader,
+                                 ContentType preferred)
+{
+    if (preferred == ContentType::JSON)
+    {
+        return getJsonIndent(acceptsHeader).value_or(-1);
+    }
+    return 2;
+}
+
+// Whether an If-None-Match header matches etag, the ETag of the current
+// representation.  The header is "*" or a list of entity tags, and is
+// compared with the weak comparison of RFC 9110 13.1.2, so a W/ prefix on
+// either side is ignored.  Parsing stops at the first malformed tag.
+inline bool ifNoneMatchMatches(std::string_view ifNoneMatch,
+                               std::string_view etag)
+{
+    if (etag.starts_with("W/"))
+    {
+        etag.remove_prefix(2);
+    }
+    if (etag.empty())
+    {
+        return false;
+    }
+    std::string_view list = trimSpaces(ifNoneMatch);
+    if (list == "*")
+    {
+        return true;
+    }
+    while (!list.empty())
+    {
+        if (list.front() == ',' || list.front() == ' ' || list.front() == '\t')
+        {
+            list.remove_prefix(1);
+            continue;
+        }
+        if (list.starts_with("W/"))
+        {
+            list.remove_prefix(2);
+        }
+        if (!list.starts_with('"'))
+        {
+            return false;
+        }
+        size_t end = list.find('"', 1);
+        if (end == std::string_view::npos)
+        {
+            return false;
+        }
+        if (list.substr(0, end + 1) == etag)
+        {
+            return true;
+        }
+        list.remove_prefix(end + 1);
+    }
+    return false;
+}
+
 enum class Encoding
 {
     ParseError,
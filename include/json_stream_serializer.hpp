@@ -0,0 +1,356 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+#pragma once
+
+#include <nlohmann/json.hpp>
+
+#include <array>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace bmcweb
+{
+
+// Responses with at least this many json nodes are serialized as they are
+// written to the socket, rather than into one string up front.
+constexpr size_t jsonStreamMinNodes = 2048;
+
+// Counts the nodes in value, giving up once limit has been reached.
+inline size_t countJsonNodes(const nlohmann::json& value, size_t limit)
+{
+    size_t count = 1;
+    if (!value.is_structured())
+    {
+        return count;
+    }
+    for (const nlohmann::json& child : value)
+    {
+        if (count >= limit)
+        {
+            break;
+        }
+        count += countJsonNodes(child, limit - count);
+    }
+    return count;
+}
+
+template <typename Integer>
+void appendInteger(Integer value, std::string& out)
+{
+    // Large enough for any 64 bit integer, with its sign
+    std::array<char, 24> buf{};
+    std::to_chars_result result =
+        std::to_chars(buf.data(), buf.data() + buf.size(), value);
+    out.append(buf.data(), result.ptr);
+}
+
+inline void appendUnicodeEscape(uint32_t value, std::string& out)
+{
+    constexpr std::string_view hex = "0123456789abcdef";
+    out += "\\u";
+    out += hex[(value >> 12U) & 0xFU];
+    out += hex[(value >> 8U) & 0xFU];
+    out += hex[(value >> 4U) & 0xFU];
+    out += hex[value & 0xFU];
+}
+
+struct Utf8Sequence
+{
+    // Number of bytes consumed, always at least one
+    size_t length = 1;
+    // Decoded codepoint, or nullopt if the bytes weren't valid UTF-8
+    std::optional<uint32_t> codepoint;
+};
+
+// Decodes the UTF-8 sequence at the start of str, which must not be empty.
+// An invalid sequence consumes only the bytes before the one that made it
+// invalid, so that byte is decoded again on its own.
+inline Utf8Sequence decodeUtf8(std::string_view str)
+{
+    Utf8Sequence seq;
+    uint8_t lead = static_cast<uint8_t>(str[0]);
+    if (lead < 0x80U)
+    {
+        seq.codepoint = lead;
+        return seq;
+    }
+
+    size_t continuations = 0;
+    uint32_t codepoint = 0;
+    // Allowed range of the first continuation byte, excluding overlong
+    // encodings, surrogates, and codepoints past U+10FFFF
+    uint8_t low = 0x80U;
+    uint8_t high = 0xBFU;
+    if (lead >= 0xC2U && lead <= 0xDFU)
+    {
+        continuations = 1;
+        codepoint = lead & 0x1FU;
+    }
+    else if (lead >= 0xE0U && lead <= 0xEFU)
+    {
+        continuations = 2;
+        codepoint = lead & 0x0FU;
+        if (lead == 0xE0U)
+        {
+            low = 0xA0U;
+        }
+        else if (lead == 0xEDU)
+        {
+            high = 0x9FU;
+        }
+    }
+    else if (lead >= 0xF0U && lead <= 0xF4U)
+    {
+        continuations = 3;
+        codepoint = lead & 0x07U;
+        if (lead == 0xF0U)
+        {
+            low = 0x90U;
+        }
+        else if (lead == 0xF4U)
+        {
+            high = 0x8FU;
+        }
+    }
+    else
+    {
+        return seq;
+    }
+
+    for (size_t index = 1; index <= continuations; index++)
+    {
+        if (index >= str.size())
+        {
+            // Truncated at the end of the string
+            seq.length = str.size();
+            return seq;
+        }
+        uint8_t byte = static_cast<uint8_t>(str[index]);
+        if (byte < low || byte > high)
+        {
+            seq.length = index;
+            return seq;
+        }
+        low = 0x80U;
+        high = 0xBFU;
+        codepoint = (codepoint << 6U) | (byte & 0x3FU);
+    }
+    seq.length = continuations + 1;
+    seq.codepoint = codepoint;
+    return seq;
+}
+
+// Appends str to out escaped as the contents of a json string, matching
+// nlohmann::json::dump() with ensure_ascii set and invalid UTF-8 replaced.
+inline void escapeJsonString(std::string_view str, std::string& out)
+{
+    size_t index = 0;
+    while (index < str.size())
+    {
+        size_t runStart = index;
+        while (index < str.size())
+        {
+            char c = str[index];
+            if (c < 0x20 || c >= 0x7F || c == '"' || c == '\\')
+            {
+                break;
+            }
+            index++;
+        }
+        out.append(str.substr(runStart, index - runStart));
+        if (index == str.size())
+        {
+            break;
+        }
+
+        Utf8Sequence seq = decodeUtf8(str.substr(index));
+        index += seq.length;
+        if (!seq.codepoint)
+        {
+            out += "\\ufffd";
+            continue;
+        }
+        uint32_t codepoint = *seq.codepoint;
+        switch (codepoint)
+        {
+            case '"':
+                out += "\\\"";
+                break;
+            case '\\':
+                out += "\\\\";
+                break;
+            case '\b':
+                out += "\\b";
+                break;
+            case '\f':
+                out += "\\f";
+                break;
+            case '\n':
+                out += "\\n";
+                break;
+            case '\r':
+                out += "\\r";
+                break;
+            case '\t':
+                out += "\\t";
+                break;
+            default:
+                if (codepoint <= 0xFFFFU)
+                {
+                    appendUnicodeEscape(codepoint, out);
+                }
+                else
+                {
+                    appendUnicodeEscape(0xD7C0U + (codepoint >> 10U), out);
+                    appendUnicodeEscape(0xDC00U + (codepoint & 0x3FFU), out);
+                }
+                break;
+        }
+    }
+}
+
+// Serializes a json tree a piece at a time, producing the same output as
+// nlohmann::json::dump(indent, ' ', true, error_handler_t::replace).  The tree
+// must not be modified until serialization is done.  The types bmcweb
+// responses are mostly made of, strings, integers, booleans and null, are
+// written directly; floats go through nlohmann's formatting.
+class JsonStreamSerializer
+{
+  public:
+    JsonStreamSerializer(const nlohmann::json& rootIn, int indentIn) :
+        root(rootIn), indent(indentIn)
+    {}
+
+    // Appends output to out until it holds at least maxSize bytes, or the
+    // tree has been fully written.  A single long string can take out past
+    // maxSize.
+    void next(std::string& out, size_t maxSize)
+    {
+        if (!started)
+        {
+            started = true;
+            writeValue(root, out);
+        }
+        while (!stack.empty() && out.size() < maxSize)
+        {
+            step(out);
+        }
+    }
+
+    bool done() const
+    {
+        return started && stack.empty();
+    }
+
+  private:
+    struct Frame
+    {
+        const nlohmann::json* node;
+        nlohmann::json::const_iterator it;
+        bool first = true;
+    };
+
+    void writeNewline(std::string& out) const
+    {
+        if (indent < 0)
+        {
+            return;
+        }
+        out += '\n';
+        out.append(static_cast<size_t>(indent) * stack.size(), ' ');
+    }
+
+    void writeValue(const nlohmann::json& value, std::string& out)
+    {
+        if (value.is_object() && !value.empty())
+        {
+            out += '{';
+            stack.push_back({&value, value.cbegin()});
+            return;
+        }
+        if (value.is_array() && !value.empty())
+        {
+            out += '[';
+            stack.push_back({&value, value.cbegin()});
+            return;
+        }
+        switch (value.type())
+        {
+            case nlohmann::json::value_t::string:
+                out += '"';
+                escapeJsonString(value.get_ref<const std::string&>(), out);
+                out += '"';
+                break;
+            case nlohmann::json::value_t::number_integer:
+                appendInteger(value.get<nlohmann::json::number_integer_t>(),
+                              out);
+                break;
+            case nlohmann::json::value_t::number_unsigned:
+                appendInteger(value.get<nlohmann::json::number_unsigned_t>(),
+                              out);
+                break;
+            case nlohmann::json::value_t::boolean:
+                out += value.get<bool>() ? "true" : "false";
+                break;
+            case nlohmann::json::value_t::null:
+                out += "null";
+                break;
+            default:
+                out += value.dump(-1, ' ', true,
+                                  nlohmann::json::error_handler_t::replace);
+                break;
+        }
+    }
+
+    void step(std::string& out)
+    {
+        Frame& frame = stack.back();
+        if (frame.it == frame.node->cend())
+        {
+            char close = frame.node->is_object() ? '}' : ']';
+            stack.pop_back();
+            writeNewline(out);
+            out += close;
+            return;
+        }
+        if (!frame.first)
+        {
+            out += ',';
+        }
+        frame.first = false;
+        writeNewline(out);
+        if (frame.node->is_object())
+        {
+            out += '"';
+            escapeJsonString(frame.it.key(), out);
+            out += indent < 0 ? "\":" : "\": ";
+        }
+        const nlohmann::json& child = *frame.it;
+        frame.it++;
+        // May push to the stack, so frame can't be used after this
+        writeValue(child, out);
+    }
+
+    const nlohmann::json& root;
+    int indent;
+    bool started = false;
+    std::vector<Frame> stack;
+};
+
+// Serializes value into a single string; the output is the same as dump()
+// with error_handler_t::replace.
+inline std::string serializeJson(const nlohmann::json& value, int indent)
+{
+    std::string out;
+    JsonStreamSerializer serializer(value, indent);
+    serializer.next(out, std::numeric_limits<size_t>::max());
+    return out;
+}
+
+} // namespace bmcweb
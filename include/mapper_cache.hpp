@@ -0,0 +1,457 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+#pragma once
+
+#include "dbus_utility.hpp"
+#include "io_context_singleton.hpp"
+#include "logging.hpp"
+#include "single_flight.hpp"
+
+#include <boost/asio/error.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/container/flat_map.hpp>
+#include <boost/system/error_code.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace dbus
+{
+namespace utility
+{
+
+// Builds the cache key for a mapper call from its arguments
+inline std::string mapperCacheKey(std::span<const std::string_view> paths,
+                                  int32_t depth,
+                                  std::span<const std::string_view> interfaces)
+{
+    std::string key;
+    for (std::string_view path : paths)
+    {
+        key += path;
+        key += '\0';
+    }
+    key += std::to_string(depth);
+    for (std::string_view interface : interfaces)
+    {
+        key += '\0';
+        key += interface;
+    }
+    return key;
+}
+
+// The objects a mapper lookup's reply depends on
+struct MapperCacheScope
+{
+    std::string path;
+    // Subtree lookups cover everything below path; GetObject only covers
+    // path itself
+    bool subtree = true;
+    // Empty if the lookup didn't filter on interfaces
+    std::vector<std::string> interfaces;
+
+    // Whether interfaces being added to or removed from the object at
+    // objectPath could change the reply
+    bool affectedBy(std::string_view objectPath,
+                    std::span<const std::string> changed) const
+    {
+        if (objectPath != path)
+        {
+            if (!subtree)
+            {
+                return false;
+            }
+            if (path != "/" &&
+                (!objectPath.starts_with(path) ||
+                 objectPath.substr(path.size(), 1) != "/"))
+            {
+                return false;
+            }
+        }
+        if (interfaces.empty() || changed.empty())
+        {
+            return true;
+        }
+        return std::ranges::any_of(changed, [this](const std::string& name) {
+            return std::ranges::find(interfaces, name) != interfaces.end();
+        });
+    }
+};
+
+// Caches the replies to one ObjectMapper method, keyed by its arguments.  The
+// mapper's answers only change when objects or services come and go, so
+// entries are kept until the signal handlers registered by
+// registerMapperCacheSignals() see that happen, or until they time out, as a
+// fallback for changes that aren't signaled.  Identical lookups made while a
+// call is in flight share its reply rather than making their own.
+template <typename Response>
+class MapperResponseCache
+{
+  public:
+    using Clock = std::chrono::steady_clock;
+    using Callback =
+        std::function<void(const boost::system::error_code&, const Response&)>;
+
+    struct Stats
+    {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t coalesced = 0;
+    };
+
+    static constexpr std::chrono::seconds defaultTimeout{60};
+    static constexpr size_t maxEntries = 256;
+
+    explicit MapperResponseCache(
+        boost::asio::io_context& ioIn,
+        std::chrono::seconds timeoutIn = defaultTimeout) :
+        io(ioIn), timeout(timeoutIn)
+    {}
+
+    // Calls callback with the reply for key, which depends on the objects in
+    // scope.  On a miss, fetch is called with a callback to pass the mapper's
+    // reply to; fetch must not call it before returning.  Cached replies are
+    // posted, so callback is never called before get() returns.
+    template <typename Fetch>
+    void get(const std::string& key, MapperCacheScope&& scope,
+             Callback&& callback, Fetch&& fetch,
+             Clock::time_point now = Clock::now())
+    {
+        auto entry = entries.find(key);
+        if (entry != entries.end() && now >= entry->second.expires)
+        {
+            entries.erase(entry);
+            entry = entries.end();
+        }
+        if (entry != entries.end())
+        {
+            stats.hits++;
+            boost::asio::post(io, [callback = std::move(callback),
+                                   response = entry->second.response]() {
+                callback(boost::system::error_code(), *response);
+            });
+            return;
+        }
+
+        bool called = inflight.run(
+            key, std::move(callback),
+            [this, &key, &scope, &fetch](Callback&& reply) {
+                auto pending = std::make_shared<Fetching>(std::move(scope));
+                fetching.insert_or_assign(key, pending);
+                fetch(Callback([this, key, pending, reply = std::move(reply)](
+                                   const boost::system::error_code& ec,
+                                   const Response& response) {
+                    onReply(key, pending, ec, response);
+                    reply(ec, response);
+                }));
+            });
+        if (called)
+        {
+            stats.misses++;
+        }
+        else
+        {
+            stats.coalesced++;
+        }
+    }
+
+    // Drops every entry.  Calls in flight still reply to their callers, but
+    // their replies aren't cached, and new lookups don't wait on them.
+    void invalidate()
+    {
+        entries.clear();
+        for (auto& pending : fetching)
+        {
+            pending.second->stale = true;
+        }
+        fetching.clear();
+        inflight.detach();
+    }
+
+    // As above, for only the entries and calls that interfaces being added
+    // to or removed from objectPath could affect
+    void invalidate(std::string_view objectPath,
+                    std::span<const std::string> changed)
+    {
+        for (auto it = entries.begin(); it != entries.end();)
+        {
+            if (it->second.scope.affectedBy(objectPath, changed))
+            {
+                it = entries.erase(it);
+                continue;
+            }
+            it++;
+        }
+        for (auto it = fetching.begin(); it != fetching.end();)
+        {
+            if (it->second->scope.affectedBy(objectPath, changed))
+            {
+                it->second->stale = true;
+                inflight.detach(it->first);
+                it = fetching.erase(it);
+                continue;
+            }
+            it++;
+        }
+    }
+
+    // While the mapper is still learning about a new service its replies
+    // are incomplete; they're handed out, but not kept.
+    void setCaching(bool enabled)
+    {
+        caching = enabled;
+    }
+
+    size_t size() const
+    {
+        return entries.size();
+    }
+
+    const Stats& getStats() const
+    {
+        return stats;
+    }
+
+  private:
+    struct Entry
+    {
+        std::shared_ptr<const Response> response;
+        MapperCacheScope scope;
+        Clock::time_point expires;
+    };
+
+    // A call to the mapper that hasn't replied yet
+    struct Fetching
+    {
+        explicit Fetching(MapperCacheScope&& scopeIn) :
+            scope(std::move(scopeIn))
+        {}
+
+        MapperCacheScope scope;
+        // Something in scope changed after the call was made
+        bool stale = false;
+    };
+
+    void onReply(const std::string& key,
+                 const std::shared_ptr<Fetching>& pending,
+                 const boost::system::error_code& ec, const Response& response)
+    {
+        auto it = fetching.find(key);
+        if (it != fetching.end() && it->second == pending)
+        {
+            fetching.erase(it);
+        }
+        if (pending->stale || !caching)
+        {
+            BMCWEB_LOG_DEBUG("Mapper changed during lookup, not caching");
+            return;
+        }
+        // Errors are usually transient, like a timeout, so aren't cached
+        if (!ec)
+        {
+            insert(key, std::move(pending->scope), response);
+        }
+    }
+
+    void insert(const std::string& key, MapperCacheScope&& scope,
+                const Response& response)
+    {
+        Clock::time_point now = Clock::now();
+        if (entries.size() >= maxEntries)
+        {
+            evict(now);
+        }
+        Entry& entry = entries[key];
+        entry.response = std::make_shared<const Response>(response);
+        entry.scope = std::move(scope);
+        entry.expires = now + timeout;
+    }
+
+    void evict(Clock::time_point now)
+    {
+        auto it = entries.begin();
+        while (it != entries.end())
+        {
+            if (now >= it->second.expires)
+            {
+                it = entries.erase(it);
+            }
+            else
+            {
+                it++;
+            }
+        }
+        if (entries.size() < maxEntries)
+        {
+            return;
+        }
+        // Still full; drop whichever entry expires soonest
+        entries.erase(std::ranges::min_element(
+            entries, std::less<>(),
+            [](const auto& entry) { return entry.second.expires; }));
+    }
+
+    boost::asio::io_context& io;
+    std::chrono::seconds timeout;
+    bool caching = true;
+    Stats stats;
+    boost::container::flat_map<std::string, Entry, std::less<>> entries;
+    boost::container::flat_map<std::string, std::shared_ptr<Fetching>,
+                               std::less<>>
+        fetching;
+    bmcweb::SingleFlight<Response> inflight;
+};
+
+// One cache per mapper method, so each keeps its own statistics
+struct MapperCache
+{
+    using Clock = std::chrono::steady_clock;
+
+    // How long to wait for the mapper to finish introspecting a service that
+    // appeared on the bus.  The mapper only signals IntrospectionComplete
+    // for services it introspects, so this bounds the wait for the others.
+    static constexpr std::chrono::seconds defaultIntrospectTimeout{10};
+
+    explicit MapperCache(
+        boost::asio::io_context& io,
+        std::chrono::seconds introspectTimeoutIn = defaultIntrospectTimeout) :
+        subTree(io), subTreePaths(io), object(io), associatedSubTree(io),
+        introspectTimeout(introspectTimeoutIn), introspectTimer(io)
+    {}
+
+    static MapperCache& getInstance()
+    {
+        static MapperCache cache(getIoContext());
+        return cache;
+    }
+
+    void invalidate()
+    {
+        subTree.invalidate();
+        subTreePaths.invalidate();
+        object.invalidate();
+        associatedSubTree.invalidate();
+    }
+
+    // Interfaces were added to or removed from the object at path.  The
+    // mapper handles those signals as they arrive, so lookups made after
+    // this see the change.
+    void invalidate(std::string_view path,
+                    std::span<const std::string> interfaces)
+    {
+        subTree.invalidate(path, interfaces);
+        subTreePaths.invalidate(path, interfaces);
+        object.invalidate(path, interfaces);
+        if (std::ranges::find(interfaces, "xyz.openbmc_project.Association") !=
+            interfaces.end())
+        {
+            // A new or removed association changes which endpoints
+            // associated subtree lookups follow, wherever they are
+            associatedSubTree.invalidate();
+            return;
+        }
+        associatedSubTree.invalidate(path, interfaces);
+    }
+
+    // A service took a name on the bus.  The mapper introspects it in the
+    // background, so until that finishes its replies may be missing the
+    // service's objects.
+    void serviceStarted(const std::string& name)
+    {
+        invalidate();
+        introspecting.insert_or_assign(name, Clock::now() + introspectTimeout);
+        setCaching(false);
+        waitForIntrospection();
+    }
+
+    void introspectionComplete(std::string_view name)
+    {
+        auto it = introspecting.find(name);
+        if (it == introspecting.end())
+        {
+            return;
+        }
+        introspecting.erase(it);
+        if (introspecting.empty())
+        {
+            resumeCaching();
+        }
+    }
+
+    MapperResponseCache<MapperGetSubTreeResponse> subTree;
+    MapperResponseCache<MapperGetSubTreePathsResponse> subTreePaths;
+    MapperResponseCache<MapperGetObject> object;
+    MapperResponseCache<MapperGetSubTreeResponse> associatedSubTree;
+
+  private:
+    void setCaching(bool enabled)
+    {
+        subTree.setCaching(enabled);
+        subTreePaths.setCaching(enabled);
+        object.setCaching(enabled);
+        associatedSubTree.setCaching(enabled);
+    }
+
+    void resumeCaching()
+    {
+        introspectTimer.cancel();
+        // Calls made before the mapper was done may still reply with what
+        // it knew then
+        invalidate();
+        setCaching(true);
+    }
+
+    void waitForIntrospection()
+    {
+        auto soonest = std::ranges::min_element(
+            introspecting, std::less<>(),
+            [](const auto& pending) { return pending.second; });
+        introspectTimer.expires_at(soonest->second);
+        introspectTimer.async_wait([this](const boost::system::error_code& ec) {
+            if (ec == boost::asio::error::operation_aborted)
+            {
+                return;
+            }
+            Clock::time_point now = Clock::now();
+            for (auto it = introspecting.begin(); it != introspecting.end();)
+            {
+                if (now >= it->second)
+                {
+                    BMCWEB_LOG_DEBUG("Gave up waiting for mapper to "
+                                     "introspect {}",
+                                     it->first);
+                    it = introspecting.erase(it);
+                    continue;
+                }
+                it++;
+            }
+            if (introspecting.empty())
+            {
+                resumeCaching();
+                return;
+            }
+            waitForIntrospection();
+        });
+    }
+
+    std::chrono::seconds introspectTimeout;
+    boost::asio::steady_timer introspectTimer;
+    // Services the mapper hasn't finished introspecting, and when to stop
+    // waiting for each
+    boost::container::flat_map<std::string, Clock::time_point, std::less<>>
+        introspecting;
+};
+
+} // namespace utility
+} // namespace dbus
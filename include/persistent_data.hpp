@@ -5,6 +5,7 @@
 #include "event_service_store.hpp"
 #include "logging.hpp"
 #include "ossl_random.hpp"
+#include "resource_generation.hpp"
 #include "sessions.hpp"
 // NOLINTNEXTLINE(misc-include-cleaner)
 #include "parsing.hpp"
@@ -443,6 +444,9 @@ class ConfigFile
 
     std::string systemUuid;
     std::string serviceIdentification;
+    // Bumped whenever serviceIdentification changes.  systemUuid is fixed
+    // once the file has been read.
+    crow::ResourceGeneration generation;
 };
 
 inline ConfigFile& getConfig()
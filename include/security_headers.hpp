@@ -7,78 +7,136 @@
 
 #include <boost/beast/http/field.hpp>
 
+#include <array>
+#include <string_view>
+
+namespace security_headers
+{
+
+struct Header
+{
+    // unknown for headers older beast versions don't have an enum for
+    boost::beast::http::field field;
+    std::string_view name;
+    std::string_view value;
+};
+
+using bf = boost::beast::http::field;
+
+// Recommendations from https://owasp.org/www-project-secure-headers/
+// https://owasp.org/www-project-secure-headers/ci/headers_add.json
+// These are fixed, so they're built once rather than for each response.
+constexpr std::array<Header, 2> common{{
+    {bf::strict_transport_security, "Strict-Transport-Security",
+     "max-age=31536000; "
+     "includeSubdomains"},
+    {bf::pragma, "Pragma", "no-cache"},
+}};
+
+// Added unless the handler set its own
+constexpr Header cacheControl{bf::cache_control, "Cache-Control",
+                              "no-store, max-age=0"};
+
+constexpr Header contentTypeOptions{bf::unknown, "X-Content-Type-Options",
+                                    "nosniff"};
+
+// Only pages a browser renders need these
+constexpr std::array<Header, 8> html{{
+    {bf::x_frame_options, "X-Frame-Options", "DENY"},
+    {bf::unknown, "Referrer-Policy", "no-referrer"},
+    {bf::unknown, "Permissions-Policy",
+     "accelerometer=(),"
+     "ambient-light-sensor=(),"
+     "autoplay=(),"
+     "battery=(),"
+     "camera=(),"
+     "display-capture=(),"
+     "document-domain=(),"
+     "encrypted-media=(),"
+     "fullscreen=(),"
+     "gamepad=(),"
+     "geolocation=(),"
+     "gyroscope=(),"
+     "layout-animations=(self),"
+     "legacy-image-formats=(self),"
+     "magnetometer=(),"
+     "microphone=(),"
+     "midi=(),"
+     "oversized-images=(self),"
+     "payment=(),"
+     "picture-in-picture=(),"
+     "publickey-credentials-get=(),"
+     "speaker-selection=(),"
+     "sync-xhr=(self),"
+     "unoptimized-images=(self),"
+     "unsized-media=(self),"
+     "usb=(),"
+     "screen-wak-lock=(),"
+     "web-share=(),"
+     "xr-spatial-tracking=()"},
+    {bf::unknown, "X-Permitted-Cross-Domain-Policies", "none"},
+    {bf::unknown, "Cross-Origin-Embedder-Policy", "require-corp"},
+    {bf::unknown, "Cross-Origin-Opener-Policy", "same-origin"},
+    {bf::unknown, "Cross-Origin-Resource-Policy", "same-origin"},
+    // The KVM currently needs to load images from base64 encoded
+    // strings. img-src 'self' data: is used to allow that.
+    // https://stackoverflow.com/questions/18447970/content-security-polic
+    // y-data-not-working-for-base64-images-in-chrome-28
+    {bf::unknown, "Content-Security-Policy",
+     "default-src 'none'; "
+     "img-src 'self' data:; "
+     "font-src 'self'; "
+     "style-src 'self'; "
+     "script-src 'self'; "
+     "connect-src 'self' wss:; "
+     "form-action 'none'; "
+     "frame-ancestors 'none'; "
+     "object-src 'none'; "
+     "base-uri 'none' "},
+}};
+
+inline void add(crow::Response& res, const Header& header)
+{
+    if (header.field == bf::unknown)
+    {
+        // Newer beast versions may know the name, so let it look it up
+        res.fields().insert(header.name, header.value);
+        return;
+    }
+    // Passing the field along skips looking it up from the name
+    res.fields().insert(header.field, header.name, header.value);
+}
+
+} // namespace security_headers
+
 inline void addSecurityHeaders(crow::Response& res)
 {
     using bf = boost::beast::http::field;
 
-    // Recommendations from https://owasp.org/www-project-secure-headers/
-    // https://owasp.org/www-project-secure-headers/ci/headers_add.json
-    res.addHeader(bf::strict_transport_security, "max-age=31536000; "
-                                                 "includeSubdomains");
-
-    res.addHeader(bf::pragma, "no-cache");
+    for (const security_headers::Header& header : security_headers::common)
+    {
+        security_headers::add(res, header);
+    }
 
     if (res.getHeaderValue(bf::cache_control).empty())
     {
-        res.addHeader(bf::cache_control, "no-store, max-age=0");
+        security_headers::add(res, security_headers::cacheControl);
     }
-    res.addHeader("X-Content-Type-Options", "nosniff");
+    security_headers::add(res, security_headers::contentTypeOptions);
 
     std::string_view contentType = res.getHeaderValue(bf::content_type);
+    // Most responses are json, or have no content type; only parse the ones
+    // that could be html
+    if (contentType.empty() || contentType.starts_with("application/"))
+    {
+        return;
+    }
     if (http_helpers::getContentType(contentType) ==
         http_helpers::ContentType::HTML)
     {
-        res.addHeader(bf::x_frame_options, "DENY");
-        res.addHeader("Referrer-Policy", "no-referrer");
-        res.addHeader(
-            "Permissions-Policy",
-            "accelerometer=(),"
-            "ambient-light-sensor=(),"
-            "autoplay=(),"
-            "battery=(),"
-            "camera=(),"
-            "display-capture=(),"
-            "document-domain=(),"
-            "encrypted-media=(),"
-            "fullscreen=(),"
-            "gamepad=(),"
-            "geolocation=(),"
-            "gyroscope=(),"
-            "layout-animations=(self),"
-            "legacy-image-formats=(self),"
-            "magnetometer=(),"
-            "microphone=(),"
-            "midi=(),"
-            "oversized-images=(self),"
-            "payment=(),"
-            "picture-in-picture=(),"
-            "publickey-credentials-get=(),"
-            "speaker-selection=(),"
-            "sync-xhr=(self),"
-            "unoptimized-images=(self),"
-            "unsized-media=(self),"
-            "usb=(),"
-            "screen-wak-lock=(),"
-            "web-share=(),"
-            "xr-spatial-tracking=()");
-        res.addHeader("X-Permitted-Cross-Domain-Policies", "none");
-        res.addHeader("Cross-Origin-Embedder-Policy", "require-corp");
-        res.addHeader("Cross-Origin-Opener-Policy", "same-origin");
-        res.addHeader("Cross-Origin-Resource-Policy", "same-origin");
-        res.addHeader("Content-Security-Policy",
-                      "default-src 'none'; "
-                      "img-src 'self' data:; "
-                      "font-src 'self'; "
-                      "style-src 'self'; "
-                      "script-src 'self'; "
-                      "connect-src 'self' wss:; "
-                      "form-action 'none'; "
-                      "frame-ancestors 'none'; "
-                      "object-src 'none'; "
-                      "base-uri 'none' ");
-        // The KVM currently needs to load images from base64 encoded
-        // strings. img-src 'self' data: is used to allow that.
-        // https://stackoverflow.com/questions/18447970/content-security-polic
-        // y-data-not-working-for-base64-images-in-chrome-28
+        for (const security_headers::Header& header : security_headers::html)
+        {
+            security_headers::add(res, header);
+        }
     }
 }
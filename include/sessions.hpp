@@ -6,6 +6,7 @@
 
 #include "logging.hpp"
 #include "ossl_random.hpp"
+#include "resource_generation.hpp"
 #include "utils/ip_utils.hpp"
 
 #include <boost/asio/ip/address.hpp>
@@ -431,10 +432,17 @@ class SessionStore
 
     void updateSessionTimeout(std::chrono::seconds newTimeoutInSeconds)
     {
+        if (timeoutInSeconds != newTimeoutInSeconds)
+        {
+            timeoutGeneration.bump();
+        }
         timeoutInSeconds = newTimeoutInSeconds;
         needWrite = true;
     }
 
+    // Bumped whenever the session timeout changes
+    crow::ResourceGeneration timeoutGeneration;
+
     static SessionStore& getInstance()
     {
         static SessionStore sessionStore;
@@ -0,0 +1,148 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+#pragma once
+
+#include <boost/container/flat_map.hpp>
+#include <boost/system/error_code.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace bmcweb
+{
+
+// Joins the arguments of a call into a key for SingleFlight
+inline std::string singleFlightKey(
+    std::initializer_list<std::string_view> parts)
+{
+    std::string key;
+    for (std::string_view part : parts)
+    {
+        key += part;
+        key += '\0';
+    }
+    return key;
+}
+
+// Shares one call between everyone asking for the same thing at the same
+// time.  While a call for a key is outstanding, callers asking for the same
+// key are queued on it rather than making their own, and all of them get its
+// reply.  Nothing is kept once the reply has been handed out.
+template <typename Response>
+class SingleFlight
+{
+  public:
+    using Callback =
+        std::function<void(const boost::system::error_code&, const Response&)>;
+
+    struct Stats
+    {
+        // Calls actually made
+        uint64_t calls = 0;
+        // Callers that were given another caller's reply instead of a call
+        uint64_t saved = 0;
+    };
+
+    // Calls callback with the reply for key.  If no call for key is
+    // outstanding, call is invoked with a callback to pass the reply to, and
+    // true is returned; otherwise callback waits on the outstanding call and
+    // false is returned.
+    template <typename Call>
+    bool run(const std::string& key, Callback&& callback, Call&& call)
+    {
+        auto outstanding = inflight.find(key);
+        if (outstanding != inflight.end())
+        {
+            stats.saved++;
+            outstanding->second->emplace_back(std::move(callback));
+            return false;
+        }
+        stats.calls++;
+        std::shared_ptr<std::vector<Callback>> waiters =
+            std::make_shared<std::vector<Callback>>();
+        waiters->emplace_back(std::move(callback));
+        inflight.emplace(key, waiters);
+        call(Callback([this, key, waiters](const boost::system::error_code& ec,
+                                           const Response& response) {
+            finish(key, waiters, ec, response);
+        }));
+        return true;
+    }
+
+    // Callers after this make a new call rather than joining one that is
+    // already outstanding, for when its reply may be out of date.  Callers
+    // already waiting still get the reply.
+    void detach()
+    {
+        inflight.clear();
+    }
+
+    // As above, for the call outstanding for key only
+    void detach(std::string_view key)
+    {
+        auto outstanding = inflight.find(key);
+        if (outstanding != inflight.end())
+        {
+            inflight.erase(outstanding);
+        }
+    }
+
+    // As above, for the calls whose keys match.  Used when what a call reads
+    // is written, so that nobody asking after the write is given a reply
+    // read before it.
+    template <typename Predicate>
+    void detachIf(Predicate&& matches)
+    {
+        for (auto it = inflight.begin(); it != inflight.end();)
+        {
+            if (matches(std::string_view(it->first)))
+            {
+                it = inflight.erase(it);
+                continue;
+            }
+            it++;
+        }
+    }
+
+    size_t outstanding() const
+    {
+        return inflight.size();
+    }
+
+    const Stats& getStats() const
+    {
+        return stats;
+    }
+
+  private:
+    void finish(const std::string& key,
+                const std::shared_ptr<std::vector<Callback>>& waiters,
+                const boost::system::error_code& ec, const Response& response)
+    {
+        auto outstanding = inflight.find(key);
+        if (outstanding != inflight.end() && outstanding->second == waiters)
+        {
+            inflight.erase(outstanding);
+        }
+        std::vector<Callback> callbacks = std::move(*waiters);
+        for (Callback& callback : callbacks)
+        {
+            callback(ec, response);
+        }
+    }
+
+    Stats stats;
+    boost::container::flat_map<std::string,
+                               std::shared_ptr<std::vector<Callback>>,
+                               std::less<>>
+        inflight;
+};
+
+} // namespace bmcweb
@@ -0,0 +1,163 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+#pragma once
+
+#include "dbus_utility.hpp"
+#include "logging.hpp"
+
+#include <boost/container/flat_map.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace bmcweb
+{
+
+// Caches the GetUserInfo response from the user manager, keyed by username, so
+// that authenticated requests don't each need a D-Bus round trip to resolve
+// privileges.  Entries are invalidated by the signal handlers in
+// user_monitor.hpp when a user is changed or removed, and expire after a
+// timeout to pick up changes that aren't signaled, like LDAP group mappings.
+class UserInfoCache
+{
+  public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Stats
+    {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+    };
+
+    static constexpr std::chrono::seconds defaultTimeout{30};
+    static constexpr size_t maxEntries = 64;
+
+    explicit UserInfoCache(std::chrono::seconds timeoutIn = defaultTimeout) :
+        timeout(timeoutIn)
+    {}
+
+    static UserInfoCache& getInstance()
+    {
+        static UserInfoCache cache;
+        return cache;
+    }
+
+    // Returns the cached user info for username, or nullptr if it isn't
+    // cached or has expired.
+    std::shared_ptr<const dbus::utility::DBusPropertiesMap> find(
+        std::string_view username, Clock::time_point now = Clock::now())
+    {
+        auto it = entries.find(username);
+        if (it != entries.end() && now >= it->second.expires)
+        {
+            entries.erase(it);
+            it = entries.end();
+        }
+        if (it == entries.end())
+        {
+            stats.misses++;
+            return nullptr;
+        }
+        stats.hits++;
+        return it->second.userInfo;
+    }
+
+    // Returns a token to be passed to insert() once the user info has been
+    // fetched.  Any invalidation in between causes the insert to be dropped,
+    // so a reply that raced with a user change never gets cached.
+    uint64_t beginFetch() const
+    {
+        return generation;
+    }
+
+    void insert(std::string_view username, uint64_t fetchGeneration,
+                const dbus::utility::DBusPropertiesMap& userInfo,
+                Clock::time_point now = Clock::now())
+    {
+        if (fetchGeneration != generation)
+        {
+            BMCWEB_LOG_DEBUG(
+                "User info for {} changed during fetch, not caching", username);
+            return;
+        }
+        if (!entries.contains(username) && entries.size() >= maxEntries)
+        {
+            evict(now);
+        }
+        Entry& entry = entries[std::string(username)];
+        entry.userInfo =
+            std::make_shared<const dbus::utility::DBusPropertiesMap>(userInfo);
+        entry.expires = now + timeout;
+    }
+
+    void invalidate(std::string_view username)
+    {
+        generation++;
+        auto it = entries.find(username);
+        if (it != entries.end())
+        {
+            BMCWEB_LOG_DEBUG("Invalidating cached user info for {}", username);
+            entries.erase(it);
+        }
+    }
+
+    void clear()
+    {
+        generation++;
+        entries.clear();
+    }
+
+    size_t size() const
+    {
+        return entries.size();
+    }
+
+    const Stats& getStats() const
+    {
+        return stats;
+    }
+
+  private:
+    struct Entry
+    {
+        std::shared_ptr<const dbus::utility::DBusPropertiesMap> userInfo;
+        Clock::time_point expires;
+    };
+
+    void evict(Clock::time_point now)
+    {
+        auto it = entries.begin();
+        while (it != entries.end())
+        {
+            if (now >= it->second.expires)
+            {
+                it = entries.erase(it);
+            }
+            else
+            {
+                it++;
+            }
+        }
+        if (entries.size() < maxEntries)
+        {
+            return;
+        }
+        // Still full; drop whichever entry expires soonest
+        entries.erase(std::ranges::min_element(
+            entries, std::less<>(),
+            [](const auto& entry) { return entry.second.expires; }));
+    }
+
+    std::chrono::seconds timeout;
+    uint64_t generation = 0;
+    Stats stats;
+    boost::container::flat_map<std::string, Entry, std::less<>> entries;
+};
+
+} // namespace bmcweb
@@ -3,6 +3,7 @@
 #pragma once
 #include "dbus_singleton.hpp"
 #include "sessions.hpp"
+#include "user_info_cache.hpp"
 
 #include <sdbusplus/bus/match.hpp>
 #include <sdbusplus/message.hpp>
@@ -18,6 +19,7 @@ inline void onUserRemoved(sdbusplus::message_t& msg)
     auto p = msg.unpack<sdbusplus::object_path>();
 
     std::string username = p.filename();
+    UserInfoCache::getInstance().invalidate(username);
     persistent_data::SessionStore::getInstance().removeSessionsByUsername(
         username);
 }
@@ -54,6 +56,17 @@ inline void onUserPropertiesChanged(sdbusplus::message_t& msg)
         return;
     }
 
+    sdbusplus::object_path path(msg.get_path());
+    std::string username = path.filename();
+    if (username.empty())
+    {
+        return;
+    }
+
+    // Any attribute change (privilege, groups, password expiry) makes the
+    // cached GetUserInfo response stale.
+    UserInfoCache::getInstance().invalidate(username);
+
     const bool* userEnabled = nullptr;
     const bool success = sdbusplus::unpackPropertiesNoThrow(
         redfish::dbus_utils::UnpackErrorPrinter(), propertiesMap, "UserEnabled",
@@ -64,13 +77,6 @@ inline void onUserPropertiesChanged(sdbusplus::message_t& msg)
         return;
     }
 
-    sdbusplus::object_path path(msg.get_path());
-    std::string username = path.filename();
-    if (username.empty())
-    {
-        return;
-    }
-
     BMCWEB_LOG_INFO("User {} disabled; clearing active sessions", username);
     persistent_data::SessionStore::getInstance().removeSessionsByUsername(
         username);
@@ -8,9 +8,14 @@
 #include "http_body.hpp"
 #include "http_request.hpp"
 #include "http_response.hpp"
+#include "http_utility.hpp"
 #include "logging.hpp"
 #include "str_utility.hpp"
 #include "webroutes.hpp"
+#include "worker_pool.hpp"
+#include "zstd_compressor.hpp"
+
+#include <zlib.h>
 
 #include <boost/beast/http/field.hpp>
 #include <boost/beast/http/status.hpp>
@@ -18,10 +23,19 @@
 
 #include <algorithm>
 #include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
 #include <filesystem>
 #include <format>
+#include <fstream>
+#include <functional>
+#include <ios>
+#include <iterator>
 #include <memory>
+#include <optional>
 #include <ranges>
+#include <span>
 #include <string>
 #include <string_view>
 #include <system_error>
@@ -67,6 +81,22 @@ inline std::string getStaticEtag(const std::filesystem::path& webpath)
 
 static constexpr std::string_view rootpath("/usr/share/www/");
 
+// Static files, and compressed copies of them, are kept in memory up to this
+// many bytes in total.  Files past that are read from disk on each request.
+// Files are loaded the first time they are requested, so that files which
+// are never served don't use any of it.
+constexpr size_t staticCacheMaxBytes = 16UL * 1024UL * 1024UL;
+
+// What is left of staticCacheMaxBytes
+inline size_t& staticCacheRemaining()
+{
+    static size_t remaining = staticCacheMaxBytes;
+    return remaining;
+}
+
+// Files smaller than this aren't worth keeping compressed copies of
+constexpr size_t minCompressSize = 1024;
+
 struct StaticFile
 {
     std::filesystem::path absolutePath;
@@ -75,8 +105,253 @@ struct StaticFile
     std::string etag;
     bmcweb::CompressionType onDiskComp = bmcweb::CompressionType::Raw;
     bool renamed = false;
+    // The etag came from a build hash in the filename, rather than from the
+    // contents
+    bool hashedName = false;
+
+    enum class CacheState
+    {
+        Unloaded,
+        Loading,
+        Done,
+    };
+    CacheState cacheState = CacheState::Unloaded;
+
+    // File contents as stored on disk, once they have been loaded
+    std::shared_ptr<const std::string> contents;
+    // Compressed copies of a file stored raw on disk, where they are
+    // meaningfully smaller
+    std::shared_ptr<const std::string> gzipContents;
+    std::shared_ptr<const std::string> zstdContents;
+};
+
+inline std::optional<std::string> readStaticFile(
+    const std::filesystem::path& path)
+{
+    std::ifstream stream(path, std::ios::binary);
+    if (!stream)
+    {
+        return std::nullopt;
+    }
+    std::string contents{std::istreambuf_iterator<char>(stream),
+                         std::istreambuf_iterator<char>()};
+    if (stream.bad())
+    {
+        return std::nullopt;
+    }
+    return contents;
+}
+
+inline std::optional<std::string> gzipCompress(std::string_view data)
+{
+    z_stream stream{};
+    // 16 added to the window bits selects the gzip format
+    if (deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, MAX_WBITS + 16,
+                     8, Z_DEFAULT_STRATEGY) != Z_OK)
+    {
+        return std::nullopt;
+    }
+    std::string out(deflateBound(&stream, static_cast<uLong>(data.size())),
+                    '\0');
+    // zlib doesn't modify its input, but the api isn't const correct
+    stream.next_in = std::bit_cast<Bytef*>(data.data());
+    stream.avail_in = static_cast<uInt>(data.size());
+    stream.next_out = std::bit_cast<Bytef*>(out.data());
+    stream.avail_out = static_cast<uInt>(out.size());
+    int ret = deflate(&stream, Z_FINISH);
+    out.resize(stream.total_out);
+    deflateEnd(&stream);
+    if (ret != Z_STREAM_END)
+    {
+        return std::nullopt;
+    }
+    return out;
+}
+
+inline std::optional<std::string> zstdCompress(std::string_view data)
+{
+    bmcweb::ZstdCompressor compressor;
+    if (!compressor.init(data.size()))
+    {
+        return std::nullopt;
+    }
+    std::span<const uint8_t> in(std::bit_cast<const uint8_t*>(data.data()),
+                                data.size());
+    std::optional<std::span<const uint8_t>> compressed =
+        compressor.compress(in, false);
+    if (!compressed)
+    {
+        return std::nullopt;
+    }
+    return std::string(std::bit_cast<const char*>(compressed->data()),
+                       compressed->size());
+}
+
+// Keeps a compressed copy only if it saves at least an eighth of the size
+inline std::shared_ptr<const std::string> worthKeeping(
+    std::optional<std::string>&& compressed, size_t originalSize,
+    size_t& cacheRemaining)
+{
+    if (!compressed || compressed->size() > originalSize - originalSize / 8 ||
+        compressed->size() > cacheRemaining)
+    {
+        return nullptr;
+    }
+    cacheRemaining -= compressed->size();
+    return std::make_shared<const std::string>(std::move(*compressed));
+}
+
+// A static file, and compressed copies of it, as read by a worker thread
+struct LoadedStaticFile
+{
+    std::optional<std::string> contents;
+    std::optional<std::string> gzipContents;
+    std::optional<std::string> zstdContents;
 };
 
+// Reads a file and compresses it.  Touches nothing shared, so it can be run
+// on a worker thread.  Files larger than maxSize aren't read.
+inline LoadedStaticFile readStaticFileForCache(
+    const std::filesystem::path& path, bool compress, size_t maxSize)
+{
+    LoadedStaticFile loaded;
+    std::error_code ec;
+    uintmax_t size = std::filesystem::file_size(path, ec);
+    if (ec || size > maxSize)
+    {
+        return loaded;
+    }
+    loaded.contents = readStaticFile(path);
+    if (!loaded.contents || !compress ||
+        loaded.contents->size() < minCompressSize)
+    {
+        return loaded;
+    }
+    loaded.gzipContents = gzipCompress(*loaded.contents);
+#ifdef HAVE_ZSTD
+    loaded.zstdContents = zstdCompress(*loaded.contents);
+#endif
+    return loaded;
+}
+
+// Keeps whatever was loaded for file, if it fits in what is left of the
+// cache.
+inline void storeStaticFile(StaticFile& file, LoadedStaticFile&& loaded,
+                            size_t& cacheRemaining)
+{
+    file.cacheState = StaticFile::CacheState::Done;
+    if (!loaded.contents || loaded.contents->size() > cacheRemaining)
+    {
+        BMCWEB_LOG_DEBUG("Not caching {}", file.absolutePath.string());
+        return;
+    }
+    cacheRemaining -= loaded.contents->size();
+    file.contents =
+        std::make_shared<const std::string>(std::move(*loaded.contents));
+
+    if (file.etag.empty())
+    {
+        // No build hash in the name; use a hash of the contents, so that
+        // files like index.html can still be revalidated cheaply
+        file.etag = std::format("\"{:08X}\"",
+                                std::hash<std::string_view>{}(*file.contents));
+    }
+
+    file.gzipContents =
+        worthKeeping(std::move(loaded.gzipContents), file.contents->size(),
+                     cacheRemaining);
+    file.zstdContents =
+        worthKeeping(std::move(loaded.zstdContents), file.contents->size(),
+                     cacheRemaining);
+}
+
+// Loads a file, and compressed copies of it, into memory if they fit in what
+// is left of the cache.
+inline void loadStaticFile(StaticFile& file, size_t& cacheRemaining)
+{
+    storeStaticFile(
+        file,
+        readStaticFileForCache(file.absolutePath,
+                               file.onDiskComp == bmcweb::CompressionType::Raw,
+                               cacheRemaining),
+        cacheRemaining);
+}
+
+// Starts loading a file into the cache on the file I/O pool, the first time
+// it is requested.  Until that finishes the file keeps being read from disk.
+inline void loadStaticFileLater(const std::shared_ptr<StaticFile>& file,
+                                bmcweb::WorkerPool& pool,
+                                size_t& cacheRemaining)
+{
+    if (file->cacheState != StaticFile::CacheState::Unloaded)
+    {
+        return;
+    }
+    file->cacheState = StaticFile::CacheState::Loading;
+    pool.run(
+        [path = file->absolutePath,
+         compress = file->onDiskComp == bmcweb::CompressionType::Raw,
+         maxSize = cacheRemaining]() {
+            return readStaticFileForCache(path, compress, maxSize);
+        },
+        [file, &cacheRemaining](LoadedStaticFile loaded) {
+            // Other files may have been stored in the meantime, so the
+            // budget is checked again here
+            storeStaticFile(*file, std::move(loaded), cacheRemaining);
+        });
+}
+
+inline void handleCachedStaticAsset(
+    const crow::Request& req,
+    const std::shared_ptr<bmcweb::AsyncResp>& asyncResp, const StaticFile& file)
+{
+    using http_helpers::Encoding;
+    if (file.onDiskComp != bmcweb::CompressionType::Raw ||
+        (!file.gzipContents && !file.zstdContents))
+    {
+        asyncResp->res.write(file.contents, file.onDiskComp);
+        return;
+    }
+
+    std::vector<Encoding> available;
+    if (file.zstdContents)
+    {
+        available.push_back(Encoding::ZSTD);
+    }
+    if (file.gzipContents)
+    {
+        available.push_back(Encoding::GZIP);
+    }
+    available.push_back(Encoding::UnencodedBytes);
+    Encoding encoding = http_helpers::getPreferredEncoding(
+        req.getHeaderValue(boost::beast::http::field::accept_encoding),
+        available);
+
+    asyncResp->res.addHeader(boost::beast::http::field::vary,
+                             "Accept-Encoding");
+    if (encoding == Encoding::ZSTD)
+    {
+        asyncResp->res.addHeader(boost::beast::http::field::content_encoding,
+                                 "zstd");
+        asyncResp->res.write(file.zstdContents,
+                             bmcweb::CompressionType::Zstd);
+        asyncResp->res.response.body().clientCompressionType =
+            bmcweb::CompressionType::Zstd;
+        return;
+    }
+    if (encoding == Encoding::GZIP)
+    {
+        asyncResp->res.addHeader(boost::beast::http::field::content_encoding,
+                                 "gzip");
+        asyncResp->res.write(file.gzipContents,
+                             bmcweb::CompressionType::Gzip);
+        asyncResp->res.response.body().clientCompressionType =
+            bmcweb::CompressionType::Gzip;
+        return;
+    }
+    asyncResp->res.write(file.contents);
+}
+
 inline void handleStaticAsset(
     const crow::Request& req,
     const std::shared_ptr<bmcweb::AsyncResp>& asyncResp, const StaticFile& file)
@@ -98,7 +373,7 @@ inline void handleStaticAsset(
         asyncResp->res.addHeader(boost::beast::http::field::etag, file.etag);
         // Don't cache paths that don't have the etag in them, like
         // index, which gets transformed to /
-        if (!file.renamed)
+        if (file.hashedName && !file.renamed)
         {
             // Anything with a hash can be cached forever and is
             // immutable
@@ -115,6 +390,12 @@ inline void handleStaticAsset(
         }
     }
 
+    if (file.contents)
+    {
+        handleCachedStaticAsset(req, asyncResp, file);
+        return;
+    }
+
     if (asyncResp->res.openFile(file.absolutePath, bmcweb::EncodingType::Raw,
                                 file.onDiskComp) != crow::OpenCode::Success)
     {
@@ -193,6 +474,7 @@ inline void addFile(App& app, const std::filesystem::directory_entry& dir)
     }
 
     file.etag = getStaticEtag(webpath);
+    file.hashedName = !file.etag.empty();
 
     if (webpath.filename().string().starts_with("index.") &&
         webpath.extension() == ".html")
@@ -225,10 +507,12 @@ inline void addFile(App& app, const std::filesystem::directory_entry& dir)
     }
 
     app.routeDynamic(webpath)(
-        [file = std::move(
-             file)](const crow::Request& req,
-                    const std::shared_ptr<bmcweb::AsyncResp>& asyncResp) {
-            handleStaticAsset(req, asyncResp, file);
+        [file = std::make_shared<StaticFile>(std::move(file))](
+            const crow::Request& req,
+            const std::shared_ptr<bmcweb::AsyncResp>& asyncResp) {
+            loadStaticFileLater(file, bmcweb::getFileIoPool(),
+                                staticCacheRemaining());
+            handleStaticAsset(req, asyncResp, *file);
         });
 }
 
@@ -0,0 +1,271 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+#pragma once
+
+#include "bmcweb_config.h"
+
+#include "io_context_singleton.hpp"
+#include "logging.hpp"
+
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/posix/stream_descriptor.hpp>
+#include <boost/system/error_code.hpp>
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace bmcweb
+{
+
+// Runs blocking work, like PAM conversations, on a small pool of threads so
+// that it doesn't stall the io_context, then calls the completion handler back
+// on the io_context thread.  bmcweb is built with BOOST_ASIO_DISABLE_THREADS,
+// so the worker threads never touch asio; finished work is queued, and the
+// io_context is woken through an eventfd it is waiting on.
+class WorkerPool
+{
+  public:
+    WorkerPool(boost::asio::io_context& io, size_t numThreadsIn) :
+        numThreads(numThreadsIn), wakeup(io)
+    {
+        eventFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (eventFd < 0)
+        {
+            BMCWEB_LOG_CRITICAL(
+                "Failed to create worker eventfd, running work inline");
+            return;
+        }
+        boost::system::error_code ec;
+        wakeup.assign(eventFd, ec);
+        if (ec)
+        {
+            BMCWEB_LOG_CRITICAL("Failed to assign worker eventfd {}", ec);
+            close(eventFd);
+            eventFd = -1;
+        }
+    }
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool(WorkerPool&&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+    WorkerPool& operator=(WorkerPool&&) = delete;
+
+    ~WorkerPool()
+    {
+        {
+            std::scoped_lock lock(mutex);
+            stopping = true;
+        }
+        workAvailable.notify_all();
+        for (std::thread& thread : threads)
+        {
+            thread.join();
+        }
+    }
+
+    // Calls work() on a worker thread, then handler(result) on the io_context
+    // thread.  work must not touch any state shared with the io_context.
+    template <typename Work, typename Handler>
+    void run(Work&& work, Handler&& handler)
+    {
+        using Result = std::invoke_result_t<Work&>;
+        static_assert(!std::is_void_v<Result>, "Work must return a result");
+        auto result = std::make_shared<std::optional<Result>>();
+        submit(
+            [result, work = std::forward<Work>(work)]() mutable {
+                result->emplace(work());
+            },
+            [result, handler = std::forward<Handler>(handler)]() mutable {
+                handler(std::move(**result));
+            });
+    }
+
+    // Whether so much work is already outstanding that more would be slow to
+    // get to.  Work done on behalf of unauthenticated clients checks this
+    // first, so that a flood of requests can't grow the queue without bound.
+    bool isFull() const
+    {
+        return eventFd >= 0 && numThreads != 0 &&
+               outstanding >= numThreads * maxQueuedPerThread;
+    }
+
+    size_t inFlight() const
+    {
+        return outstanding;
+    }
+
+    // Outstanding jobs per thread at which the pool reports itself full
+    static constexpr size_t maxQueuedPerThread = 16;
+
+  private:
+    struct Job
+    {
+        std::move_only_function<void()> work;
+        std::move_only_function<void()> done;
+    };
+
+    void submit(std::move_only_function<void()>&& work,
+                std::move_only_function<void()>&& done)
+    {
+        if (eventFd < 0 || numThreads == 0)
+        {
+            work();
+            done();
+            return;
+        }
+        startThreads();
+        {
+            std::scoped_lock lock(mutex);
+            pending.emplace_back(std::move(work), std::move(done));
+        }
+        workAvailable.notify_one();
+        outstanding++;
+        waitForCompletions();
+    }
+
+    void startThreads()
+    {
+        // Threads are started on first use so that processes and tests that
+        // never submit work don't pay for them.
+        while (threads.size() < numThreads)
+        {
+            threads.emplace_back(&WorkerPool::workerLoop, this);
+        }
+    }
+
+    void workerLoop()
+    {
+        while (true)
+        {
+            Job job;
+            {
+                std::unique_lock lock(mutex);
+                workAvailable.wait(
+                    lock, [this] { return stopping || !pending.empty(); });
+                if (stopping)
+                {
+                    return;
+                }
+                job = std::move(pending.front());
+                pending.pop_front();
+            }
+            job.work();
+            {
+                std::scoped_lock lock(mutex);
+                completed.emplace_back(std::move(job));
+            }
+            uint64_t count = 1;
+            if (write(eventFd, &count, sizeof(count)) < 0)
+            {
+                // Only fails if the counter would overflow, in which case the
+                // io_context is already due to wake.
+                continue;
+            }
+        }
+    }
+
+    // Only keep a wait pending while there is outstanding work, so that the
+    // io_context is free to return from run() when the pool is idle.
+    void waitForCompletions()
+    {
+        if (waiting || outstanding == 0)
+        {
+            return;
+        }
+        waiting = true;
+        wakeup.async_wait(
+            boost::asio::posix::stream_descriptor::wait_read,
+            std::bind_front(&WorkerPool::afterWakeup, this));
+    }
+
+    void afterWakeup(const boost::system::error_code& ec)
+    {
+        waiting = false;
+        if (ec)
+        {
+            BMCWEB_LOG_ERROR("Worker eventfd wait failed {}", ec);
+            return;
+        }
+        uint64_t count = 0;
+        if (read(eventFd, &count, sizeof(count)) < 0)
+        {
+            BMCWEB_LOG_DEBUG("Spurious worker wakeup");
+        }
+
+        std::deque<Job> finished;
+        {
+            std::scoped_lock lock(mutex);
+            finished.swap(completed);
+        }
+        for (Job& job : finished)
+        {
+            outstanding--;
+            job.done();
+        }
+        waitForCompletions();
+    }
+
+    size_t numThreads;
+    int eventFd = -1;
+    boost::asio::posix::stream_descriptor wakeup;
+
+    // Only accessed from the io_context thread
+    size_t outstanding = 0;
+    bool waiting = false;
+    std::vector<std::thread> threads;
+
+    // Shared with the worker threads, guarded by mutex
+    std::mutex mutex;
+    std::condition_variable workAvailable;
+    bool stopping = false;
+    std::deque<Job> pending;
+    std::deque<Job> completed;
+};
+
+// Number of worker threads to start, per the worker-threads option.  -1 means
+// one per CPU core.  Only work handed to the pool, like PAM conversations,
+// runs on these threads; everything else stays on the io_context.
+inline size_t getWorkerThreadCount()
+{
+    if constexpr (BMCWEB_WORKER_THREADS >= 0)
+    {
+        return static_cast<size_t>(BMCWEB_WORKER_THREADS);
+    }
+    unsigned int cores = std::thread::hardware_concurrency();
+    if (cores == 0)
+    {
+        // Core count unknown; fall back to a conservative default
+        return 2;
+    }
+    return cores;
+}
+
+inline WorkerPool& getWorkerPool()
+{
+    static WorkerPool pool(getIoContext(), getWorkerThreadCount());
+    return pool;
+}
+
+// Blocking file reads, like paging through log files, get a pool of their own
+// so that slow storage can't hold up PAM conversations queued behind them.
+inline WorkerPool& getFileIoPool()
+{
+    static WorkerPool pool(getIoContext(),
+                           static_cast<size_t>(BMCWEB_FILE_IO_THREADS));
+    return pool;
+}
+
+} // namespace bmcweb
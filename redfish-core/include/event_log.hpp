@@ -4,7 +4,9 @@
 
 #include <nlohmann/json.hpp>
 
+#include <chrono>
 #include <cstdint>
+#include <optional>
 #include <span>
 #include <string>
 #include <string_view>
@@ -22,6 +24,13 @@ struct UniqueEntryIDState
     int index = 0;
 };
 
+// Returns the timestamp of a redfish log entry, in whole seconds
+std::optional<std::chrono::sys_seconds> getEntryTimestamp(
+    std::string_view logEntry);
+
+// Formats the ID of the index'th entry logged within the same second
+std::string formatUniqueEntryID(std::chrono::sys_seconds timestamp, int index);
+
 bool getUniqueEntryID(UniqueEntryIDState& state, const std::string& logEntry,
                       std::string& entryID);
 
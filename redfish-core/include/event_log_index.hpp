@@ -0,0 +1,106 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+#pragma once
+
+#include <sys/types.h>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace redfish
+{
+
+namespace event_log
+{
+
+// Remembers where each entry of the redfish event log files starts, so that
+// a page of the log, or a single entry, can be read by seeking straight to it
+// rather than reading every line before it.  Files are tracked by inode, so
+// the index for a file is kept when rsyslog rotates it to a new name, and
+// only the bytes appended since the last update are read.  A file that has
+// shrunk, or whose first bytes have changed, is indexed again from the start.
+// The index is read and updated from the file I/O threads, so every call
+// takes its lock.
+class LogIndex
+{
+  public:
+    // One listed entry, ready to be read from the file
+    struct Location
+    {
+        std::filesystem::path file;
+        uint64_t offset = 0;
+        std::string id;
+    };
+
+    LogIndex(std::filesystem::path dirIn, std::string prefixIn);
+
+    static LogIndex& getInstance();
+
+    // Brings the index up to date with the files on disk
+    void update();
+
+    // The number of entries whose MessageId is in a known registry.  Entries
+    // that aren't can't be shown, so they're skipped by page() too.
+    size_t listedCount() const;
+
+    // A page of the listed entries, with the count it was taken from
+    struct Page
+    {
+        size_t listedCount = 0;
+        std::vector<Location> locations;
+    };
+
+    // Up to top listed entries, oldest first, after skipping skip of them
+    Page page(size_t skip, size_t top) const;
+
+    // Finds the entry with the given ID, whether it is listed or not
+    std::optional<Location> find(std::string_view id) const;
+
+  private:
+    struct Entry
+    {
+        uint64_t offset = 0;
+        std::chrono::sys_seconds timestamp;
+        bool listed = false;
+    };
+
+    struct File
+    {
+        std::filesystem::path path;
+        dev_t device = 0;
+        ino_t inode = 0;
+        std::string head;
+        // Bytes of the file covered by entries
+        uint64_t indexedSize = 0;
+        std::vector<Entry> entries;
+        size_t listed = 0;
+    };
+
+    static void extend(File& file);
+
+    // listedCount() for callers that hold the lock
+    size_t countListed() const;
+
+    // The ID of entries[entry] in files[file]; IDs count the entries in the
+    // same second before them, which may be in an older file.
+    std::string entryId(size_t file, size_t entry) const;
+
+    Location makeLocation(size_t file, size_t entry) const;
+
+    std::filesystem::path dir;
+    std::string prefix;
+    mutable std::mutex mutex;
+    // Oldest first
+    std::vector<File> files;
+};
+
+} // namespace event_log
+
+} // namespace redfish
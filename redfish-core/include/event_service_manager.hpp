@@ -28,6 +28,7 @@
 #include <algorithm>
 #include <cstdint>
 #include <cstdlib>
+#include <functional>
 #include <memory>
 #include <optional>
 #include <random>
@@ -534,14 +535,15 @@ class EventServiceManager
         msg["Name"] = "Event Log";
         msg["Events"] = logEntryArray;
 
-        std::string strMsg = nlohmann::json(msg).dump(
-            2, ' ', true, nlohmann::json::error_handler_t::replace);
+        std::shared_ptr<const std::string> strMsg =
+            std::make_shared<const std::string>(nlohmann::json(msg).dump(
+                2, ' ', true, nlohmann::json::error_handler_t::replace));
 
         messages.push_back(Event(eventId, msg));
         for (const auto& it : subscriptionsMap)
         {
             std::shared_ptr<Subscription> entry = it.second;
-            if (!entry->sendEventToSubscriber(eventId, std::string(strMsg)))
+            if (!entry->sendEventToSubscriber(eventId, strMsg))
             {
                 return false;
             }
@@ -554,10 +556,37 @@ class EventServiceManager
     {
         EventServiceManager& mgr = EventServiceManager::getInstance();
         mgr.eventId++;
+
+        // Subscriptions that filter the same way get the same message, so
+        // it's built once for each group of them
+        struct EventLogsMessage
+        {
+            uint64_t eventId = 0;
+            std::shared_ptr<const std::string> msg;
+        };
+        boost::container::flat_map<std::string, EventLogsMessage, std::less<>>
+            built;
         for (const auto& it : mgr.subscriptionsMap)
         {
             Subscription& entry = *it.second;
-            entry.filterAndSendEventLogs(mgr.eventId, eventRecords);
+            std::optional<std::string> key = entry.eventLogsKey();
+            if (!key)
+            {
+                entry.filterAndSendEventLogs(mgr.eventId, eventRecords);
+                continue;
+            }
+            auto [group, inserted] = built.try_emplace(std::move(*key));
+            EventLogsMessage& message = group->second;
+            if (inserted)
+            {
+                message.eventId = mgr.eventId;
+                message.msg = entry.filterEventLogs(message.eventId,
+                                                    eventRecords);
+            }
+            if (message.msg != nullptr)
+            {
+                entry.sendEventToSubscriber(message.eventId, message.msg);
+            }
         }
     }
 
@@ -567,10 +596,28 @@ class EventServiceManager
         EventServiceManager& mgr = EventServiceManager::getInstance();
         mgr.eventId++;
 
+        // Reports only differ by the Context of the subscription
+        boost::container::flat_map<std::string,
+                                   std::shared_ptr<const std::string>,
+                                   std::less<>>
+            byContext;
         for (const auto& it : mgr.subscriptionsMap)
         {
             Subscription& entry = *it.second;
-            entry.filterAndSendReports(mgr.eventId, reportId, var);
+            if (!entry.reportMatches(reportId))
+            {
+                continue;
+            }
+            auto [report, inserted] =
+                byContext.try_emplace(entry.userSub->customText);
+            if (inserted)
+            {
+                report->second = entry.makeReport(reportId, var);
+            }
+            if (report->second != nullptr)
+            {
+                entry.sendEventToSubscriber(mgr.eventId, report->second);
+            }
         }
     }
 
@@ -593,6 +640,9 @@ class EventServiceManager
 
         messages.push_back(Event(eventId, eventMessage));
 
+        // The message is the same for every subscriber, so it's serialized
+        // once, when the first one matches, and shared between them
+        std::shared_ptr<const std::string> strMsg;
         for (auto& it : subscriptionsMap)
         {
             std::shared_ptr<Subscription>& entry = it.second;
@@ -603,19 +653,22 @@ class EventServiceManager
                 continue;
             }
 
-            nlohmann::json::array_t eventRecord;
-            eventRecord.emplace_back(eventMessage);
+            if (strMsg == nullptr)
+            {
+                nlohmann::json::array_t eventRecord;
+                eventRecord.emplace_back(eventMessage);
 
-            nlohmann::json msgJson;
+                nlohmann::json msgJson;
 
-            msgJson["@odata.type"] = "#Event.v1_4_0.Event";
-            msgJson["Name"] = "Event Log";
-            msgJson["Id"] = eventId;
-            msgJson["Events"] = std::move(eventRecord);
+                msgJson["@odata.type"] = "#Event.v1_4_0.Event";
+                msgJson["Name"] = "Event Log";
+                msgJson["Id"] = eventId;
+                msgJson["Events"] = std::move(eventRecord);
 
-            std::string strMsg = msgJson.dump(
-                2, ' ', true, nlohmann::json::error_handler_t::replace);
-            entry->sendEventToSubscriber(eventId, std::move(strMsg));
+                strMsg = std::make_shared<const std::string>(msgJson.dump(
+                    2, ' ', true, nlohmann::json::error_handler_t::replace));
+            }
+            entry->sendEventToSubscriber(eventId, strMsg);
         }
     }
 };
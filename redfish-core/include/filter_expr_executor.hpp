@@ -6,11 +6,80 @@
 
 #include <nlohmann/json.hpp>
 
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <variant>
+#include <vector>
+
 namespace redfish
 {
 
-bool memberMatches(const nlohmann::json& member,
-                   const filter_ast::LogicalAnd& filterParam);
+// A $filter expression compiled into a flat program, so that it can be tested
+// against many members without walking the parse tree each time.  Key paths
+// are split and literals are parsed once, when the filter is compiled.
+class CompiledFilter
+{
+  public:
+    explicit CompiledFilter(const filter_ast::LogicalAnd& filter);
+
+    bool matches(const nlohmann::json& member) const;
+
+  private:
+    // One side of a comparison; either a literal from the expression, or a
+    // key to look up in the member being tested
+    struct Operand
+    {
+        std::variant<int64_t, double, std::string> literal;
+        // A string literal parsed as an Edm.DateTimeOffset, in microseconds
+        std::optional<int64_t> literalTime;
+        // Empty for literals
+        std::vector<std::string> path;
+        std::string key;
+        bool isTimeKey = false;
+    };
+
+    struct Comparison
+    {
+        Operand left;
+        filter_ast::ComparisonOpEnum token =
+            filter_ast::ComparisonOpEnum::Invalid;
+        Operand right;
+    };
+
+    // Instructions run in order against a stack of results
+    enum class OpCode : uint8_t
+    {
+        // Pushes the result of comparisons[comparison]
+        Compare,
+        Not,
+        And,
+        Or,
+    };
+
+    struct Instruction
+    {
+        OpCode op = OpCode::Compare;
+        size_t comparison = 0;
+    };
+
+    static Operand compileOperand(const filter_ast::Argument& argument);
+    void compile(const filter_ast::LogicalAnd& x);
+    void compile(const filter_ast::LogicalOr& x);
+    void compile(const filter_ast::LogicalNot& x);
+    void compile(const filter_ast::BooleanOp& x);
+    void compile(const filter_ast::Comparison& x);
+    void emit(OpCode op, size_t comparison = 0);
+
+    bool compare(const Comparison& comparison,
+                 const nlohmann::json& member) const;
+
+    std::vector<Comparison> comparisons;
+    std::vector<Instruction> program;
+    size_t depth = 0;
+    size_t maxDepth = 0;
+};
 
 bool applyFilterToCollection(nlohmann::json& body,
                              const filter_ast::LogicalAnd& filterParam);
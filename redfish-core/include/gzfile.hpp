@@ -4,21 +4,207 @@
 
 #include "logging.hpp"
 
+#include <sys/stat.h>
+#include <sys/types.h>
 #include <zlib.h>
 
+#include <boost/container/flat_map.hpp>
+
+#include <algorithm>
+#include <array>
 #include <cstddef>
 #include <cstdint>
+#include <ctime>
+#include <fstream>
+#include <functional>
 #include <iterator>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <span>
 #include <string>
 #include <utility>
 #include <vector>
 
+// A point part way through a gzip file that decompression can restart from.
+// Following zlib's examples/zran.c, that is a deflate block boundary together
+// with the 32KB of output before it, which is all the history later blocks
+// can refer back to.  The host log parser carries state from one buffer to
+// the next, so the checkpoint also holds that state at the first buffer
+// boundary after the block boundary.
+struct GzCheckpoint
+{
+    // Offset of the first compressed byte that isn't fully consumed
+    uint64_t in = 0;
+    // Bits of the byte before in that are still to be consumed
+    int bits = 0;
+    // Uncompressed offset of the block boundary
+    uint64_t out = 0;
+    std::vector<unsigned char> window;
+    // Uncompressed offset, on a buffer boundary, that parsing resumes from
+    uint64_t parseFrom = 0;
+    // Entries counted in the file before parseFrom
+    size_t count = 0;
+    std::string lastMessage;
+    std::string lastDelimiter;
+};
+
+// What a host log file decompresses to, found by reading it through once.
+// The entry counts and parser state only hold while none of the entries they
+// cover are in the requested page, and when the file is read starting from
+// the state it was indexed with.
+struct GzFileIndex
+{
+    dev_t device = 0;
+    ino_t inode = 0;
+    timespec mtime{};
+    off_t size = 0;
+
+    std::string startMessage;
+    std::string startDelimiter;
+
+    size_t count = 0;
+    std::string endMessage;
+    std::string endDelimiter;
+
+    std::vector<GzCheckpoint> checkpoints;
+
+    bool matches(const struct stat& st) const
+    {
+        return device == st.st_dev && inode == st.st_ino &&
+               mtime.tv_sec == st.st_mtim.tv_sec &&
+               mtime.tv_nsec == st.st_mtim.tv_nsec && size == st.st_size;
+    }
+};
+
+// Indexes of the host log files, by inode so that they follow the files as
+// they are renamed on rotation.  The files are read on the file I/O threads,
+// so every call takes the lock.
+class GzFileIndexCache
+{
+  public:
+    static constexpr size_t maxFiles = 16;
+
+    static GzFileIndexCache& getInstance()
+    {
+        static GzFileIndexCache cache;
+        return cache;
+    }
+
+    std::shared_ptr<const GzFileIndex> find(const struct stat& st) const
+    {
+        std::scoped_lock lock(mutex);
+        auto it = indexes.find({st.st_dev, st.st_ino});
+        if (it == indexes.end() || !it->second->matches(st))
+        {
+            return nullptr;
+        }
+        return it->second;
+    }
+
+    void insert(std::shared_ptr<const GzFileIndex> index)
+    {
+        std::scoped_lock lock(mutex);
+        std::pair<dev_t, ino_t> key{index->device, index->inode};
+        if (indexes.size() >= maxFiles && !indexes.contains(key))
+        {
+            // Files that have been rotated away are never found again, and
+            // there's no telling which they are, so make room arbitrarily
+            indexes.erase(indexes.begin());
+        }
+        indexes.insert_or_assign(key, std::move(index));
+    }
+
+  private:
+    mutable std::mutex mutex;
+    boost::container::flat_map<std::pair<dev_t, ino_t>,
+                               std::shared_ptr<const GzFileIndex>>
+        indexes;
+};
+
 class GzFileReader
 {
   public:
     bool gzGetLines(const std::string& filename, uint64_t skip, uint64_t top,
                     std::vector<std::string>& logEntries, size_t& logCount)
     {
+        // Indexes are only built and used while nothing before the file is in
+        // the page
+        struct stat st{};
+        bool indexable = indexCache != nullptr && logEntries.empty() &&
+                         totalFilesSize == 0 &&
+                         stat(filename.c_str(), &st) == 0;
+        std::shared_ptr<const GzFileIndex> index;
+        if (indexable)
+        {
+            index = indexCache->find(st);
+            if (index && (index->startMessage != lastMessage ||
+                          index->startDelimiter != lastDelimiter))
+            {
+                index = nullptr;
+            }
+        }
+        if (index)
+        {
+            if (logCount + index->count < skip)
+            {
+                // The whole file is before the page
+                logCount += index->count;
+                lastMessage = index->endMessage;
+                lastDelimiter = index->endDelimiter;
+                return true;
+            }
+            const GzCheckpoint* checkpoint = nullptr;
+            for (const GzCheckpoint& candidate : index->checkpoints)
+            {
+                if (logCount + candidate.count >= skip)
+                {
+                    break;
+                }
+                checkpoint = &candidate;
+            }
+            if (checkpoint != nullptr)
+            {
+                return readFrom(filename, *checkpoint, skip, top, logEntries,
+                                logCount);
+            }
+        }
+
+        std::string startMessage = lastMessage;
+        std::string startDelimiter = lastDelimiter;
+
+        if (indexable && !index)
+        {
+            // Read the page while indexing, so that the file is only
+            // decompressed once
+            size_t startCount = logCount;
+            bool parsed = true;
+            std::shared_ptr<const GzFileIndex> built = buildIndex(
+                filename, st, startMessage, startDelimiter,
+                [&](const std::string& bufferStr) {
+                    parsed = hostLogEntryParser(bufferStr, skip, top,
+                                                logEntries, logCount);
+                    return parsed;
+                });
+            if (!parsed)
+            {
+                BMCWEB_LOG_ERROR("Error occurs during parsing host log.");
+                return false;
+            }
+            if (built)
+            {
+                indexCache->insert(std::move(built));
+                return true;
+            }
+            // It can't be indexed, so read it from the start with gzread(),
+            // as if none of it had been read
+            logEntries.clear();
+            logCount = startCount;
+            totalFilesSize = 0;
+            lastMessage = startMessage;
+            lastDelimiter = startDelimiter;
+        }
+
         gzFile logStream = gzopen(filename.c_str(), "r");
         if (logStream == nullptr)
         {
@@ -41,6 +227,15 @@ class GzFileReader
     }
 
   private:
+    static constexpr size_t bufferLimitSize = 1024;
+    // Uncompressed bytes between checkpoints.  Each checkpoint holds a 32KB
+    // window, so this bounds the index at an eighth of the log's size.
+    static constexpr uint64_t checkpointSpan = 256 * 1024;
+    static constexpr size_t maxCheckpoints = 32;
+    static constexpr size_t windowSize = 32768;
+    static constexpr size_t inflateChunkSize = 16384;
+
+    GzFileIndexCache* indexCache = &GzFileIndexCache::getInstance();
     std::string lastMessage;
     std::string lastDelimiter;
     size_t totalFilesSize = 0;
@@ -58,7 +253,6 @@ class GzFileReader
     bool readFile(gzFile logStream, uint64_t skip, uint64_t top,
                   std::vector<std::string>& logEntries, size_t& logCount)
     {
-        constexpr int bufferLimitSize = 1024;
         do
         {
             std::string bufferStr;
@@ -72,6 +266,12 @@ class GzFileReader
                 printErrorMessage(logStream);
                 return false;
             }
+            // A file that ends on a buffer boundary only reaches eof on the
+            // read after its last buffer
+            if (bytesRead == 0)
+            {
+                break;
+            }
             bufferStr.resize(static_cast<size_t>(bytesRead));
             if (!hostLogEntryParser(bufferStr, skip, top, logEntries, logCount))
             {
@@ -83,6 +283,301 @@ class GzFileReader
         return true;
     }
 
+    // Reads compressed data into input, returning the number of bytes read
+    static size_t readInput(std::ifstream& file,
+                            std::array<unsigned char, inflateChunkSize>& input)
+    {
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        file.read(reinterpret_cast<char*>(input.data()),
+                  static_cast<std::streamsize>(input.size()));
+        return static_cast<size_t>(file.gcount());
+    }
+
+    // Decompresses the file once to find its entry count, the parser state
+    // it ends with, and checkpoints to restart from.  Each buffer is also
+    // passed to onBuffer, in the same sizes gzread() would read them, until
+    // it returns false.  Returns nullptr for anything but a single gzip
+    // member, which gzread() still reads from the start.
+    static std::shared_ptr<const GzFileIndex> buildIndex(
+        const std::string& filename, const struct stat& st,
+        const std::string& startMessage, const std::string& startDelimiter,
+        const std::function<bool(const std::string&)>& onBuffer)
+    {
+        std::ifstream file(filename, std::ios::binary);
+        z_stream strm{};
+        // 32 + 15 takes a gzip or zlib header, and any window size
+        if (!file.is_open() || inflateInit2(&strm, 47) != Z_OK)
+        {
+            return nullptr;
+        }
+        std::unique_ptr<z_stream, int (*)(z_streamp)> strmGuard(&strm,
+                                                                 inflateEnd);
+
+        auto index = std::make_shared<GzFileIndex>();
+        index->device = st.st_dev;
+        index->inode = st.st_ino;
+        index->mtime = st.st_mtim;
+        index->size = st.st_size;
+        index->startMessage = startMessage;
+        index->startDelimiter = startDelimiter;
+
+        GzFileReader parser(nullptr);
+        parser.lastMessage = startMessage;
+        parser.lastDelimiter = startDelimiter;
+        constexpr uint64_t noPage = std::numeric_limits<uint64_t>::max();
+        std::vector<std::string> noEntries;
+        size_t count = 0;
+
+        std::string chunk;
+        uint64_t parsed = 0;
+        bool statePending = false;
+        auto parse = [&](std::span<const unsigned char> data) {
+            while (!data.empty())
+            {
+                size_t take =
+                    std::min(bufferLimitSize - chunk.size(), data.size());
+                chunk.append(data.begin(),
+                             data.begin() + static_cast<std::ptrdiff_t>(take));
+                data = data.subspan(take);
+                if (chunk.size() < bufferLimitSize)
+                {
+                    break;
+                }
+                if (!parser.hostLogEntryParser(chunk, noPage, 0, noEntries,
+                                               count) ||
+                    !onBuffer(chunk))
+                {
+                    return false;
+                }
+                parsed += chunk.size();
+                chunk.clear();
+                if (statePending &&
+                    index->checkpoints.back().parseFrom == parsed)
+                {
+                    GzCheckpoint& checkpoint = index->checkpoints.back();
+                    checkpoint.count = count;
+                    checkpoint.lastMessage = parser.lastMessage;
+                    checkpoint.lastDelimiter = parser.lastDelimiter;
+                    statePending = false;
+                }
+            }
+            return true;
+        };
+
+        std::array<unsigned char, inflateChunkSize> input{};
+        // Output goes round the window, so it always holds the last 32KB
+        std::vector<unsigned char> window(windowSize);
+        uint64_t lastCheckpoint = 0;
+        int ret = Z_OK;
+        while (ret != Z_STREAM_END)
+        {
+            strm.next_in = input.data();
+            strm.avail_in = static_cast<uInt>(readInput(file, input));
+            if (strm.avail_in == 0)
+            {
+                BMCWEB_LOG_DEBUG("{} ends before its gzip trailer", filename);
+                return nullptr;
+            }
+            do
+            {
+                if (strm.avail_out == 0)
+                {
+                    strm.next_out = window.data();
+                    strm.avail_out = static_cast<uInt>(window.size());
+                }
+                size_t start = window.size() - strm.avail_out;
+                // Z_BLOCK stops at each deflate block boundary
+                ret = inflate(&strm, Z_BLOCK);
+                if (ret == Z_BUF_ERROR)
+                {
+                    break;
+                }
+                if (ret != Z_OK && ret != Z_STREAM_END)
+                {
+                    BMCWEB_LOG_DEBUG("Can't index {}: inflate returned {}",
+                                     filename, ret);
+                    return nullptr;
+                }
+                size_t end = window.size() - strm.avail_out;
+                if (!parse(std::span(window).subspan(start, end - start)))
+                {
+                    return nullptr;
+                }
+                if (ret == Z_STREAM_END)
+                {
+                    break;
+                }
+                // Bit 7 is set at a block boundary, and bit 6 after the last
+                // block
+                bool blockBoundary = (strm.data_type & 128) != 0 &&
+                                     (strm.data_type & 64) == 0;
+                if (blockBoundary &&
+                    strm.total_out - lastCheckpoint > checkpointSpan &&
+                    index->checkpoints.size() < maxCheckpoints)
+                {
+                    GzCheckpoint& checkpoint =
+                        index->checkpoints.emplace_back();
+                    checkpoint.in = strm.total_in;
+                    checkpoint.bits = strm.data_type & 7;
+                    checkpoint.out = strm.total_out;
+                    auto split = window.begin() +
+                                 static_cast<std::ptrdiff_t>(end);
+                    if (strm.total_out >= window.size())
+                    {
+                        checkpoint.window.assign(split, window.end());
+                    }
+                    checkpoint.window.insert(checkpoint.window.end(),
+                                             window.begin(), split);
+                    checkpoint.parseFrom =
+                        (checkpoint.out + bufferLimitSize - 1) /
+                        bufferLimitSize * bufferLimitSize;
+                    if (checkpoint.parseFrom == parsed)
+                    {
+                        checkpoint.count = count;
+                        checkpoint.lastMessage = parser.lastMessage;
+                        checkpoint.lastDelimiter = parser.lastDelimiter;
+                    }
+                    else
+                    {
+                        statePending = true;
+                    }
+                    lastCheckpoint = strm.total_out;
+                }
+            } while (strm.avail_in != 0 || strm.avail_out == 0);
+        }
+        if (strm.avail_in != 0 ||
+            file.peek() != std::ifstream::traits_type::eof())
+        {
+            BMCWEB_LOG_DEBUG("Not indexing {}, it has more than one member",
+                             filename);
+            return nullptr;
+        }
+        if (!chunk.empty() &&
+            (!parser.hostLogEntryParser(chunk, noPage, 0, noEntries, count) ||
+             !onBuffer(chunk)))
+        {
+            return nullptr;
+        }
+        if (statePending)
+        {
+            // The file ends before the buffer boundary after the checkpoint
+            index->checkpoints.pop_back();
+        }
+        index->count = count;
+        index->endMessage = parser.lastMessage;
+        index->endDelimiter = parser.lastDelimiter;
+        return index;
+    }
+
+    // Reads the rest of the file from a checkpoint taken when it was indexed
+    bool readFrom(const std::string& filename, const GzCheckpoint& checkpoint,
+                  uint64_t skip, uint64_t top,
+                  std::vector<std::string>& logEntries, size_t& logCount)
+    {
+        std::ifstream file(filename, std::ios::binary);
+        file.seekg(static_cast<std::streamoff>(
+            checkpoint.in - (checkpoint.bits != 0 ? 1 : 0)));
+        z_stream strm{};
+        // Negative window bits for raw deflate data, with no header
+        if (!file || inflateInit2(&strm, -15) != Z_OK)
+        {
+            BMCWEB_LOG_ERROR("Can't open gz file: {}", filename);
+            return false;
+        }
+        std::unique_ptr<z_stream, int (*)(z_streamp)> strmGuard(&strm,
+                                                                 inflateEnd);
+        if (checkpoint.bits != 0)
+        {
+            int byte = file.get();
+            if (byte == std::ifstream::traits_type::eof() ||
+                inflatePrime(&strm, checkpoint.bits,
+                             byte >> (8 - checkpoint.bits)) != Z_OK)
+            {
+                BMCWEB_LOG_ERROR("Can't resume reading gz file: {}", filename);
+                return false;
+            }
+        }
+        if (inflateSetDictionary(&strm, checkpoint.window.data(),
+                                 static_cast<uInt>(checkpoint.window.size())) !=
+            Z_OK)
+        {
+            BMCWEB_LOG_ERROR("Can't resume reading gz file: {}", filename);
+            return false;
+        }
+
+        logCount += checkpoint.count;
+        lastMessage = checkpoint.lastMessage;
+        lastDelimiter = checkpoint.lastDelimiter;
+        uint64_t discard = checkpoint.parseFrom - checkpoint.out;
+
+        std::string bufferStr;
+        std::array<unsigned char, inflateChunkSize> input{};
+        std::array<unsigned char, inflateChunkSize> output{};
+        int ret = Z_OK;
+        while (ret != Z_STREAM_END)
+        {
+            strm.next_in = input.data();
+            strm.avail_in = static_cast<uInt>(readInput(file, input));
+            if (strm.avail_in == 0)
+            {
+                BMCWEB_LOG_ERROR("Unexpected end of gz file: {}", filename);
+                return false;
+            }
+            do
+            {
+                strm.next_out = output.data();
+                strm.avail_out = static_cast<uInt>(output.size());
+                ret = inflate(&strm, Z_NO_FLUSH);
+                if (ret == Z_BUF_ERROR)
+                {
+                    break;
+                }
+                if (ret != Z_OK && ret != Z_STREAM_END)
+                {
+                    BMCWEB_LOG_ERROR(
+                        "Error reading gz file: {}, Error Number: {}", filename,
+                        ret);
+                    return false;
+                }
+                std::span<const unsigned char> data(
+                    output.data(), output.size() - strm.avail_out);
+                size_t dropped = static_cast<size_t>(
+                    std::min<uint64_t>(discard, data.size()));
+                discard -= dropped;
+                data = data.subspan(dropped);
+                while (!data.empty())
+                {
+                    size_t take = std::min(bufferLimitSize - bufferStr.size(),
+                                           data.size());
+                    bufferStr.append(data.begin(),
+                                     data.begin() +
+                                         static_cast<std::ptrdiff_t>(take));
+                    data = data.subspan(take);
+                    if (bufferStr.size() < bufferLimitSize)
+                    {
+                        break;
+                    }
+                    if (!hostLogEntryParser(bufferStr, skip, top, logEntries,
+                                            logCount))
+                    {
+                        BMCWEB_LOG_ERROR(
+                            "Error occurs during parsing host log.");
+                        return false;
+                    }
+                    bufferStr.clear();
+                }
+            } while (ret != Z_STREAM_END &&
+                     (strm.avail_in != 0 || strm.avail_out == 0));
+        }
+        if (!bufferStr.empty() &&
+            !hostLogEntryParser(bufferStr, skip, top, logEntries, logCount))
+        {
+            BMCWEB_LOG_ERROR("Error occurs during parsing host log.");
+            return false;
+        }
+        return true;
+    }
+
     bool hostLogEntryParser(const std::string& bufferStr, uint64_t skip,
                             uint64_t top, std::vector<std::string>& logEntries,
                             size_t& logCount)
@@ -211,6 +706,10 @@ class GzFileReader
 
   public:
     GzFileReader() = default;
+    // Reads without using or building indexes when indexCacheIn is null
+    explicit GzFileReader(GzFileIndexCache* indexCacheIn) :
+        indexCache(indexCacheIn)
+    {}
     ~GzFileReader() = default;
     GzFileReader(const GzFileReader&) = delete;
     GzFileReader& operator=(const GzFileReader&) = delete;
@@ -4,22 +4,28 @@
 
 #include "aggregation_utils.hpp"
 #include "async_resp.hpp"
+#include "dbus_singleton.hpp"
 #include "dbus_utility.hpp"
 #include "error_messages.hpp"
 #include "http_client.hpp"
 #include "http_request.hpp"
 #include "http_response.hpp"
+#include "http_utility.hpp"
 #include "io_context_singleton.hpp"
+#include "json_stream_serializer.hpp"
 #include "logging.hpp"
 #include "parsing.hpp"
+#include "resource_generation.hpp"
 #include "ssl_key_handler.hpp"
 #include "utility.hpp"
 #include "utils/collection.hpp"
 #include "utils/redfish_aggregator_utils.hpp"
 
+#include <boost/asio/post.hpp>
 #include <boost/beast/http/field.hpp>
 #include <boost/beast/http/status.hpp>
 #include <boost/beast/http/verb.hpp>
+#include <boost/container/flat_map.hpp>
 #include <boost/system/errc.hpp>
 #include <boost/system/result.hpp>
 #include <boost/url/param.hpp>
@@ -29,6 +35,9 @@
 #include <boost/url/url.hpp>
 #include <boost/url/url_view.hpp>
 #include <nlohmann/json.hpp>
+#include <sdbusplus/bus/match.hpp>
+#include <sdbusplus/exception.hpp>
+#include <sdbusplus/message.hpp>
 #include <sdbusplus/message/native_types.hpp>
 
 #include <algorithm>
@@ -36,9 +45,11 @@
 #include <chrono>
 #include <cstddef>
 #include <cstdint>
+#include <format>
 #include <functional>
 #include <limits>
 #include <memory>
+#include <optional>
 #include <ranges>
 #include <string>
 #include <string_view>
@@ -46,6 +57,7 @@
 #include <unordered_map>
 #include <utility>
 #include <variant>
+#include <vector>
 
 namespace redfish
 {
@@ -325,6 +337,19 @@ inline void addAggregatedHeaders(crow::Response& asyncResp,
     // TODO: we need special handling for Link Header Value
 }
 
+// Fix a single header of the form "<Field>: <Value>"
+inline void addPrefixToHeaderString(std::string& strHeader,
+                                    std::string_view prefix)
+{
+    constexpr std::string_view location = "Location: ";
+    if (strHeader.starts_with(location))
+    {
+        std::string header = strHeader.substr(location.size());
+        addPrefixToStringItem(header, prefix);
+        strHeader = std::string(location) + header;
+    }
+}
+
 // Fix HTTP headers which appear in responses from Task resources among others
 inline void addPrefixToHeadersInResp(nlohmann::json& json,
                                      std::string_view prefix)
@@ -347,13 +372,7 @@ inline void addPrefixToHeadersInResp(nlohmann::json& json,
             continue;
         }
 
-        constexpr std::string_view location = "Location: ";
-        if (strHeader->starts_with(location))
-        {
-            std::string header = strHeader->substr(location.size());
-            addPrefixToStringItem(header, prefix);
-            *strHeader = std::string(location) + header;
-        }
+        addPrefixToHeaderString(*strHeader, prefix);
     }
 }
 
@@ -396,6 +415,288 @@ inline void addPrefixes(nlohmann::json& json, std::string_view prefix)
     }
 }
 
+// Adds prefixes to the same URIs as addPrefixes(), while copying a json body
+// into its output, so that no json tree has to be built for it.  Keys and
+// strings are escaped, and the output indented, the way dump() writes them,
+// but members stay in the satellite's order rather than being sorted as they
+// are in a tree.  The http client has already read the whole body, so it's
+// rewritten from that buffer rather than as it arrives; what this saves is the
+// tree and serializing it again.
+class PrefixRewriteSax : public nlohmann::json::json_sax_t
+{
+  public:
+    PrefixRewriteSax(std::string_view prefixIn, int indentIn,
+                     std::string& outIn) :
+        prefix(prefixIn), indent(indentIn), out(outIn)
+    {}
+
+    bool null() override
+    {
+        startValue();
+        out += "null";
+        endValue(true);
+        return true;
+    }
+
+    bool boolean(bool val) override
+    {
+        startValue();
+        out += val ? "true" : "false";
+        endValue(false);
+        return true;
+    }
+
+    bool number_integer(std::int64_t val) override
+    {
+        startValue();
+        bmcweb::appendInteger(val, out);
+        endValue(false);
+        return true;
+    }
+
+    bool number_unsigned(std::uint64_t val) override
+    {
+        startValue();
+        bmcweb::appendInteger(val, out);
+        endValue(false);
+        return true;
+    }
+
+    bool number_float(double /*val*/, const std::string& s) override
+    {
+        // Copy the satellite's own formatting of the number
+        startValue();
+        out += s;
+        endValue(false);
+        return true;
+    }
+
+    bool string(std::string& val) override
+    {
+        Context context = startValue();
+        if (context == Context::Uri)
+        {
+            addPrefixToStringItem(val, prefix);
+        }
+        else if (context == Context::Header)
+        {
+            addPrefixToHeaderString(val, prefix);
+        }
+        out += '"';
+        bmcweb::escapeJsonString(val, out);
+        out += '"';
+        endValue(false);
+        return true;
+    }
+
+    bool start_object(std::size_t /*elements*/) override
+    {
+        Context context = startValue();
+        out += '{';
+        // Only the members of resources are searched; objects given as the
+        // value of a URI property or a header are copied as they are
+        frames.emplace_back(true, context == Context::Resource
+                                      ? Context::Resource
+                                      : Context::Verbatim);
+        return true;
+    }
+
+    bool end_object() override
+    {
+        endContainer('}');
+        return true;
+    }
+
+    bool start_array(std::size_t /*elements*/) override
+    {
+        Context context = startValue();
+        out += '[';
+        if (context != Context::Resource && context != Context::HttpHeaders)
+        {
+            context = Context::Verbatim;
+        }
+        frames.emplace_back(false, context);
+        return true;
+    }
+
+    bool end_array() override
+    {
+        endContainer(']');
+        return true;
+    }
+
+    bool key(std::string& val) override
+    {
+        Frame& frame = frames.back();
+        if (!frame.first)
+        {
+            out += ',';
+        }
+        frame.first = false;
+        writeNewline();
+        out += '"';
+        bmcweb::escapeJsonString(val, out);
+        out += indent < 0 ? "\":" : "\": ";
+
+        keyContext = Context::Verbatim;
+        if (frame.context == Context::Resource)
+        {
+            if (isPropertyUri(val))
+            {
+                keyContext = Context::Uri;
+            }
+            else if (val == "HttpHeaders")
+            {
+                keyContext = Context::HttpHeaders;
+            }
+            else
+            {
+                keyContext = Context::Resource;
+            }
+        }
+        return true;
+    }
+
+    bool binary(nlohmann::json::binary_t& /*val*/) override
+    {
+        return false;
+    }
+
+    bool parse_error(std::size_t position, const std::string& lastToken,
+                     const nlohmann::json::exception& ex) override
+    {
+        BMCWEB_LOG_WARNING(
+            "Stopped parsing at position {}. Last token: {}. Exception: {}",
+            position, lastToken, ex.what());
+        return false;
+    }
+
+    // Whether the body is null, or an empty object or array, which
+    // nlohmann::json::empty() is true for
+    bool empty() const
+    {
+        return rootEmpty;
+    }
+
+  private:
+    // How the value being written is treated
+    enum class Context
+    {
+        // Part of a resource, whose members are searched for URIs
+        Resource,
+        // The value of a URI property
+        Uri,
+        // The value of an "HttpHeaders" property
+        HttpHeaders,
+        // One of the headers in an "HttpHeaders" array
+        Header,
+        // Copied without changes
+        Verbatim,
+    };
+
+    struct Frame
+    {
+        Frame(bool objectIn, Context contextIn) :
+            object(objectIn), context(contextIn)
+        {}
+
+        bool object;
+        Context context;
+        bool first = true;
+    };
+
+    void writeNewline()
+    {
+        if (indent < 0)
+        {
+            return;
+        }
+        out += '\n';
+        out.append(static_cast<std::size_t>(indent) * frames.size(), ' ');
+    }
+
+    // Writes the separator before a value, and returns how it's treated
+    Context startValue()
+    {
+        if (frames.empty())
+        {
+            return Context::Resource;
+        }
+        Frame& frame = frames.back();
+        if (frame.object)
+        {
+            // The key already wrote the separator
+            return keyContext;
+        }
+        if (!frame.first)
+        {
+            out += ',';
+        }
+        frame.first = false;
+        writeNewline();
+        if (frame.context == Context::HttpHeaders)
+        {
+            return Context::Header;
+        }
+        return frame.context;
+    }
+
+    // Closes the innermost container; empty ones are written on one line
+    void endContainer(char close)
+    {
+        bool isEmpty = frames.back().first;
+        frames.pop_back();
+        if (!isEmpty)
+        {
+            writeNewline();
+        }
+        out += close;
+        endValue(isEmpty);
+    }
+
+    // Records that a value has been written in full
+    void endValue(bool isEmpty)
+    {
+        if (frames.empty())
+        {
+            rootEmpty = isEmpty;
+        }
+    }
+
+    std::string_view prefix;
+    int indent;
+    std::string& out;
+    std::vector<Frame> frames;
+    Context keyContext = Context::Resource;
+    bool rootEmpty = false;
+};
+
+// A satellite's json body with prefixes added by PrefixRewriteSax
+struct PrefixedBody
+{
+    std::string body;
+    // Whether the json tree is empty, in which case it gets no ETag
+    bool empty = false;
+};
+
+// Returns body with the supplied prefix added to every URI that addPrefixes()
+// would add it to, written with the given indent as dump() would write it, or
+// nullopt if body isn't valid json
+inline std::optional<PrefixedBody> addPrefixesToBody(std::string_view body,
+                                                     std::string_view prefix,
+                                                     int indent = -1)
+{
+    PrefixedBody prefixed;
+    prefixed.body.reserve(body.size() + body.size() / 8);
+    PrefixRewriteSax sax(prefix, indent, prefixed.body);
+    if (!nlohmann::json::sax_parse(body, &sax))
+    {
+        return std::nullopt;
+    }
+    prefixed.empty = sax.empty();
+    return prefixed;
+}
+
 inline boost::system::error_code aggregationRetryHandler(unsigned int respCode)
 {
     // Allow all response codes because we want to surface any satellite
@@ -421,11 +722,303 @@ struct AggregationSource
     std::string password;
 };
 
+// The satellite config objects EntityManager has, by object path.  Filled
+// from GetManagedObjects once, then kept current from the InterfacesAdded,
+// InterfacesRemoved and PropertiesChanged signals of the inventory, so that
+// aggregated requests don't each fetch the whole inventory.
+class SatelliteConfigCache
+{
+  public:
+    using Configs =
+        boost::container::flat_map<std::string,
+                                   dbus::utility::DBusPropertiesMap,
+                                   std::less<>>;
+
+    static constexpr std::string_view interface =
+        "xyz.openbmc_project.Configuration.SatelliteController";
+
+    // Replaces the cached configs with those in objects
+    void insert(const dbus::utility::ManagedObjectType& objects)
+    {
+        configs.clear();
+        for (const auto& [path, interfaces] : objects)
+        {
+            interfacesAdded(path.str, interfaces);
+        }
+    }
+
+    void interfacesAdded(const std::string& path,
+                         const dbus::utility::DBusInterfacesMap& interfaces)
+    {
+        for (const auto& [name, properties] : interfaces)
+        {
+            if (name == interface)
+            {
+                configs.insert_or_assign(path, properties);
+            }
+        }
+    }
+
+    void interfacesRemoved(const std::string& path,
+                           const std::vector<std::string>& interfaces)
+    {
+        if (std::ranges::find(interfaces, interface) != interfaces.end())
+        {
+            configs.erase(path);
+        }
+    }
+
+    void propertiesChanged(const std::string& path,
+                           std::string_view changedInterface,
+                           const dbus::utility::DBusPropertiesMap& changed)
+    {
+        if (changedInterface != interface)
+        {
+            return;
+        }
+        auto config = configs.find(path);
+        if (config == configs.end())
+        {
+            return;
+        }
+        for (const auto& [name, value] : changed)
+        {
+            auto property = std::ranges::find(
+                config->second, name,
+                &std::pair<std::string, dbus::utility::DbusVariantType>::first);
+            if (property == config->second.end())
+            {
+                config->second.emplace_back(name, value);
+            }
+            else
+            {
+                property->second = value;
+            }
+        }
+    }
+
+    void clear()
+    {
+        configs.clear();
+    }
+
+    const Configs& get() const
+    {
+        return configs;
+    }
+
+  private:
+    Configs configs;
+};
+
 class RedfishAggregator
 {
   private:
+    using SatelliteConfigHandler = std::function<void(
+        const std::unordered_map<std::string, boost::urls::url>&)>;
+
     crow::HttpClient client;
 
+    SatelliteConfigCache satelliteConfigs;
+    // satelliteConfigs holds everything EntityManager has, and is kept
+    // current from its signals
+    bool satelliteConfigsLoaded = false;
+    // Changes whenever EntityManager changes owner, so that a fetch started
+    // before that isn't cached
+    uint64_t satelliteConfigsGeneration = 0;
+    // Waiting for the fetch in flight
+    std::vector<SatelliteConfigHandler> satelliteConfigHandlers;
+    std::vector<std::unique_ptr<sdbusplus::match>> satelliteConfigMatches;
+
+    // Maps a chosen alias representing a satellite BMC to a url containing
+    // the information required to create a http connection to the satellite
+    std::unordered_map<std::string, boost::urls::url> getSatelliteInfo() const
+    {
+        // Extract just the URLs from aggregationSources
+        std::unordered_map<std::string, boost::urls::url> satelliteInfo;
+        for (const auto& [prefix, source] : aggregationSources)
+        {
+            satelliteInfo.emplace(prefix, source.url);
+        }
+        findSatelliteConfigs(satelliteConfigs.get(), satelliteInfo);
+        return satelliteInfo;
+    }
+
+    // Applies change to satelliteConfigs, and bumps the generation only if
+    // that changed the satellites requests are routed to.  Most signals from
+    // the inventory are about other configs, and a refetch usually finds
+    // what was already there.
+    template <typename Change>
+    void changeSatelliteConfigs(Change&& change)
+    {
+        std::unordered_map<std::string, boost::urls::url> before =
+            getSatelliteInfo();
+        std::forward<Change>(change)();
+        if (getSatelliteInfo() != before)
+        {
+            generation.bump();
+        }
+    }
+
+    void fetchSatelliteConfigs()
+    {
+        BMCWEB_LOG_DEBUG("Gathering satellite configs");
+        registerSatelliteConfigSignals();
+
+        sdbusplus::object_path path("/xyz/openbmc_project/inventory");
+        dbus::utility::getManagedObjects(
+            "xyz.openbmc_project.EntityManager", path,
+            [this, fetchGeneration{satelliteConfigsGeneration}](
+                const boost::system::error_code& ec,
+                const dbus::utility::ManagedObjectType& objects) {
+                if (ec)
+                {
+                    // Left unloaded, so the next request tries again
+                    BMCWEB_LOG_WARNING("DBUS response error {}, {}", ec.value(),
+                                       ec.message());
+                }
+                else if (fetchGeneration == satelliteConfigsGeneration)
+                {
+                    changeSatelliteConfigs([this, &objects]() {
+                        satelliteConfigs.insert(objects);
+                    });
+                    satelliteConfigsLoaded = true;
+                }
+
+                std::unordered_map<std::string, boost::urls::url>
+                    satelliteInfo = getSatelliteInfo();
+                if (!satelliteInfo.empty())
+                {
+                    BMCWEB_LOG_DEBUG(
+                        "Redfish Aggregation enabled with {} satellite BMCs",
+                        std::to_string(satelliteInfo.size()));
+                }
+                else
+                {
+                    BMCWEB_LOG_DEBUG(
+                        "Redfish aggregation enabled, but no satellite BMCs detected");
+                }
+                std::vector<SatelliteConfigHandler> handlers =
+                    std::move(satelliteConfigHandlers);
+                satelliteConfigHandlers.clear();
+                for (SatelliteConfigHandler& handler : handlers)
+                {
+                    handler(satelliteInfo);
+                }
+            });
+    }
+
+    // EntityManager went away or was replaced, so its configs are fetched
+    // again by the next request
+    void satelliteConfigsOwnerChanged()
+    {
+        BMCWEB_LOG_DEBUG("EntityManager changed owner, dropping satellite "
+                         "configs");
+        changeSatelliteConfigs([this]() { satelliteConfigs.clear(); });
+        satelliteConfigsLoaded = false;
+        satelliteConfigsGeneration++;
+    }
+
+    static void onSatelliteConfigsChanged(sdbusplus::message_t& msg)
+    {
+        std::string interface;
+        dbus::utility::DBusPropertiesMap changed;
+        try
+        {
+            msg.read(interface, changed);
+        }
+        catch (const sdbusplus::exception_t& e)
+        {
+            BMCWEB_LOG_ERROR("Failed to read PropertiesChanged signal: {}",
+                             e.what());
+            return;
+        }
+        RedfishAggregator& self = getInstance();
+        self.changeSatelliteConfigs([&self, &msg, &interface, &changed]() {
+            self.satelliteConfigs.propertiesChanged(msg.get_path(), interface,
+                                                    changed);
+        });
+    }
+
+    static void onSatelliteConfigsAdded(sdbusplus::message_t& msg)
+    {
+        sdbusplus::object_path path;
+        dbus::utility::DBusInterfacesMap interfaces;
+        try
+        {
+            msg.read(path, interfaces);
+        }
+        catch (const sdbusplus::exception_t& e)
+        {
+            BMCWEB_LOG_ERROR("Failed to read InterfacesAdded signal: {}",
+                             e.what());
+            return;
+        }
+        RedfishAggregator& self = getInstance();
+        self.changeSatelliteConfigs([&self, &path, &interfaces]() {
+            self.satelliteConfigs.interfacesAdded(path.str, interfaces);
+        });
+    }
+
+    static void onSatelliteConfigsRemoved(sdbusplus::message_t& msg)
+    {
+        sdbusplus::object_path path;
+        std::vector<std::string> interfaces;
+        try
+        {
+            msg.read(path, interfaces);
+        }
+        catch (const sdbusplus::exception_t& e)
+        {
+            BMCWEB_LOG_ERROR("Failed to read InterfacesRemoved signal: {}",
+                             e.what());
+            return;
+        }
+        RedfishAggregator& self = getInstance();
+        self.changeSatelliteConfigs([&self, &path, &interfaces]() {
+            self.satelliteConfigs.interfacesRemoved(path.str, interfaces);
+        });
+    }
+
+    static void onEntityManagerOwnerChanged(sdbusplus::message_t& /*msg*/)
+    {
+        getInstance().satelliteConfigsOwnerChanged();
+    }
+
+    // Registered before the first fetch, so no change made after a fetch
+    // can be missed
+    void registerSatelliteConfigSignals()
+    {
+        if (!satelliteConfigMatches.empty())
+        {
+            return;
+        }
+        namespace rules = sdbusplus::match_rules;
+        const std::string inventoryPath = "/xyz/openbmc_project/inventory";
+        satelliteConfigMatches.emplace_back(std::make_unique<sdbusplus::match>(
+            *crow::connections::systemBus,
+            rules::propertiesChangedNamespace(
+                inventoryPath, std::string(SatelliteConfigCache::interface)),
+            onSatelliteConfigsChanged));
+        satelliteConfigMatches.emplace_back(std::make_unique<sdbusplus::match>(
+            *crow::connections::systemBus,
+            rules::type::signal() + rules::member("InterfacesAdded") +
+                rules::interface("org.freedesktop.DBus.ObjectManager") +
+                rules::argNpath(0, inventoryPath + "/"),
+            onSatelliteConfigsAdded));
+        satelliteConfigMatches.emplace_back(std::make_unique<sdbusplus::match>(
+            *crow::connections::systemBus,
+            rules::type::signal() + rules::member("InterfacesRemoved") +
+                rules::interface("org.freedesktop.DBus.ObjectManager") +
+                rules::argNpath(0, inventoryPath + "/"),
+            onSatelliteConfigsRemoved));
+        satelliteConfigMatches.emplace_back(std::make_unique<sdbusplus::match>(
+            *crow::connections::systemBus,
+            rules::nameOwnerChanged() +
+                rules::argN(0, "xyz.openbmc_project.EntityManager"),
+            onEntityManagerOwnerChanged));
+    }
+
     // Dummy callback used by the Constructor so that it can report the number
     // of satellite configs when the class is first created
     static void constructorCallback(
@@ -435,34 +1028,25 @@ class RedfishAggregator
                          std::to_string(satelliteInfo.size()));
     }
 
-    // Search D-Bus objects for satellite config objects and add their
-    // information if valid
+    // Add the information of the cached satellite config objects if valid
     static void findSatelliteConfigs(
-        const dbus::utility::ManagedObjectType& objects,
+        const SatelliteConfigCache::Configs& configs,
         std::unordered_map<std::string, boost::urls::url>& satelliteInfo)
     {
-        for (const auto& objectPath : objects)
+        for (const auto& [path, properties] : configs)
         {
-            for (const auto& interface : objectPath.second)
+            BMCWEB_LOG_DEBUG("Found Satellite Controller at {}", path);
+
+            if (!satelliteInfo.empty())
             {
-                if (interface.first ==
-                    "xyz.openbmc_project.Configuration.SatelliteController")
-                {
-                    BMCWEB_LOG_DEBUG("Found Satellite Controller at {}",
-                                     objectPath.first.str);
-
-                    if (!satelliteInfo.empty())
-                    {
-                        BMCWEB_LOG_ERROR(
-                            "Redfish Aggregation only supports one satellite!");
-                        BMCWEB_LOG_DEBUG("Clearing all satellite data");
-                        satelliteInfo.clear();
-                        return;
-                    }
-
-                    addSatelliteConfig(interface.second, satelliteInfo);
-                }
+                BMCWEB_LOG_ERROR(
+                    "Redfish Aggregation only supports one satellite!");
+                BMCWEB_LOG_DEBUG("Clearing all satellite data");
+                satelliteInfo.clear();
+                return;
             }
+
+            addSatelliteConfig(properties, satelliteInfo);
         }
     }
 
@@ -609,6 +1193,13 @@ class RedfishAggregator
             }
         }
 
+        if (aggType != AggregationType::Resource)
+        {
+            // The satellites add to what the local handler builds, and
+            // nothing here knows when their data changes
+            asyncResp->res.ignoreGenerations();
+        }
+
         std::error_code ec;
         // Create a filtered copy of the request
         auto localReq =
@@ -801,6 +1392,12 @@ class RedfishAggregator
 
         std::function<void(crow::Response&)> cb =
             std::bind_front(processResponse, prefix, asyncResp);
+        std::optional<int> indent = getStreamedResponseIndent(thisReq);
+        if (indent)
+        {
+            cb = std::bind_front(processStreamedResponse, prefix, *indent,
+                                 asyncResp);
+        }
 
         std::string data = thisReq.body();
         boost::urls::url url(sat->second);
@@ -901,6 +1498,9 @@ class RedfishAggregator
     // Aggregation sources with their URLs and optional credentials
     std::unordered_map<std::string, AggregationSource> aggregationSources;
 
+    // Bumped whenever aggregationSources or the satellite configs change
+    crow::ResourceGeneration generation;
+
     // Helper function to prepare headers for aggregated satellite BMC requests
     boost::beast::http::fields prepareAggregationHeaders(
         const boost::beast::http::fields& originalFields,
@@ -928,55 +1528,28 @@ class RedfishAggregator
         return fields;
     }
 
-    // Polls D-Bus to get all available satellite config information
-    // Expects a handler which interacts with the returned configs
-    void getSatelliteConfigs(
-        std::function<
-            void(const std::unordered_map<std::string, boost::urls::url>&)>
-            handler) const
+    // Calls handler with all available satellite config information.  The
+    // configs from EntityManager are fetched the first time, and kept current
+    // from its signals after that.  handler is never called before this
+    // returns.
+    void getSatelliteConfigs(SatelliteConfigHandler handler)
     {
-        BMCWEB_LOG_DEBUG("Gathering satellite configs");
-
-        // Extract just the URLs from aggregationSources for the handler
-        std::unordered_map<std::string, boost::urls::url> satelliteInfo;
-        for (const auto& [prefix, source] : aggregationSources)
+        if (satelliteConfigsLoaded)
         {
-            satelliteInfo.emplace(prefix, source.url);
+            boost::asio::post(getIoContext(),
+                              [handler{std::move(handler)},
+                               satelliteInfo{getSatelliteInfo()}]() {
+                                  handler(satelliteInfo);
+                              });
+            return;
         }
-
-        sdbusplus::object_path path("/xyz/openbmc_project/inventory");
-        dbus::utility::getManagedObjects(
-            "xyz.openbmc_project.EntityManager", path,
-            [handler{std::move(handler)},
-             satelliteInfo = std::move(satelliteInfo)](
-                const boost::system::error_code& ec,
-                const dbus::utility::ManagedObjectType& objects) mutable {
-                if (ec)
-                {
-                    BMCWEB_LOG_WARNING("DBUS response error {}, {}", ec.value(),
-                                       ec.message());
-                }
-                else
-                {
-                    // Maps a chosen alias representing a satellite BMC to a url
-                    // containing the information required to create a http
-                    // connection to the satellite
-                    findSatelliteConfigs(objects, satelliteInfo);
-
-                    if (!satelliteInfo.empty())
-                    {
-                        BMCWEB_LOG_DEBUG(
-                            "Redfish Aggregation enabled with {} satellite BMCs",
-                            std::to_string(satelliteInfo.size()));
-                    }
-                    else
-                    {
-                        BMCWEB_LOG_DEBUG(
-                            "Redfish aggregation enabled, but no satellite BMCs detected");
-                    }
-                }
-                handler(satelliteInfo);
-            });
+        satelliteConfigHandlers.emplace_back(std::move(handler));
+        if (satelliteConfigHandlers.size() > 1)
+        {
+            // A fetch is already in flight
+            return;
+        }
+        fetchSatelliteConfigs();
     }
 
     // Processes the response returned by a satellite BMC and loads its
@@ -1029,6 +1602,81 @@ class RedfishAggregator
         addAggregatedHeaders(asyncResp->res, resp, prefix);
     }
 
+    // Returns the indent the response to a forwarded request is written with
+    // if it can be written straight to the client without a json tree, or
+    // nullopt if it can't.  The tree is needed when query parameters are
+    // applied to it, and when it's sent as something other than json.
+    static std::optional<int> getStreamedResponseIndent(
+        const crow::Request& thisReq)
+    {
+        if (!thisReq.url().params().empty())
+        {
+            return std::nullopt;
+        }
+        using http_helpers::ContentType;
+        std::array<ContentType, 3> allowed{ContentType::CBOR, ContentType::JSON,
+                                           ContentType::HTML};
+        std::string_view accepts =
+            thisReq.getHeaderValue(boost::beast::http::field::accept);
+        ContentType preferred =
+            http_helpers::getPreferredContentType(accepts, allowed);
+        if (preferred == ContentType::CBOR || preferred == ContentType::HTML)
+        {
+            return std::nullopt;
+        }
+        return http_helpers::getResponseJsonIndent(accepts, preferred);
+    }
+
+    // Processes the response returned by a satellite BMC like
+    // processResponse(), but adds the prefixes while copying the body instead
+    // of parsing it into asyncResp's json
+    static void processStreamedResponse(
+        std::string_view prefix, int indent,
+        const std::shared_ptr<bmcweb::AsyncResp>& asyncResp,
+        crow::Response& resp)
+    {
+        if ((resp.result() == boost::beast::http::status::too_many_requests) ||
+            (resp.result() == boost::beast::http::status::bad_gateway) ||
+            !isJsonContentType(resp.getHeaderValue("Content-Type")))
+        {
+            processResponse(prefix, asyncResp, resp);
+            return;
+        }
+
+        std::optional<PrefixedBody> prefixed =
+            addPrefixesToBody(*resp.body(), prefix, indent);
+        if (!prefixed)
+        {
+            BMCWEB_LOG_ERROR("Error parsing satellite response as JSON");
+            messages::operationFailed(asyncResp->res);
+            return;
+        }
+        BMCWEB_LOG_DEBUG("Added prefix to satellite response");
+
+        asyncResp->res.result(resp.result());
+        // The indent was picked from Accept
+        asyncResp->res.addHeader(boost::beast::http::field::vary, "Accept");
+        // The ETag is over the bytes sent, as the members aren't in the order
+        // a tree would have them in
+        if (resp.result() == boost::beast::http::status::ok &&
+            !prefixed->empty)
+        {
+            std::string etag = std::format(
+                "\"{:08X}\"", std::hash<std::string_view>{}(prefixed->body));
+            asyncResp->res.addHeader(boost::beast::http::field::etag, etag);
+            std::optional<std::string_view> ifNoneMatch =
+                asyncResp->res.getExpectedEtag();
+            if (ifNoneMatch &&
+                http_helpers::ifNoneMatchMatches(*ifNoneMatch, etag))
+            {
+                prefixed->body.clear();
+                asyncResp->res.result(boost::beast::http::status::not_modified);
+            }
+        }
+        asyncResp->res.write(std::move(prefixed->body));
+        addAggregatedHeaders(asyncResp->res, resp, prefix);
+    }
+
     // Processes the collection response returned by a satellite BMC and merges
     // its "@odata.id" values
     static void processCollectionResponse(
@@ -0,0 +1,444 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+#pragma once
+
+#include "dbus_singleton.hpp"
+#include "dbus_utility.hpp"
+#include "io_context_singleton.hpp"
+#include "logging.hpp"
+
+#include <boost/asio/post.hpp>
+#include <boost/container/flat_map.hpp>
+#include <boost/system/error_code.hpp>
+#include <sdbusplus/bus/match.hpp>
+#include <sdbusplus/exception.hpp>
+#include <sdbusplus/message.hpp>
+#include <sdbusplus/message/native_types.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace redfish
+{
+
+// Keeps the sensor objects of every service that provides sensors, as
+// returned by GetManagedObjects, and keeps them current from the
+// PropertiesChanged, InterfacesAdded and InterfacesRemoved signals those
+// services emit.  Sensor requests read from here rather than each fetching
+// every sensor of every service.
+class SensorObjectCache
+{
+  public:
+    using Clock = std::chrono::steady_clock;
+    using Callback =
+        std::function<void(const boost::system::error_code&,
+                           const dbus::utility::ManagedObjectType&)>;
+
+    struct Stats
+    {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+    };
+
+    static constexpr std::string_view sensorsPath =
+        "/xyz/openbmc_project/sensors";
+
+    // Services are fetched again after this long, in case a change was made
+    // without a signal
+    static constexpr std::chrono::seconds maxAge{60};
+
+    static SensorObjectCache& getInstance()
+    {
+        static SensorObjectCache cache;
+        return cache;
+    }
+
+    // Calls callback with the sensor objects of connection, fetching them if
+    // they aren't cached.  callback is never called before this returns.
+    void getManagedObjects(const std::string& connection, Callback&& callback)
+    {
+        std::shared_ptr<const dbus::utility::ManagedObjectType> objects =
+            find(connection);
+        if (objects != nullptr)
+        {
+            stats.hits++;
+            boost::asio::post(getIoContext(),
+                              [callback = std::move(callback), objects]() {
+                                  callback(boost::system::error_code(),
+                                           *objects);
+                              });
+            return;
+        }
+
+        auto inflight = pending.find(connection);
+        if (inflight != pending.end())
+        {
+            inflight->second->callbacks.emplace_back(std::move(callback));
+            return;
+        }
+        stats.misses++;
+        std::shared_ptr<Inflight> request = std::make_shared<Inflight>();
+        request->callbacks.emplace_back(std::move(callback));
+        pending.emplace(connection, request);
+        fetch(connection, request);
+    }
+
+    // Returns the cached objects of connection, or nullptr
+    std::shared_ptr<const dbus::utility::ManagedObjectType> find(
+        const std::string& connection, Clock::time_point now = Clock::now())
+    {
+        auto service = services.find(connection);
+        if (service == services.end())
+        {
+            return nullptr;
+        }
+        if (now - service->second.fetched >= maxAge)
+        {
+            services.erase(service);
+            return nullptr;
+        }
+        return service->second.objects;
+    }
+
+    // Caches objects as the sensors of connection, whose unique bus name is
+    // owner
+    void insert(const std::string& connection, const std::string& owner,
+                dbus::utility::ManagedObjectType&& objects,
+                Clock::time_point now = Clock::now())
+    {
+        std::ranges::sort(objects, std::less<>(), objectPath);
+        Service& service = services[connection];
+        service.owner = owner;
+        service.fetched = now;
+        service.objects = std::make_shared<dbus::utility::ManagedObjectType>(
+            std::move(objects));
+    }
+
+    void propertiesChanged(std::string_view sender, const std::string& path,
+                           const std::string& interface,
+                           const dbus::utility::DBusPropertiesMap& changed)
+    {
+        dbus::utility::ManagedObjectType* objects = findBySender(sender);
+        if (objects == nullptr)
+        {
+            return;
+        }
+        auto object = findObject(*objects, path);
+        if (object == objects->end())
+        {
+            return;
+        }
+        auto properties = std::ranges::find(
+            object->second, interface,
+            &std::pair<std::string, dbus::utility::DBusPropertiesMap>::first);
+        if (properties == object->second.end())
+        {
+            return;
+        }
+        for (const auto& [name, value] : changed)
+        {
+            auto property = std::ranges::find(
+                properties->second, name,
+                &std::pair<std::string, dbus::utility::DbusVariantType>::first);
+            if (property == properties->second.end())
+            {
+                properties->second.emplace_back(name, value);
+            }
+            else
+            {
+                property->second = value;
+            }
+        }
+    }
+
+    void interfacesAdded(std::string_view sender, const std::string& path,
+                         const dbus::utility::DBusInterfacesMap& interfaces)
+    {
+        dbus::utility::ManagedObjectType* objects = findBySender(sender);
+        if (objects == nullptr)
+        {
+            return;
+        }
+        auto object = findObject(*objects, path);
+        if (object == objects->end())
+        {
+            object = objects->emplace(
+                std::ranges::lower_bound(*objects, path, std::less<>(),
+                                         objectPath),
+                sdbusplus::object_path(path),
+                dbus::utility::DBusInterfacesMap());
+        }
+        for (const auto& added : interfaces)
+        {
+            auto existing = std::ranges::find(
+                object->second, added.first,
+                &std::pair<std::string,
+                           dbus::utility::DBusPropertiesMap>::first);
+            if (existing == object->second.end())
+            {
+                object->second.emplace_back(added);
+            }
+            else
+            {
+                existing->second = added.second;
+            }
+        }
+    }
+
+    void interfacesRemoved(std::string_view sender, const std::string& path,
+                           const std::vector<std::string>& interfaces)
+    {
+        dbus::utility::ManagedObjectType* objects = findBySender(sender);
+        if (objects == nullptr)
+        {
+            return;
+        }
+        auto object = findObject(*objects, path);
+        if (object == objects->end())
+        {
+            return;
+        }
+        std::erase_if(object->second, [&interfaces](const auto& interface) {
+            return std::ranges::find(interfaces, interface.first) !=
+                   interfaces.end();
+        });
+        if (object->second.empty())
+        {
+            objects->erase(object);
+        }
+    }
+
+    // The service with this well known name went away or was replaced
+    void ownerChanged(std::string_view name)
+    {
+        auto service = services.find(name);
+        if (service != services.end())
+        {
+            BMCWEB_LOG_DEBUG("Dropping cached sensors of {}", name);
+            services.erase(service);
+        }
+        auto inflight = pending.find(name);
+        if (inflight != pending.end())
+        {
+            inflight->second->stale = true;
+            pending.erase(inflight);
+        }
+    }
+
+    const Stats& getStats() const
+    {
+        return stats;
+    }
+
+  private:
+    struct Service
+    {
+        std::string owner;
+        Clock::time_point fetched;
+        std::shared_ptr<dbus::utility::ManagedObjectType> objects;
+    };
+
+    struct Inflight
+    {
+        std::vector<Callback> callbacks;
+        // The service changed owner during the fetch
+        bool stale = false;
+    };
+
+    static const std::string& objectPath(
+        const std::pair<sdbusplus::object_path,
+                        dbus::utility::DBusInterfacesMap>& object)
+    {
+        return object.first.str;
+    }
+
+    static dbus::utility::ManagedObjectType::iterator findObject(
+        dbus::utility::ManagedObjectType& objects, const std::string& path)
+    {
+        auto object =
+            std::ranges::lower_bound(objects, path, std::less<>(), objectPath);
+        if (object == objects.end() || object->first.str != path)
+        {
+            return objects.end();
+        }
+        return object;
+    }
+
+    dbus::utility::ManagedObjectType* findBySender(std::string_view sender)
+    {
+        for (auto& service : services)
+        {
+            if (service.second.owner == sender)
+            {
+                return service.second.objects.get();
+            }
+        }
+        return nullptr;
+    }
+
+    void fetch(const std::string& connection,
+               const std::shared_ptr<Inflight>& request)
+    {
+        registerSignals();
+        // Signals carry the sender's unique name, so look that up first
+        dbus::utility::async_method_call(
+            [this, connection, request](const boost::system::error_code& ec,
+                                        const std::string& owner) {
+                if (ec)
+                {
+                    BMCWEB_LOG_ERROR("Failed to get owner of {}: {}",
+                                     connection, ec);
+                    finish(connection, *request, ec, {});
+                    return;
+                }
+                dbus::utility::getManagedObjects(
+                    connection,
+                    sdbusplus::object_path(std::string(sensorsPath)),
+                    [this, connection, owner,
+                     request](const boost::system::error_code& ec2,
+                              const dbus::utility::ManagedObjectType& objects) {
+                        if (!ec2 && !request->stale)
+                        {
+                            dbus::utility::ManagedObjectType copy = objects;
+                            insert(connection, owner, std::move(copy));
+                        }
+                        finish(connection, *request, ec2, objects);
+                    });
+            },
+            "org.freedesktop.DBus", "/org/freedesktop/DBus",
+            "org.freedesktop.DBus", "GetNameOwner", connection);
+    }
+
+    void finish(const std::string& connection, Inflight& request,
+                const boost::system::error_code& ec,
+                const dbus::utility::ManagedObjectType& objects)
+    {
+        if (!request.stale)
+        {
+            pending.erase(connection);
+        }
+        std::vector<Callback> callbacks = std::move(request.callbacks);
+        for (Callback& callback : callbacks)
+        {
+            callback(ec, objects);
+        }
+    }
+
+    static void onPropertiesChanged(sdbusplus::message_t& msg)
+    {
+        std::string interface;
+        dbus::utility::DBusPropertiesMap changed;
+        try
+        {
+            msg.read(interface, changed);
+        }
+        catch (const sdbusplus::exception_t& e)
+        {
+            BMCWEB_LOG_ERROR("Failed to read PropertiesChanged signal: {}",
+                             e.what());
+            return;
+        }
+        getInstance().propertiesChanged(msg.get_sender(), msg.get_path(),
+                                        interface, changed);
+    }
+
+    static void onInterfacesAdded(sdbusplus::message_t& msg)
+    {
+        sdbusplus::object_path path;
+        dbus::utility::DBusInterfacesMap interfaces;
+        try
+        {
+            msg.read(path, interfaces);
+        }
+        catch (const sdbusplus::exception_t& e)
+        {
+            BMCWEB_LOG_ERROR("Failed to read InterfacesAdded signal: {}",
+                             e.what());
+            return;
+        }
+        getInstance().interfacesAdded(msg.get_sender(), path.str, interfaces);
+    }
+
+    static void onInterfacesRemoved(sdbusplus::message_t& msg)
+    {
+        sdbusplus::object_path path;
+        std::vector<std::string> interfaces;
+        try
+        {
+            msg.read(path, interfaces);
+        }
+        catch (const sdbusplus::exception_t& e)
+        {
+            BMCWEB_LOG_ERROR("Failed to read InterfacesRemoved signal: {}",
+                             e.what());
+            return;
+        }
+        getInstance().interfacesRemoved(msg.get_sender(), path.str,
+                                        interfaces);
+    }
+
+    static void onNameOwnerChanged(sdbusplus::message_t& msg)
+    {
+        std::string name;
+        try
+        {
+            msg.read(name);
+        }
+        catch (const sdbusplus::exception_t& e)
+        {
+            BMCWEB_LOG_ERROR("Failed to read NameOwnerChanged signal: {}",
+                             e.what());
+            return;
+        }
+        getInstance().ownerChanged(name);
+    }
+
+    // Registered before the first fetch, so no change made after a fetch
+    // can be missed
+    void registerSignals()
+    {
+        if (!matches.empty())
+        {
+            return;
+        }
+        namespace rules = sdbusplus::match_rules;
+        std::string objectsUnder = std::string(sensorsPath) + "/";
+        matches.emplace_back(std::make_unique<sdbusplus::match>(
+            *crow::connections::systemBus,
+            rules::type::signal() + rules::member("PropertiesChanged") +
+                rules::interface("org.freedesktop.DBus.Properties") +
+                rules::path_namespace(std::string(sensorsPath)),
+            onPropertiesChanged));
+        matches.emplace_back(std::make_unique<sdbusplus::match>(
+            *crow::connections::systemBus,
+            rules::type::signal() + rules::member("InterfacesAdded") +
+                rules::interface("org.freedesktop.DBus.ObjectManager") +
+                rules::argNpath(0, objectsUnder),
+            onInterfacesAdded));
+        matches.emplace_back(std::make_unique<sdbusplus::match>(
+            *crow::connections::systemBus,
+            rules::type::signal() + rules::member("InterfacesRemoved") +
+                rules::interface("org.freedesktop.DBus.ObjectManager") +
+                rules::argNpath(0, objectsUnder),
+            onInterfacesRemoved));
+        matches.emplace_back(std::make_unique<sdbusplus::match>(
+            *crow::connections::systemBus, rules::nameOwnerChanged(),
+            onNameOwnerChanged));
+    }
+
+    Stats stats;
+    boost::container::flat_map<std::string, Service, std::less<>> services;
+    boost::container::flat_map<std::string, std::shared_ptr<Inflight>,
+                               std::less<>>
+        pending;
+    std::vector<std::unique_ptr<sdbusplus::match>> matches;
+};
+
+} // namespace redfish
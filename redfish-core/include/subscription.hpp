@@ -5,7 +5,7 @@
 
 #include "event_logs_object_type.hpp"
 #include "event_service_store.hpp"
-#include "filter_expr_parser_ast.hpp"
+#include "filter_expr_executor.hpp"
 #include "http_client.hpp"
 #include "http_response.hpp"
 #include "server_sent_event.hpp"
@@ -60,6 +60,7 @@ class Subscription : public std::enable_shared_from_this<Subscription>
     // callback for subscription sendData
     void resHandler(const std::shared_ptr<Subscription>& /*self*/,
                     const crow::Response& res);
+    void onRetriesExhausted(const std::shared_ptr<Subscription>& /*self*/);
 
     void sendHeartbeatEvent();
     void scheduleNextHeartbeatEvent();
@@ -69,12 +70,36 @@ class Subscription : public std::enable_shared_from_this<Subscription>
 
     bool sendEventToSubscriber(uint64_t eventId, std::string&& msg);
 
+    // Sends a message that may also be going to other subscribers; the
+    // buffer is shared with them rather than copied
+    bool sendEventToSubscriber(uint64_t eventId,
+                               const std::shared_ptr<const std::string>& msg);
+
     void filterAndSendEventLogs(
         uint64_t eventId, const std::vector<EventLogObjectsType>& eventRecords);
 
+    // Builds the message filterAndSendEventLogs() would send, advancing
+    // eventId past the entries in it.  Returns nullptr if no entry matched.
+    std::shared_ptr<const std::string> filterEventLogs(
+        uint64_t& eventId,
+        const std::vector<EventLogObjectsType>& eventRecords) const;
+
+    // Subscriptions with the same key are sent identical event log messages,
+    // so one message can be built for all of them.  Returns nullopt when that
+    // can't be known, because a $filter is set.
+    std::optional<std::string> eventLogsKey() const;
+
     void filterAndSendReports(uint64_t eventId, const std::string& reportId,
                               const telemetry::TimestampReadings& var);
 
+    bool reportMatches(const std::string& reportId) const;
+
+    // Builds the message filterAndSendReports() would send, or nullptr if the
+    // report couldn't be filled.  Depends only on the report and Context.
+    std::shared_ptr<const std::string> makeReport(
+        const std::string& reportId,
+        const telemetry::TimestampReadings& var) const;
+
     void updateRetryConfig(uint32_t retryAttempts,
                            uint32_t retryTimeoutInterval);
 
@@ -93,10 +118,11 @@ class Subscription : public std::enable_shared_from_this<Subscription>
     crow::sse_socket::Connection* sseConn = nullptr;
 
     boost::asio::steady_timer hbTimer;
-    std::optional<crow::HttpClient> client;
+    // Shared with other subscriptions; null for SSE subscriptions
+    crow::HttpClient* client = nullptr;
 
   public:
-    std::optional<filter_ast::LogicalAnd> filter;
+    std::optional<CompiledFilter> filter;
 };
 
 } // namespace redfish
@@ -4,6 +4,7 @@
 
 #include "async_resp.hpp"
 #include "dbus_singleton.hpp"
+#include "dbus_utility.hpp"
 #include "logging.hpp"
 
 #include <nlohmann/json.hpp>
@@ -65,8 +66,11 @@ void setDbusProperty(
         *crow::connections::systemBus, processNameStr, path.str, interfaceStr,
         dbusPropertyStr, prop,
         [asyncResp, redfishPropertyNameStr = std::string{redfishPropertyName},
-         jsonProp = nlohmann::json(prop)](const boost::system::error_code& ec,
-                                          const sdbusplus::message_t& msg) {
+         jsonProp = nlohmann::json(prop), pathStr = path.str,
+         interfaceStr](const boost::system::error_code& ec,
+                       const sdbusplus::message_t& msg) {
+            // For services that don't signal PropertiesChanged
+            dbus::utility::propertiesWritten(pathStr, interfaceStr);
             details::afterSetProperty(asyncResp, redfishPropertyNameStr,
                                       jsonProp, ec, msg);
         });
@@ -90,9 +94,11 @@ void setDbusPropertyAction(
         [asyncResp,
          redfishActionParameterName = std::string{redfishActionParameterName},
          jsonProp = nlohmann::json(prop),
-         redfishActionNameStr = std::string{redfishActionName}](
-            const boost::system::error_code& ec,
-            const sdbusplus::message_t& msg) {
+         redfishActionNameStr = std::string{redfishActionName},
+         pathStr = path.str,
+         interfaceStr](const boost::system::error_code& ec,
+                       const sdbusplus::message_t& msg) {
+            dbus::utility::propertiesWritten(pathStr, interfaceStr);
             details::afterSetPropertyAction(asyncResp, redfishActionNameStr,
                                             redfishActionParameterName, ec,
                                             msg);
@@ -7,6 +7,7 @@
 #include "dbus_utility.hpp"
 #include "error_messages.hpp"
 #include "event_log.hpp"
+#include "event_log_index.hpp"
 #include "generated/enums/log_service.hpp"
 #include "http_response.hpp"
 #include "logging.hpp"
@@ -17,6 +18,7 @@
 #include "utils/log_services_utils.hpp"
 #include "utils/query_param.hpp"
 #include "utils/time_utils.hpp"
+#include "worker_pool.hpp"
 
 #include <boost/beast/http/field.hpp>
 #include <boost/beast/http/status.hpp>
@@ -32,6 +34,7 @@
 #include <cstddef>
 #include <cstdint>
 #include <cstdio>
+#include <filesystem>
 #include <fstream>
 #include <iomanip>
 #include <memory>
@@ -40,6 +43,7 @@
 #include <string>
 #include <string_view>
 #include <utility>
+#include <vector>
 
 namespace redfish
 {
@@ -188,6 +192,44 @@ inline bool getRedfishLogFiles(
     return !redfishLogFiles.empty();
 }
 
+// Entries read from the redfish log files on a file I/O thread, to be turned
+// into LogEntry resources back on the event loop
+struct EventLogRead
+{
+    bool ok = true;
+    // Listed entries in the whole log
+    size_t count = 0;
+    // Pairs of entry ID and the line logged for it
+    std::vector<std::pair<std::string, std::string>> entries;
+};
+
+// Reads the lines at the given locations, as recorded by the event log index
+inline void readLogEntries(
+    const std::vector<event_log::LogIndex::Location>& locations,
+    EventLogRead& read)
+{
+    std::filesystem::path openFile;
+    std::ifstream logStream;
+    for (const event_log::LogIndex::Location& location : locations)
+    {
+        if (location.file != openFile)
+        {
+            logStream = std::ifstream(location.file);
+            openFile = location.file;
+        }
+        std::string logEntry;
+        logStream.clear();
+        logStream.seekg(static_cast<std::streamoff>(location.offset));
+        if (!logStream.is_open() || !std::getline(logStream, logEntry))
+        {
+            BMCWEB_LOG_ERROR("Failed to read event log entry {}", location.id);
+            read.ok = false;
+            return;
+        }
+        read.entries.emplace_back(location.id, std::move(logEntry));
+    }
+}
+
 enum class LogParseError
 {
     success,
@@ -327,75 +369,65 @@ inline void handleSystemsAndManagersLogServiceEventLogLogEntryCollection(
     asyncResp->res.jsonValue["Description"] =
         std::format("Collection of {} Event Log Entries", logEntryDescriptor);
 
-    nlohmann::json& logEntryArray = asyncResp->res.jsonValue["Members"];
-    logEntryArray = nlohmann::json::array();
-    // Go through the log files and create a unique ID for each
-    // entry
-    std::vector<std::filesystem::path> redfishLogFiles;
-    getRedfishLogFiles(redfishLogFiles);
-    uint64_t entryCount = 0;
-    std::string logEntry;
-
-    // Oldest logs are in the last file, so start there and loop
-    // backwards
-    event_log::UniqueEntryIDState state;
-    for (auto it = redfishLogFiles.rbegin(); it < redfishLogFiles.rend(); it++)
-    {
-        std::ifstream logStream(*it);
-        if (!logStream.is_open())
-        {
-            continue;
-        }
-
-        // Reset the unique ID on the first entry
-        while (std::getline(logStream, logEntry))
-        {
-            std::string idStr;
-            if (!event_log::getUniqueEntryID(state, logEntry, idStr))
-            {
-                continue;
-            }
-
-            nlohmann::json::object_t bmcLogEntry;
-            LogParseError status = fillEventLogEntryJson(
-                idStr, logEntry, bmcLogEntry, collectionStr, memberId,
-                logEntryDescriptor);
-            if (status == LogParseError::messageIdNotInRegistry)
-            {
-                continue;
-            }
-            if (status != LogParseError::success)
+    asyncResp->res.jsonValue["Members"] = nlohmann::json::array();
+
+    // The index knows where each entry starts, so only the entries on the
+    // requested page are read, and off the event loop
+    bmcweb::getFileIoPool().run(
+        [skip, top]() {
+            event_log::LogIndex& index = event_log::LogIndex::getInstance();
+            index.update();
+            // The count comes with the page, so they agree even if the log
+            // watcher updates the index in between
+            event_log::LogIndex::Page page = index.page(skip, top);
+            EventLogRead read;
+            read.count = page.listedCount;
+            readLogEntries(page.locations, read);
+            return read;
+        },
+        [asyncResp, collectionStr, memberId, logEntryDescriptor, skip,
+         top](const EventLogRead& read) {
+            if (!read.ok)
             {
                 messages::internalError(asyncResp->res);
                 return;
             }
+            nlohmann::json& logEntryArray =
+                asyncResp->res.jsonValue["Members"];
+            for (const auto& [id, logEntry] : read.entries)
+            {
+                nlohmann::json::object_t bmcLogEntry;
+                LogParseError status = fillEventLogEntryJson(
+                    id, logEntry, bmcLogEntry, collectionStr, memberId,
+                    logEntryDescriptor);
+                if (status == LogParseError::messageIdNotInRegistry)
+                {
+                    continue;
+                }
+                if (status != LogParseError::success)
+                {
+                    messages::internalError(asyncResp->res);
+                    return;
+                }
 
-            entryCount++;
-            // Handle paging using skip (number of entries to skip from the
-            // start) and top (number of entries to display)
-            if (entryCount <= skip || entryCount > skip + top)
+                logEntryArray.emplace_back(std::move(bmcLogEntry));
+            }
+            asyncResp->res.jsonValue["Members@odata.count"] = read.count;
+            if (skip + top < read.count)
             {
-                continue;
+                asyncResp->res.jsonValue["Members@odata.nextLink"] =
+                    boost::urls::format(
+                        "/redfish/v1/{}/{}/LogServices/EventLog/Entries?$skip={}",
+                        collectionStr, memberId, std::to_string(skip + top));
             }
-
-            logEntryArray.emplace_back(std::move(bmcLogEntry));
-        }
-    }
-    asyncResp->res.jsonValue["Members@odata.count"] = entryCount;
-    if (skip + top < entryCount)
-    {
-        asyncResp->res.jsonValue["Members@odata.nextLink"] =
-            boost::urls::format(
-                "/redfish/v1/{}/{}/LogServices/EventLog/Entries?$skip={}",
-                collectionStr, memberId, std::to_string(skip + top));
-    }
+        });
 }
 
 inline void handleSystemsAndManagersLogServiceEventLogEntriesGet(
     const std::shared_ptr<bmcweb::AsyncResp>& asyncResp,
     const std::string& param, LogServiceParentCollection collection)
 {
-    const std::string& targetID = param;
+    const std::string targetID = param;
 
     const std::string collectionStr =
         logServiceParentCollectionToString(collection);
@@ -410,50 +442,45 @@ inline void handleSystemsAndManagersLogServiceEventLogEntriesGet(
         return;
     }
 
-    // Go through the log files and check the unique ID for each
-    // entry to find the target entry
-    std::vector<std::filesystem::path> redfishLogFiles;
-    getRedfishLogFiles(redfishLogFiles);
-    std::string logEntry;
-
-    // Oldest logs are in the last file, so start there and loop
-    // backwards
-    event_log::UniqueEntryIDState state;
-    for (auto it = redfishLogFiles.rbegin(); it < redfishLogFiles.rend(); it++)
-    {
-        std::ifstream logStream(*it);
-        if (!logStream.is_open())
-        {
-            continue;
-        }
-
-        // Reset the unique ID on the first entry
-        while (std::getline(logStream, logEntry))
-        {
-            std::string idStr;
-            if (!event_log::getUniqueEntryID(state, logEntry, idStr))
+    bmcweb::getFileIoPool().run(
+        [targetID]() {
+            event_log::LogIndex& index = event_log::LogIndex::getInstance();
+            index.update();
+            EventLogRead read;
+            std::optional<event_log::LogIndex::Location> location =
+                index.find(targetID);
+            if (location)
             {
-                continue;
+                readLogEntries({*location}, read);
             }
-
-            if (idStr == targetID)
+            return read;
+        },
+        [asyncResp, targetID, collectionStr, memberId,
+         logEntryDescriptor](const EventLogRead& read) {
+            if (!read.ok)
             {
-                nlohmann::json::object_t bmcLogEntry;
-                LogParseError status = fillEventLogEntryJson(
-                    idStr, logEntry, bmcLogEntry, collectionStr, memberId,
-                    logEntryDescriptor);
-                if (status != LogParseError::success)
-                {
-                    messages::internalError(asyncResp->res);
-                    return;
-                }
-                asyncResp->res.jsonValue.update(bmcLogEntry);
+                messages::internalError(asyncResp->res);
                 return;
             }
-        }
-    }
-    // Requested ID was not found
-    messages::resourceNotFound(asyncResp->res, "LogEntry", targetID);
+            if (read.entries.empty())
+            {
+                // Requested ID was not found
+                messages::resourceNotFound(asyncResp->res, "LogEntry",
+                                           targetID);
+                return;
+            }
+            const auto& [id, logEntry] = read.entries.front();
+            nlohmann::json::object_t bmcLogEntry;
+            LogParseError status =
+                fillEventLogEntryJson(id, logEntry, bmcLogEntry, collectionStr,
+                                      memberId, logEntryDescriptor);
+            if (status != LogParseError::success)
+            {
+                messages::internalError(asyncResp->res);
+                return;
+            }
+            asyncResp->res.jsonValue.update(bmcLogEntry);
+        });
 }
 
 inline void handleSystemsAndManagersLogServicesEventLogActionsClearPost(
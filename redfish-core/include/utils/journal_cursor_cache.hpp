@@ -0,0 +1,211 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+#pragma once
+
+#include "logging.hpp"
+#include "utils/journal_read_state.hpp"
+
+#include <boost/container/flat_map.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <utility>
+
+namespace redfish
+{
+
+// Remembers the journal cursor of entries at a fixed stride from the head of
+// the journal, and of the entries where clients' pages ended, so that $skip
+// can seek close to the requested entry instead of stepping through every
+// entry before it.  Indexes count from the head, so they all shift when the
+// head is vacuumed; the cache is dropped whenever the head entry changes.
+class JournalCursorCache
+{
+  public:
+    struct Checkpoint
+    {
+        uint64_t index = 0;
+        std::string cursor;
+    };
+
+    struct Stats
+    {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t stale = 0;
+    };
+
+    static constexpr uint64_t defaultStride = 1000;
+    static constexpr size_t maxCheckpoints = 256;
+
+    explicit JournalCursorCache(uint64_t strideIn = defaultStride) :
+        stride(std::max<uint64_t>(strideIn, 1))
+    {}
+
+    static JournalCursorCache& getInstance()
+    {
+        static JournalCursorCache cache;
+        return cache;
+    }
+
+    // Drops every checkpoint if the journal no longer starts at the entry
+    // it started at when they were taken
+    void setHead(const std::string& headCursor)
+    {
+        if (headCursor == head)
+        {
+            return;
+        }
+        if (!checkpoints.empty())
+        {
+            BMCWEB_LOG_DEBUG("Journal head moved, dropping {} checkpoints",
+                             checkpoints.size());
+        }
+        checkpoints.clear();
+        head = headCursor;
+        generation++;
+    }
+
+    // Changes whenever the checkpoints are dropped, so that a checkpoint
+    // found against an older head isn't recorded against the new one
+    uint64_t getGeneration() const
+    {
+        return generation;
+    }
+
+    void insert(uint64_t forGeneration, uint64_t index, std::string cursor)
+    {
+        if (forGeneration != generation || index == 0 || cursor.empty())
+        {
+            return;
+        }
+        if (checkpoints.size() >= maxCheckpoints &&
+            !checkpoints.contains(index))
+        {
+            // The shallowest checkpoints save the least stepping
+            checkpoints.erase(checkpoints.begin());
+        }
+        checkpoints.insert_or_assign(index, std::move(cursor));
+    }
+
+    void erase(uint64_t index)
+    {
+        checkpoints.erase(index);
+    }
+
+    // The deepest checkpoint at or before index
+    std::optional<Checkpoint> findBefore(uint64_t index) const
+    {
+        auto it = checkpoints.upper_bound(index);
+        if (it == checkpoints.begin())
+        {
+            return std::nullopt;
+        }
+        it--;
+        return Checkpoint{it->first, it->second};
+    }
+
+    uint64_t getStride() const
+    {
+        return stride;
+    }
+
+    size_t size() const
+    {
+        return checkpoints.size();
+    }
+
+    Stats& getStats()
+    {
+        return stats;
+    }
+
+  private:
+    uint64_t stride;
+    std::string head;
+    uint64_t generation = 0;
+    boost::container::flat_map<uint64_t, std::string> checkpoints;
+    Stats stats;
+};
+
+// Moves journal, which must be on its head entry, skip entries forward.  Starts
+// from the deepest checkpoint that is still in the journal, and leaves
+// checkpoints behind at each stride it passes.  Returns the number of entries
+// moved, which is less than skip if the journal ends first, or a negative
+// errno.
+inline int64_t skipJournalEntries(JournalReadState& journal,
+                                  JournalCursorCache& cache, uint64_t skip)
+{
+    cache.setHead(journal.getCursor());
+
+    uint64_t index = 0;
+    bool moved = false;
+    std::optional<JournalCursorCache::Checkpoint> checkpoint =
+        cache.findBefore(skip);
+    while (checkpoint)
+    {
+        moved = true;
+        if (journal.seekCursor(checkpoint->cursor) >= 0 &&
+            journal.next() > 0 && journal.testCursor(checkpoint->cursor) > 0)
+        {
+            index = checkpoint->index;
+            break;
+        }
+        BMCWEB_LOG_DEBUG("Journal checkpoint {} is gone", checkpoint->index);
+        cache.getStats().stale++;
+        cache.erase(checkpoint->index);
+        checkpoint = cache.findBefore(skip);
+    }
+    if (index > 0)
+    {
+        cache.getStats().hits++;
+    }
+    else
+    {
+        if (skip > 0)
+        {
+            cache.getStats().misses++;
+        }
+        if (moved)
+        {
+            // A stale checkpoint left the journal somewhere else
+            int ret = journal.seekHead();
+            if (ret >= 0)
+            {
+                ret = journal.next();
+            }
+            if (ret < 0)
+            {
+                return ret;
+            }
+        }
+    }
+
+    uint64_t stride = cache.getStride();
+    while (index < skip)
+    {
+        uint64_t nextCheckpoint = (index / stride + 1) * stride;
+        uint64_t step = std::min(skip, nextCheckpoint) - index;
+        int ret = journal.nextSkip(step);
+        if (ret < 0)
+        {
+            return ret;
+        }
+        index += static_cast<uint64_t>(ret);
+        if (static_cast<uint64_t>(ret) < step)
+        {
+            // Reached the end of the journal
+            break;
+        }
+        if (index % stride == 0)
+        {
+            cache.insert(cache.getGeneration(), index, journal.getCursor());
+        }
+    }
+    return static_cast<int64_t>(index);
+}
+
+} // namespace redfish
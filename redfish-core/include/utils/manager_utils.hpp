@@ -49,7 +49,11 @@ inline void setServiceIdentification(
     }
 
     persistent_data::ConfigFile& config = persistent_data::getConfig();
-    config.serviceIdentification = serviceIdentification;
+    if (config.serviceIdentification != serviceIdentification)
+    {
+        config.serviceIdentification = serviceIdentification;
+        config.generation.bump();
+    }
     config.writeData();
     messages::success(asyncResp->res);
 }
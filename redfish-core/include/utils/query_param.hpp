@@ -15,6 +15,7 @@
 #include "json_formatters.hpp"
 #include "logging.hpp"
 #include "redfishoemrule.hpp"
+#include "sessions.hpp"
 #include "str_utility.hpp"
 #include "sub_request.hpp"
 #include "utils/json_utils.hpp"
@@ -23,6 +24,7 @@
 
 #include <boost/beast/http/status.hpp>
 #include <boost/beast/http/verb.hpp>
+#include <boost/container/flat_map.hpp>
 #include <boost/url/params_view.hpp>
 #include <nlohmann/json.hpp>
 
@@ -32,6 +34,7 @@
 #include <charconv>
 #include <cstddef>
 #include <cstdint>
+#include <deque>
 #include <functional>
 #include <iterator>
 #include <limits>
@@ -773,13 +776,8 @@ class MultiAsyncResp : public std::enable_shared_from_this<MultiAsyncResp>
     // allows callers to attach sub-responses within the json tree that need
     // to be executed and filled into their appropriate locations.  This
     // class manages the final "merge" of the json resources.
-    MultiAsyncResp(crow::App& appIn,
-                   std::shared_ptr<bmcweb::AsyncResp> finalResIn) :
-        app(&appIn), finalRes(std::move(finalResIn))
-    {}
-
     explicit MultiAsyncResp(std::shared_ptr<bmcweb::AsyncResp> finalResIn) :
-        app(nullptr), finalRes(std::move(finalResIn))
+        finalRes(std::move(finalResIn))
     {}
 
     void addAwaitingResponse(
@@ -805,57 +803,6 @@ class MultiAsyncResp : public std::enable_shared_from_this<MultiAsyncResp>
         finalObj = std::move(*obj);
     }
 
-    // Handles the very first level of Expand, and starts a chain of sub-queries
-    // for deeper levels.
-    void startQuery(const Query& query, const Query& delegated,
-                    const crow::Request& req)
-    {
-        std::vector<ExpandNode> nodes = findNavigationReferences(
-            query.expandType, query.expandLevel, delegated.expandLevel,
-            finalRes->res.jsonValue);
-        BMCWEB_LOG_DEBUG("{} nodes to traverse", nodes.size());
-        const std::optional<std::string> queryStr = formatQueryForExpand(query);
-        if (!queryStr)
-        {
-            messages::internalError(finalRes->res);
-            return;
-        }
-        for (const ExpandNode& node : nodes)
-        {
-            const std::string subQuery = node.uri + *queryStr;
-            BMCWEB_LOG_DEBUG("URL of subquery:  {}", subQuery);
-            std::error_code ec;
-            auto newReq = std::make_shared<crow::Request>(
-                crow::Request::Body{boost::beast::http::verb::get, subQuery,
-                                    11},
-                ec);
-            if (ec)
-            {
-                messages::internalError(finalRes->res);
-                return;
-            }
-
-            if (req.session == nullptr)
-            {
-                BMCWEB_LOG_ERROR("Session is null");
-                messages::internalError(finalRes->res);
-                return;
-            }
-            // Share the session from the original request
-            newReq->session = req.session;
-
-            auto asyncResp = std::make_shared<bmcweb::AsyncResp>();
-            BMCWEB_LOG_DEBUG("setting completion handler on {}",
-                             logPtr(&asyncResp->res));
-
-            addAwaitingResponse(asyncResp, node.location);
-            if (app != nullptr)
-            {
-                app->handle(newReq, asyncResp);
-            }
-        }
-    }
-
     static void startMultiFragmentHandle(
         const std::shared_ptr<redfish::SubRequest>& req,
         const std::shared_ptr<bmcweb::AsyncResp>& asyncResp,
@@ -897,10 +844,208 @@ class MultiAsyncResp : public std::enable_shared_from_this<MultiAsyncResp>
         multi->placeResult(locationToPlace, res);
     }
 
-    crow::App* app;
     std::shared_ptr<bmcweb::AsyncResp> finalRes;
 };
 
+// Runs every level of an $expand for the request that asked for it.  Each
+// navigation reference is fetched with a sub-request, and the sub-request hands
+// the references in its own response back to the same engine, so a resource
+// that is linked from several places in the tree is fetched once while it is
+// outstanding, and no more than maxInFlight sub-requests run at a time.
+// Sub-requests share the session of the original request, which has already
+// been authorized, so they don't fetch the user's privileges again.
+class ExpandEngine : public std::enable_shared_from_this<ExpandEngine>
+{
+  public:
+    ExpandEngine(crow::App& appIn,
+                 std::shared_ptr<bmcweb::AsyncResp> finalResIn,
+                 size_t maxInFlightIn =
+                     static_cast<size_t>(BMCWEB_EXPAND_MAX_IN_FLIGHT)) :
+        app(appIn), finalRes(std::move(finalResIn)),
+        maxInFlight(std::max<size_t>(maxInFlightIn, 1))
+    {}
+
+    ~ExpandEngine()
+    {
+        BMCWEB_LOG_DEBUG(
+            "Expand made {} sub-requests, {} references shared one, at most {} at once",
+            subRequests.size(), deduplicated, peakInFlight);
+    }
+
+    ExpandEngine(const ExpandEngine&) = delete;
+    ExpandEngine(ExpandEngine&&) = delete;
+    ExpandEngine& operator=(const ExpandEngine&) = delete;
+    ExpandEngine& operator=(ExpandEngine&&) = delete;
+
+    // Starts on the references in the response to the original request
+    void start(const Query& query, const Query& delegated,
+               const crow::Request& req)
+    {
+        session = req.session;
+        addReferences(query, delegated, {nlohmann::json::json_pointer("")},
+                      finalRes->res.jsonValue);
+        if (session == nullptr && !queue.empty())
+        {
+            BMCWEB_LOG_ERROR("Session is null");
+            messages::internalError(finalRes->res);
+            return;
+        }
+        pump();
+    }
+
+    // Queues the references in the response to sub-request index for the
+    // next level.  Called before the response is placed.
+    void addChildren(size_t index, const Query& query, const Query& delegated,
+                     nlohmann::json& jsonValue)
+    {
+        // Copied, as queueing references can grow subRequests
+        std::vector<nlohmann::json::json_pointer> parents =
+            subRequests[index].locations;
+        addReferences(query, delegated, parents, jsonValue);
+    }
+
+  private:
+    struct SubRequest
+    {
+        std::string target;
+        // Everywhere in the final response the result goes
+        std::vector<nlohmann::json::json_pointer> locations;
+    };
+
+    void addReferences(const Query& query, const Query& delegated,
+                       const std::vector<nlohmann::json::json_pointer>& parents,
+                       nlohmann::json& jsonValue)
+    {
+        std::vector<ExpandNode> nodes = findNavigationReferences(
+            query.expandType, query.expandLevel, delegated.expandLevel,
+            jsonValue);
+        BMCWEB_LOG_DEBUG("{} nodes to traverse", nodes.size());
+        if (nodes.empty())
+        {
+            return;
+        }
+        const std::optional<std::string> queryStr = formatQueryForExpand(query);
+        if (!queryStr)
+        {
+            messages::internalError(finalRes->res);
+            return;
+        }
+        for (const ExpandNode& node : nodes)
+        {
+            std::string target = node.uri + *queryStr;
+            auto [it, inserted] =
+                outstanding.try_emplace(target, subRequests.size());
+            if (inserted)
+            {
+                BMCWEB_LOG_DEBUG("URL of subquery:  {}", target);
+                queue.push_back(subRequests.size());
+                subRequests.emplace_back(SubRequest{std::move(target), {}});
+            }
+            else
+            {
+                deduplicated++;
+            }
+            for (const nlohmann::json::json_pointer& parent : parents)
+            {
+                subRequests[it->second].locations.emplace_back(
+                    parent / node.location);
+            }
+        }
+    }
+
+    void pump()
+    {
+        if (pumping)
+        {
+            // A sub-request completed as it was started; the loop below
+            // starts the next one
+            return;
+        }
+        pumping = true;
+        while (inFlight < maxInFlight && !queue.empty())
+        {
+            size_t index = queue.front();
+            queue.pop_front();
+            launch(index);
+        }
+        pumping = false;
+    }
+
+    void launch(size_t index)
+    {
+        const std::string& target = subRequests[index].target;
+        std::error_code ec;
+        auto newReq = std::make_shared<crow::Request>(
+            crow::Request::Body{boost::beast::http::verb::get, target, 11}, ec);
+        if (ec)
+        {
+            messages::internalError(finalRes->res);
+            outstanding.erase(target);
+            return;
+        }
+        // Share the session from the original request
+        newReq->session = session;
+        newReq->userInfoPopulated = true;
+        newReq->expandEngine = shared_from_this();
+        newReq->expandIndex = index;
+
+        auto asyncResp = std::make_shared<bmcweb::AsyncResp>();
+        BMCWEB_LOG_DEBUG("setting completion handler on {}",
+                         logPtr(&asyncResp->res));
+        asyncResp->res.setCompleteRequestHandler(
+            [self = shared_from_this(), index](crow::Response& res) {
+                self->placeResult(index, res);
+            });
+        inFlight++;
+        peakInFlight = std::max(peakInFlight, inFlight);
+        app.handle(newReq, asyncResp);
+    }
+
+    void placeResult(size_t index, crow::Response& res)
+    {
+        inFlight--;
+        SubRequest& sub = subRequests[index];
+        outstanding.erase(sub.target);
+        BMCWEB_LOG_DEBUG("placeResult for {} at {} locations", sub.target,
+                         sub.locations.size());
+        propogateError(finalRes->res, res);
+        nlohmann::json::object_t* obj =
+            res.jsonValue.get_ptr<nlohmann::json::object_t*>();
+        if (obj != nullptr && !obj->empty())
+        {
+            for (size_t i = 0; i < sub.locations.size(); i++)
+            {
+                nlohmann::json& finalObj =
+                    finalRes->res.jsonValue[sub.locations[i]];
+                // Only references that were deduplicated need a copy
+                if (i + 1 == sub.locations.size())
+                {
+                    finalObj = std::move(*obj);
+                }
+                else
+                {
+                    finalObj = *obj;
+                }
+            }
+        }
+        sub.locations = {};
+        pump();
+    }
+
+    crow::App& app;
+    std::shared_ptr<bmcweb::AsyncResp> finalRes;
+    std::shared_ptr<persistent_data::UserSession> session;
+    size_t maxInFlight;
+    size_t inFlight = 0;
+    size_t peakInFlight = 0;
+    size_t deduplicated = 0;
+    bool pumping = false;
+    std::vector<SubRequest> subRequests;
+    // Sub-requests that haven't completed yet, by target
+    boost::container::flat_map<std::string, size_t, std::less<>> outstanding;
+    std::deque<size_t> queue;
+};
+
 inline void processTopAndSkip(const Query& query, crow::Response& res)
 {
     if (!query.skip && !query.top)
@@ -1053,12 +1198,21 @@ inline void processAllParams(
     if (query.expandType != ExpandType::None)
     {
         BMCWEB_LOG_DEBUG("Executing expand query");
+        if (req.expandEngine != nullptr)
+        {
+            // This is one level of a larger expand.  The engine running it
+            // fetches the references here once this response is in place.
+            req.expandEngine->addChildren(req.expandIndex, query, delegated,
+                                          intermediateResponse.jsonValue);
+            completionHandler(intermediateResponse);
+            return;
+        }
         auto asyncResp = std::make_shared<bmcweb::AsyncResp>(
             std::move(intermediateResponse));
 
         asyncResp->res.setCompleteRequestHandler(std::move(completionHandler));
-        auto multi = std::make_shared<MultiAsyncResp>(app, asyncResp);
-        multi->startQuery(query, delegated, req);
+        auto engine = std::make_shared<ExpandEngine>(app, asyncResp);
+        engine->start(query, delegated, req);
         return;
     }
 
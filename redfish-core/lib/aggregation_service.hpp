@@ -112,6 +112,9 @@ inline void handleAggregationSourceCollectionGet(
         "#AggregationSourceCollection.AggregationSourceCollection";
     json["Name"] = "Aggregation Source Collection";
 
+    // Recorded before the configs are read, so that a change made while
+    // they are isn't missed
+    asyncResp->res.addGeneration(RedfishAggregator::getInstance().generation);
     // Query D-Bus for satellite configs and add them to the Members array
     RedfishAggregator::getInstance().getSatelliteConfigs(
         std::bind_front(populateAggregationSourceCollection, asyncResp));
@@ -203,6 +206,7 @@ inline void handleAggregationSourceGet(
         return;
     }
 
+    asyncResp->res.addGeneration(RedfishAggregator::getInstance().generation);
     // Query D-Bus for satellite config corresponding to the specified
     // AggregationSource
     RedfishAggregator::getInstance().getSatelliteConfigs(std::bind_front(
@@ -317,6 +321,7 @@ inline void handleAggregationSourceCollectionPost(
     aggregator.aggregationSources.emplace(
         prefix,
         AggregationSource{*url, username.value_or(""), password.value_or("")});
+    aggregator.generation.bump();
 
     BMCWEB_LOG_DEBUG("Emplaced {} with url {}", prefix, url->buffer());
     asyncResp->res.addHeader(
@@ -369,6 +374,7 @@ inline void handleAggregationSourcePatch(
         {
             it->second.password = *password;
         }
+        aggregator.generation.bump();
 
         messages::success(asyncResp->res);
         return;
@@ -408,14 +414,15 @@ inline void handleAggregationSourceDelete(
         boost::beast::http::field::link,
         "</redfish/v1/JsonSchemas/AggregationService/AggregationSource.json>; rel=describedby");
 
-    size_t deleted = RedfishAggregator::getInstance().aggregationSources.erase(
-        aggregationSourceId);
+    auto& aggregator = RedfishAggregator::getInstance();
+    size_t deleted = aggregator.aggregationSources.erase(aggregationSourceId);
     if (deleted == 0)
     {
         messages::resourceNotFound(asyncResp->res, "AggregationSource",
                                    aggregationSourceId);
         return;
     }
+    aggregator.generation.bump();
 
     messages::success(asyncResp->res);
 }
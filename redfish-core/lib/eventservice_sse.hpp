@@ -2,6 +2,7 @@
 // SPDX-FileCopyrightText: Copyright OpenBMC Authors
 #pragma once
 
+#include "filter_expr_executor.hpp"
 #include "filter_expr_parser_ast.hpp"
 #include "filter_expr_printer.hpp"
 #include "http_request.hpp"
@@ -63,6 +64,11 @@ inline void createSubscription(crow::sse_socket::Connection& conn,
         return;
     }
 
+    if (filter)
+    {
+        subValue->filter.emplace(*filter);
+    }
+
     // GET on this URI means, Its SSE subscriptionType.
     subValue->userSub->subscriptionType = redfish::subscriptionTypeSSE;
 
@@ -137,6 +137,9 @@ inline void setIndicatorLedState(
         // ast-grep-ignore: long-lambda
         [asyncResp, ledOn,
          ledBlinkng](const boost::system::error_code& ec) mutable {
+            dbus::utility::propertiesWritten(
+                "/xyz/openbmc_project/led/groups/enclosure_identify_blink",
+                "xyz.openbmc_project.Led.Group");
             if (ec)
             {
                 // Some systems may not have enclosure_identify_blink object so
@@ -234,6 +237,9 @@ inline void setSystemLocationIndicatorActive(
         "xyz.openbmc_project.Led.Group", "Asserted", ledState,
         // ast-grep-ignore: long-lambda
         [asyncResp, ledState](const boost::system::error_code& ec) {
+            dbus::utility::propertiesWritten(
+                "/xyz/openbmc_project/led/groups/enclosure_identify_blink",
+                "xyz.openbmc_project.Led.Group");
             if (ec)
             {
                 // Some systems may not have enclosure_identify_blink object so
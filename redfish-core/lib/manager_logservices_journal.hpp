@@ -14,6 +14,7 @@
 #include "registries/privilege_registry.hpp"
 #include "utility.hpp"
 #include "utils/etag_utils.hpp"
+#include "utils/journal_cursor_cache.hpp"
 #include "utils/journal_utils.hpp"
 #include "utils/query_param.hpp"
 #include "utils/time_utils.hpp"
@@ -71,8 +72,12 @@ inline void handleManagersLogServiceJournalGet(
     etag_utils::setEtagOmitDateTimeHandler(asyncResp);
 }
 
+// Reads entries from readState, which is on entry startIndex of the journal,
+// until there are topEntryCount of them in the response.  cacheGeneration is
+// that of the cursor cache when startIndex was found.
 inline void readJournalEntries(
-    uint64_t topEntryCount, const std::shared_ptr<bmcweb::AsyncResp>& asyncResp,
+    uint64_t cacheGeneration, uint64_t startIndex, uint64_t topEntryCount,
+    const std::shared_ptr<bmcweb::AsyncResp>& asyncResp,
     JournalReadState&& readState)
 {
     nlohmann::json& logEntry = asyncResp->res.jsonValue["Members"];
@@ -100,12 +105,14 @@ inline void readJournalEntries(
     {
         if (segmentCountRemaining == 0)
         {
-            boost::asio::post(crow::connections::systemBus->get_io_context(),
-                              [asyncResp, topEntryCount,
-                               readState = std::move(readState)]() mutable {
-                                  readJournalEntries(topEntryCount, asyncResp,
-                                                     std::move(readState));
-                              });
+            boost::asio::post(
+                crow::connections::systemBus->get_io_context(),
+                [asyncResp, cacheGeneration, startIndex, topEntryCount,
+                 readState = std::move(readState)]() mutable {
+                    readJournalEntries(cacheGeneration, startIndex,
+                                       topEntryCount, asyncResp,
+                                       std::move(readState));
+                });
             return;
         }
 
@@ -125,10 +132,14 @@ inline void readJournalEntries(
         }
         if (ret == 0)
         {
-            break;
+            return;
         }
         segmentCountRemaining--;
     }
+
+    // The next page, if the client asks for it, starts here
+    JournalCursorCache::getInstance().insert(
+        cacheGeneration, startIndex + topEntryCount, readState.getCursor());
 }
 
 inline void handleManagersJournalLogEntryCollectionGet(
@@ -235,17 +246,17 @@ inline void handleManagersJournalLogEntryCollectionGet(
                 "/redfish/v1/Managers/{}/LogServices/Journal/Entries?$skip={}",
                 BMCWEB_REDFISH_MANAGER_URI_NAME, std::to_string(skip + top));
     }
-    uint64_t index = 0;
-    if (skip > 0)
+    JournalCursorCache& cursorCache = JournalCursorCache::getInstance();
+    int64_t index = skipJournalEntries(journal, cursorCache, skip);
+    if (index < 0)
     {
-        if (journal.nextSkip(skip) < 0)
-        {
-            messages::internalError(asyncResp->res);
-            return;
-        }
+        messages::internalError(asyncResp->res);
+        return;
     }
     BMCWEB_LOG_DEBUG("Index was {}", index);
-    readJournalEntries(top, asyncResp, {std::move(journal)});
+    readJournalEntries(cursorCache.getGeneration(),
+                       static_cast<uint64_t>(index), top, asyncResp,
+                       {std::move(journal)});
 }
 
 inline void handleManagersJournalEntriesLogEntryGet(
@@ -318,8 +318,11 @@ inline void handleSessionServiceGet(
     asyncResp->res.jsonValue["Name"] = "Session Service";
     asyncResp->res.jsonValue["Id"] = "SessionService";
     asyncResp->res.jsonValue["Description"] = "Session Service";
+    persistent_data::SessionStore& sessionStore =
+        persistent_data::SessionStore::getInstance();
+    asyncResp->res.addGeneration(sessionStore.timeoutGeneration);
     asyncResp->res.jsonValue["SessionTimeout"] =
-        persistent_data::SessionStore::getInstance().getTimeoutInSeconds();
+        sessionStore.getTimeoutInSeconds();
     asyncResp->res.jsonValue["ServiceEnabled"] = true;
 
     asyncResp->res.jsonValue["Sessions"]["@odata.id"] =
@@ -16,6 +16,7 @@
 #include "logging.hpp"
 #include "query.hpp"
 #include "registries/privilege_registry.hpp"
+#include "sensor_object_cache.hpp"
 #include "str_utility.hpp"
 #include "utils/chassis_utils.hpp"
 #include "utils/dbus_utils.hpp"
@@ -1878,7 +1879,9 @@ inline nlohmann::json& getPowerSupply(nlohmann::json& powerSupplyArray,
  *
  * To minimize the number of DBus calls, the DBus method
  * org.freedesktop.DBus.ObjectManager.GetManagedObjects() is used to get the
- * values of all sensors provided by a connection (service).
+ * values of all sensors provided by a connection (service).  The result is
+ * kept up to date from signals by SensorObjectCache, so it is usually fetched
+ * only once per service.
  *
  * The connections set contains all the connections that provide sensor values.
  *
@@ -1901,9 +1904,8 @@ inline void getSensorData(
     // Get managed objects from all services exposing sensors
     for (const std::string& connection : connections)
     {
-        sdbusplus::object_path sensorPath("/xyz/openbmc_project/sensors");
-        dbus::utility::getManagedObjects(
-            connection, sensorPath,
+        SensorObjectCache::getInstance().getManagedObjects(
+            connection,
             // ast-grep-ignore: long-lambda
             [sensorsAsyncResp, sensorNames,
              inventoryItems](const boost::system::error_code& ec,
@@ -46,6 +46,8 @@ inline void handleServiceRootGetImpl(
         boost::beast::http::field::link,
         "</redfish/v1/JsonSchemas/ServiceRoot/ServiceRoot.json>; rel=describedby");
 
+    // Apart from the config, everything here is fixed when bmcweb is built
+    asyncResp->res.addGeneration(persistent_data::getConfig().generation);
     std::string uuid = persistent_data::getConfig().systemUuid;
     asyncResp->res.jsonValue["@odata.type"] =
         "#ServiceRoot.v1_15_0.ServiceRoot";
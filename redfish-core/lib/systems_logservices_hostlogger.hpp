@@ -15,6 +15,7 @@
 #include "query.hpp"
 #include "registries/privilege_registry.hpp"
 #include "utils/query_param.hpp"
+#include "worker_pool.hpp"
 
 #include <boost/beast/http/verb.hpp>
 #include <boost/url/format.hpp>
@@ -97,6 +98,31 @@ inline bool getHostLoggerEntries(
     return true;
 }
 
+// Host logs read on a file I/O thread, to be turned into LogEntry resources
+// back on the event loop
+struct HostLoggerRead
+{
+    bool filesFound = false;
+    bool ok = false;
+    std::vector<std::string> logEntries;
+    size_t logCount = 0;
+};
+
+inline HostLoggerRead readHostLoggerEntries(uint64_t skip, uint64_t top)
+{
+    HostLoggerRead read;
+    std::vector<std::filesystem::path> hostLoggerFiles;
+    if (!getHostLoggerFiles(hostLoggerFolderPath, hostLoggerFiles))
+    {
+        BMCWEB_LOG_DEBUG("Failed to get host log file path");
+        return read;
+    }
+    read.filesFound = true;
+    read.ok = getHostLoggerEntries(hostLoggerFiles, skip, top, read.logEntries,
+                                   read.logCount);
+    return read;
+}
+
 inline void fillHostLoggerEntryJson(std::string_view logEntryID,
                                     std::string_view msg,
                                     nlohmann::json::object_t& logEntryJson)
@@ -184,55 +210,52 @@ inline void handleSystemsLogServicesHostloggerEntriesGet(
     asyncResp->res.jsonValue["Name"] = "HostLogger Entries";
     asyncResp->res.jsonValue["Description"] =
         "Collection of HostLogger Entries";
-    nlohmann::json& logEntryArray = asyncResp->res.jsonValue["Members"];
-    logEntryArray = nlohmann::json::array();
+    asyncResp->res.jsonValue["Members"] = nlohmann::json::array();
     asyncResp->res.jsonValue["Members@odata.count"] = 0;
 
-    std::vector<std::filesystem::path> hostLoggerFiles;
-    if (!getHostLoggerFiles(hostLoggerFolderPath, hostLoggerFiles))
-    {
-        BMCWEB_LOG_DEBUG("Failed to get host log file path");
-        return;
-    }
     // If we weren't provided top and skip limits, use the defaults.
     size_t skip = delegatedQuery.skip.value_or(0);
     size_t top = delegatedQuery.top.value_or(query_param::Query::maxTop);
-    size_t logCount = 0;
-    // This vector only store the entries we want to expose that
-    // control by skip and top.
-    std::vector<std::string> logEntries;
-    if (!getHostLoggerEntries(hostLoggerFiles, skip, top, logEntries, logCount))
-    {
-        messages::internalError(asyncResp->res);
-        return;
-    }
-    // If vector is empty, that means skip value larger than total
-    // log count
-    if (logEntries.empty())
-    {
-        asyncResp->res.jsonValue["Members@odata.count"] = logCount;
-        return;
-    }
-    if (!logEntries.empty())
-    {
-        for (size_t i = 0; i < logEntries.size(); i++)
-        {
-            nlohmann::json::object_t hostLogEntry;
-            fillHostLoggerEntryJson(std::to_string(skip + i), logEntries[i],
-                                    hostLogEntry);
-            logEntryArray.emplace_back(std::move(hostLogEntry));
-        }
+    // The logs are gzipped, so have to be read from the start; do that off
+    // the event loop
+    bmcweb::getFileIoPool().run(
+        [skip, top]() { return readHostLoggerEntries(skip, top); },
+        [asyncResp, skip, top](const HostLoggerRead& read) {
+            if (!read.filesFound)
+            {
+                return;
+            }
+            if (!read.ok)
+            {
+                messages::internalError(asyncResp->res);
+                return;
+            }
+            asyncResp->res.jsonValue["Members@odata.count"] = read.logCount;
+            // If vector is empty, that means skip value larger than total
+            // log count
+            if (read.logEntries.empty())
+            {
+                return;
+            }
+            nlohmann::json& logEntryArray =
+                asyncResp->res.jsonValue["Members"];
+            for (size_t i = 0; i < read.logEntries.size(); i++)
+            {
+                nlohmann::json::object_t hostLogEntry;
+                fillHostLoggerEntryJson(std::to_string(skip + i),
+                                        read.logEntries[i], hostLogEntry);
+                logEntryArray.emplace_back(std::move(hostLogEntry));
+            }
 
-        asyncResp->res.jsonValue["Members@odata.count"] = logCount;
-        if (skip + top < logCount)
-        {
-            asyncResp->res.jsonValue["Members@odata.nextLink"] =
-                std::format(
-                    "/redfish/v1/Systems/{}/LogServices/HostLogger/Entries?$skip=",
-                    BMCWEB_REDFISH_SYSTEM_URI_NAME) +
-                std::to_string(skip + top);
-        }
-    }
+            if (skip + top < read.logCount)
+            {
+                asyncResp->res.jsonValue["Members@odata.nextLink"] =
+                    std::format(
+                        "/redfish/v1/Systems/{}/LogServices/HostLogger/Entries?$skip=",
+                        BMCWEB_REDFISH_SYSTEM_URI_NAME) +
+                    std::to_string(skip + top);
+            }
+        });
 }
 
 inline void handleSystemsLogServicesHostloggerEntriesEntryGet(
@@ -268,36 +291,34 @@ inline void handleSystemsLogServicesHostloggerEntriesEntryGet(
         return;
     }
 
-    std::vector<std::filesystem::path> hostLoggerFiles;
-    if (!getHostLoggerFiles(hostLoggerFolderPath, hostLoggerFiles))
-    {
-        BMCWEB_LOG_DEBUG("Failed to get host log file path");
-        return;
-    }
-
-    size_t logCount = 0;
-    size_t top = 1;
-    std::vector<std::string> logEntries;
     // We can get specific entry by skip and top. For example, if we
     // want to get nth entry, we can set skip = n-1 and top = 1 to
     // get that entry
-    if (!getHostLoggerEntries(hostLoggerFiles, idInt, top, logEntries,
-                              logCount))
-    {
-        messages::internalError(asyncResp->res);
-        return;
-    }
+    bmcweb::getFileIoPool().run(
+        [idInt]() { return readHostLoggerEntries(idInt, 1); },
+        [asyncResp, param](const HostLoggerRead& read) {
+            if (!read.filesFound)
+            {
+                return;
+            }
+            if (!read.ok)
+            {
+                messages::internalError(asyncResp->res);
+                return;
+            }
 
-    if (!logEntries.empty())
-    {
-        nlohmann::json::object_t hostLogEntry;
-        fillHostLoggerEntryJson(targetID, logEntries[0], hostLogEntry);
-        asyncResp->res.jsonValue.update(hostLogEntry);
-        return;
-    }
+            if (!read.logEntries.empty())
+            {
+                nlohmann::json::object_t hostLogEntry;
+                fillHostLoggerEntryJson(param, read.logEntries[0],
+                                        hostLogEntry);
+                asyncResp->res.jsonValue.update(hostLogEntry);
+                return;
+            }
 
-    // Requested ID was not found
-    messages::resourceNotFound(asyncResp->res, "LogEntry", param);
+            // Requested ID was not found
+            messages::resourceNotFound(asyncResp->res, "LogEntry", param);
+        });
 }
 
 inline void requestRoutesSystemsLogServiceHostlogger(App& app)
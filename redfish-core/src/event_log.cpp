@@ -28,8 +28,8 @@ namespace redfish
 namespace event_log
 {
 
-bool getUniqueEntryID(UniqueEntryIDState& state, const std::string& logEntry,
-                      std::string& entryID)
+std::optional<std::chrono::sys_seconds> getEntryTimestamp(
+    std::string_view logEntry)
 {
     // Get the entry timestamp
     // The redfish log format is "<Timestamp> <MessageId>,<MessageArgs>"
@@ -43,24 +43,41 @@ bool getUniqueEntryID(UniqueEntryIDState& state, const std::string& logEntry,
         time_utils::dateStringToEpoch(timestamp);
     if (!curTs)
     {
-        return false;
+        return std::nullopt;
     }
     using std::chrono::floor;
     // Convert to seconds.  Journal doesn't give sub-seconds resolution (yet)
     // so this should be no op.
     std::chrono::seconds curTsSec = floor<std::chrono::seconds>(*curTs);
-    std::chrono::sys_seconds curTsSys(curTsSec);
-    // If the timestamp isn't unique, increment the index
-    state.index = (curTsSys == state.prevTs) ? state.index + 1 : 0;
+    return std::chrono::sys_seconds(curTsSec);
+}
 
-    // Save the timestamp
-    state.prevTs = curTsSys;
+std::string formatUniqueEntryID(std::chrono::sys_seconds timestamp, int index)
+{
+    std::string entryID = std::to_string(timestamp.time_since_epoch().count());
+    if (index > 0)
+    {
+        entryID += "_" + std::to_string(index);
+    }
+    return entryID;
+}
 
-    entryID = std::to_string(curTsSys.time_since_epoch().count());
-    if (state.index > 0)
+bool getUniqueEntryID(UniqueEntryIDState& state, const std::string& logEntry,
+                      std::string& entryID)
+{
+    std::optional<std::chrono::sys_seconds> curTsSys =
+        getEntryTimestamp(logEntry);
+    if (!curTsSys)
     {
-        entryID += "_" + std::to_string(state.index);
+        return false;
     }
+    // If the timestamp isn't unique, increment the index
+    state.index = (*curTsSys == state.prevTs) ? state.index + 1 : 0;
+
+    // Save the timestamp
+    state.prevTs = *curTsSys;
+
+    entryID = formatUniqueEntryID(*curTsSys, state.index);
     return true;
 }
 
@@ -0,0 +1,324 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+#include "event_log_index.hpp"
+
+#include "event_log.hpp"
+#include "logging.hpp"
+#include "registries.hpp"
+
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+namespace redfish
+{
+
+namespace event_log
+{
+
+namespace
+{
+
+// Whether the collection can show the entry.  Mirrors the checks made when
+// the entry is turned into a LogEntry; entries that fail to parse before the
+// registry lookup are listed, so that showing them reports the error.
+bool isListed(std::string_view logEntry)
+{
+    // The redfish log format is "<Timestamp> <MessageId>,<MessageArgs>"
+    size_t space = logEntry.find_first_of(' ');
+    if (space == std::string_view::npos)
+    {
+        return true;
+    }
+    size_t entryStart = logEntry.find_first_not_of(' ', space);
+    if (entryStart == std::string_view::npos)
+    {
+        return true;
+    }
+    std::string_view messageID = logEntry.substr(entryStart);
+    messageID = messageID.substr(0, messageID.find(','));
+
+    std::optional<registries::MessageId> msgComponents =
+        registries::getMessageComponents(messageID);
+    if (!msgComponents)
+    {
+        return true;
+    }
+    std::optional<registries::RegistryEntryRef> registry =
+        registries::getRegistryFromPrefix(msgComponents->registryName);
+    if (!registry)
+    {
+        return false;
+    }
+    return registries::getMessageFromRegistry(
+               msgComponents->messageKey, registry->get().entries) != nullptr;
+}
+
+// Enough of the start of a file to tell it apart from a new file that was
+// given the inode of a deleted one
+constexpr size_t headSize = 64;
+
+std::string readHead(const std::filesystem::path& path)
+{
+    std::ifstream file(path, std::ios::binary);
+    std::string head(headSize, '\0');
+    file.read(head.data(), static_cast<std::streamsize>(head.size()));
+    head.resize(static_cast<size_t>(file.gcount()));
+    return head;
+}
+
+} // namespace
+
+LogIndex::LogIndex(std::filesystem::path dirIn, std::string prefixIn) :
+    dir(std::move(dirIn)), prefix(std::move(prefixIn))
+{}
+
+LogIndex& LogIndex::getInstance()
+{
+    static LogIndex index("/var/log", "redfish");
+    return index;
+}
+
+void LogIndex::update()
+{
+    std::scoped_lock lock(mutex);
+    std::vector<std::filesystem::path> paths;
+    std::error_code ec;
+    for (const std::filesystem::directory_entry& dirEnt :
+         std::filesystem::directory_iterator(dir, ec))
+    {
+        if (dirEnt.path().filename().string().starts_with(prefix))
+        {
+            paths.emplace_back(dirEnt.path());
+        }
+    }
+    // As the log files rotate, they are appended with a ".#" that is higher
+    // for the older logs, so sorting backwards puts the oldest first
+    std::ranges::sort(paths, std::greater<>());
+
+    std::vector<File> updated;
+    updated.reserve(paths.size());
+    for (std::filesystem::path& path : paths)
+    {
+        struct stat st{};
+        if (stat(path.c_str(), &st) != 0)
+        {
+            continue;
+        }
+        auto existing = std::ranges::find_if(files, [&st](const File& file) {
+            return file.device == st.st_dev && file.inode == st.st_ino;
+        });
+        std::string head = readHead(path);
+        File file;
+        if (existing != files.end() &&
+            std::cmp_greater_equal(st.st_size, existing->indexedSize) &&
+            head.starts_with(existing->head))
+        {
+            file = std::move(*existing);
+        }
+        else
+        {
+            file.device = st.st_dev;
+            file.inode = st.st_ino;
+        }
+        file.path = std::move(path);
+        file.head = std::move(head);
+        if (std::cmp_greater(st.st_size, file.indexedSize))
+        {
+            extend(file);
+        }
+        updated.emplace_back(std::move(file));
+    }
+    files = std::move(updated);
+}
+
+void LogIndex::extend(File& file)
+{
+    std::ifstream logStream(file.path);
+    if (!logStream.is_open())
+    {
+        BMCWEB_LOG_ERROR("Failed to open {} for indexing", file.path.string());
+        return;
+    }
+    logStream.seekg(static_cast<std::streamoff>(file.indexedSize));
+
+    std::string logEntry;
+    while (std::getline(logStream, logEntry))
+    {
+        if (logStream.eof())
+        {
+            // The last line is still being written; index it once it's done
+            break;
+        }
+        uint64_t offset = file.indexedSize;
+        file.indexedSize += logEntry.size() + 1;
+
+        std::optional<std::chrono::sys_seconds> timestamp =
+            getEntryTimestamp(logEntry);
+        if (!timestamp)
+        {
+            continue;
+        }
+        Entry& entry = file.entries.emplace_back();
+        entry.offset = offset;
+        entry.timestamp = *timestamp;
+        entry.listed = isListed(logEntry);
+        if (entry.listed)
+        {
+            file.listed++;
+        }
+    }
+}
+
+size_t LogIndex::listedCount() const
+{
+    std::scoped_lock lock(mutex);
+    return countListed();
+}
+
+size_t LogIndex::countListed() const
+{
+    size_t count = 0;
+    for (const File& file : files)
+    {
+        count += file.listed;
+    }
+    return count;
+}
+
+std::string LogIndex::entryId(size_t file, size_t entry) const
+{
+    std::chrono::sys_seconds timestamp = files[file].entries[entry].timestamp;
+    int index = 0;
+    while (true)
+    {
+        if (entry == 0)
+        {
+            if (file == 0)
+            {
+                break;
+            }
+            file--;
+            entry = files[file].entries.size();
+            continue;
+        }
+        entry--;
+        if (files[file].entries[entry].timestamp != timestamp)
+        {
+            break;
+        }
+        index++;
+    }
+    return formatUniqueEntryID(timestamp, index);
+}
+
+LogIndex::Location LogIndex::makeLocation(size_t file, size_t entry) const
+{
+    Location location;
+    location.file = files[file].path;
+    location.offset = files[file].entries[entry].offset;
+    location.id = entryId(file, entry);
+    return location;
+}
+
+LogIndex::Page LogIndex::page(size_t skip, size_t top) const
+{
+    std::scoped_lock lock(mutex);
+    Page result;
+    result.listedCount = countListed();
+    std::vector<Location>& locations = result.locations;
+    for (size_t file = 0; file < files.size() && locations.size() < top; file++)
+    {
+        if (skip >= files[file].listed)
+        {
+            skip -= files[file].listed;
+            continue;
+        }
+        const std::vector<Entry>& entries = files[file].entries;
+        for (size_t entry = 0;
+             entry < entries.size() && locations.size() < top; entry++)
+        {
+            if (!entries[entry].listed)
+            {
+                continue;
+            }
+            if (skip > 0)
+            {
+                skip--;
+                continue;
+            }
+            locations.emplace_back(makeLocation(file, entry));
+        }
+    }
+    return result;
+}
+
+std::optional<LogIndex::Location> LogIndex::find(std::string_view id) const
+{
+    std::string_view secondsStr = id.substr(0, id.find('_'));
+    int64_t seconds = 0;
+    auto [ptr, ec] = std::from_chars(
+        secondsStr.data(), secondsStr.data() + secondsStr.size(), seconds);
+    if (ec != std::errc() || ptr != secondsStr.data() + secondsStr.size())
+    {
+        return std::nullopt;
+    }
+    int index = 0;
+    if (secondsStr.size() < id.size())
+    {
+        std::string_view indexStr = id.substr(secondsStr.size() + 1);
+        auto [indexPtr, indexEc] = std::from_chars(
+            indexStr.data(), indexStr.data() + indexStr.size(), index);
+        if (indexEc != std::errc() ||
+            indexPtr != indexStr.data() + indexStr.size())
+        {
+            return std::nullopt;
+        }
+    }
+    std::chrono::sys_seconds timestamp{std::chrono::seconds(seconds)};
+    // Only IDs written the way they're generated can match
+    if (formatUniqueEntryID(timestamp, index) != id)
+    {
+        return std::nullopt;
+    }
+
+    std::scoped_lock lock(mutex);
+    std::optional<std::chrono::sys_seconds> prevTs;
+    int run = 0;
+    for (size_t file = 0; file < files.size(); file++)
+    {
+        const std::vector<Entry>& entries = files[file].entries;
+        for (size_t entry = 0; entry < entries.size(); entry++)
+        {
+            run = (entries[entry].timestamp == prevTs) ? run + 1 : 0;
+            prevTs = entries[entry].timestamp;
+            if (entries[entry].timestamp == timestamp && run == index)
+            {
+                Location location;
+                location.file = files[file].path;
+                location.offset = entries[entry].offset;
+                location.id = std::string(id);
+                return location;
+            }
+        }
+    }
+    return std::nullopt;
+}
+
+} // namespace event_log
+
+} // namespace redfish
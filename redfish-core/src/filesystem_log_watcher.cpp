@@ -1,9 +1,11 @@
 #include "filesystem_log_watcher.hpp"
 
 #include "event_log.hpp"
+#include "event_log_index.hpp"
 #include "event_logs_object_type.hpp"
 #include "event_service_manager.hpp"
 #include "logging.hpp"
+#include "worker_pool.hpp"
 
 #include <sys/inotify.h>
 
@@ -97,6 +99,14 @@ void FilesystemLogWatcher::readEventLogsFromFile()
         eventRecords.emplace_back(idStr, timestamp, messageID, messageArgs);
     }
 
+    // Index the new entries now, rather than on the next read of the log
+    bmcweb::getFileIoPool().run(
+        []() {
+            event_log::LogIndex::getInstance().update();
+            return true;
+        },
+        [](bool /*updated*/) {});
+
     if (eventRecords.empty())
     {
         // No Records to send
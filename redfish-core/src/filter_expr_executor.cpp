@@ -5,9 +5,9 @@
 #include "filter_expr_parser_ast.hpp"
 #include "human_sort.hpp"
 #include "logging.hpp"
-#include "utils/json_utils.hpp"
 #include "utils/time_utils.hpp"
 
+#include <boost/container/small_vector.hpp>
 #include <nlohmann/json.hpp>
 
 #include <algorithm>
@@ -20,6 +20,7 @@
 #include <string>
 #include <string_view>
 #include <variant>
+#include <vector>
 
 namespace redfish
 {
@@ -27,184 +28,77 @@ namespace redfish
 namespace
 {
 
-// A value that has been parsed as a time string per Edm.DateTimeOffset
-struct DateTimeString
+// The following is created by dumping all key names of type
+// Edm.DateTimeOffset.  While imperfect that it's a hardcoded list, these
+// keys don't change that often
+constexpr auto timeKeys = std::to_array<std::string_view>(
+    {"AccountExpiration",
+     "CalibrationTime",
+     "CoefficientUpdateTime",
+     "Created",
+     "CreatedDate",
+     "CreatedTime",
+     "CreateTime",
+     "DateTime",
+     "EndDateTime",
+     "EndTime",
+     "EventTimestamp",
+     "ExpirationDate",
+     "FirstOverflowTimestamp",
+     "InitialStartTime",
+     "InstallDate",
+     "LastOverflowTimestamp",
+     "LastResetTime",
+     "LastStateTime",
+     "LastUpdated",
+     "LifetimeStartDateTime",
+     "LowestReadingTime",
+     "MaintenanceWindowStartTime",
+     "Modified",
+     "PasswordExpiration",
+     "PeakReadingTime",
+     "PresentedPublicHostKeyTimestamp",
+     "ProductionDate",
+     "ReadingTime",
+     "ReleaseDate",
+     "ReservationTime",
+     "SensorResetTime",
+     "ServicedDate",
+     "SetPointUpdateTime",
+     "StartDateTime",
+     "StartTime",
+     "Time",
+     "Timestamp",
+     "ValidNotAfter",
+     "ValidNotBefore"});
+
+bool isDateTimeKey(std::string_view key)
 {
-    time_utils::usSinceEpoch value = time_utils::usSinceEpoch::zero();
-
-    // The following is created by dumping all key names of type
-    // Edm.DateTimeOffset.  While imperfect that it's a hardcoded list, these
-    // keys don't change that often
-    static constexpr auto timeKeys = std::to_array<std::string_view>(
-        {"AccountExpiration",
-         "CalibrationTime",
-         "CoefficientUpdateTime",
-         "Created",
-         "CreatedDate",
-         "CreatedTime",
-         "CreateTime",
-         "DateTime",
-         "EndDateTime",
-         "EndTime",
-         "EventTimestamp",
-         "ExpirationDate",
-         "FirstOverflowTimestamp",
-         "InitialStartTime",
-         "InstallDate",
-         "LastOverflowTimestamp",
-         "LastResetTime",
-         "LastStateTime",
-         "LastUpdated",
-         "LifetimeStartDateTime",
-         "LowestReadingTime",
-         "MaintenanceWindowStartTime",
-         "Modified",
-         "PasswordExpiration",
-         "PeakReadingTime",
-         "PresentedPublicHostKeyTimestamp",
-         "ProductionDate",
-         "ReadingTime",
-         "ReleaseDate",
-         "ReservationTime",
-         "SensorResetTime",
-         "ServicedDate",
-         "SetPointUpdateTime",
-         "StartDateTime",
-         "StartTime",
-         "Time",
-         "Timestamp",
-         "ValidNotAfter",
-         "ValidNotBefore"});
-
-    explicit DateTimeString(std::string_view strvalue)
-    {
-        std::optional<time_utils::usSinceEpoch> out =
-            time_utils::dateStringToEpoch(strvalue);
-        if (!out)
-        {
-            BMCWEB_LOG_ERROR(
-                "Internal datetime value didn't parse as datetime?");
-        }
-        else
-        {
-            value = *out;
-        }
-    }
-
-    static bool isDateTimeKey(std::string_view key)
-    {
-        auto out = std::ranges::equal_range(timeKeys, key);
-        return out.begin() != out.end();
-    }
-};
-
-// Class that can convert an arbitrary AST type into a structured value
-// Pulling from the json pointer when required
-struct ValueVisitor
-{
-    using result_type = std::variant<std::monostate, double, int64_t,
-                                     std::string, DateTimeString>;
-    const nlohmann::json& body;
-    result_type operator()(double n);
-    result_type operator()(int64_t x);
-    result_type operator()(const filter_ast::UnquotedString& x);
-    result_type operator()(const filter_ast::QuotedString& x);
-};
-
-ValueVisitor::result_type ValueVisitor::operator()(double n)
-{
-    return {n};
-}
-
-ValueVisitor::result_type ValueVisitor::operator()(int64_t x)
-{
-    return {x};
+    auto out = std::ranges::equal_range(timeKeys, key);
+    return out.begin() != out.end();
 }
 
-ValueVisitor::result_type ValueVisitor::operator()(
-    const filter_ast::QuotedString& x)
+// A value that has been parsed as a time string per Edm.DateTimeOffset
+struct DateTimeValue
 {
-    return {x};
-}
+    int64_t value = 0;
+};
 
-ValueVisitor::result_type ValueVisitor::operator()(
-    const filter_ast::UnquotedString& x)
+DateTimeValue parseDateTime(std::string_view strvalue)
 {
-    // find key including paths with / in them
-    const nlohmann::json* it =
-        json_util::findNestedKey(static_cast<std::string_view>(x), body);
-    if (it == nullptr)
+    std::optional<time_utils::usSinceEpoch> out =
+        time_utils::dateStringToEpoch(strvalue);
+    if (!out)
     {
-        BMCWEB_LOG_ERROR("Key {} doesn't exist in output, cannot filter",
-                         static_cast<std::string>(x));
-        BMCWEB_LOG_DEBUG(
-            "Output {}",
-            body.dump(-1, ' ', true, nlohmann::json::error_handler_t::replace));
+        BMCWEB_LOG_ERROR("Internal datetime value didn't parse as datetime?");
         return {};
     }
-
-    const nlohmann::json& entry = *it;
-    const double* dValue = entry.get_ptr<const double*>();
-    if (dValue != nullptr)
-    {
-        return {*dValue};
-    }
-    const int64_t* iValue = entry.get_ptr<const int64_t*>();
-    if (iValue != nullptr)
-    {
-        return {*iValue};
-    }
-    const uint64_t* uValue = entry.get_ptr<const uint64_t*>();
-    if (uValue != nullptr)
-    {
-        // For now all values are coerced to signed
-        if (*uValue > std::numeric_limits<int64_t>::max())
-        {
-            BMCWEB_LOG_WARNING("Parsed uint is outside limits");
-            return {};
-        }
-        return {static_cast<int64_t>(*uValue)};
-    }
-    const std::string* strValue = entry.get_ptr<const std::string*>();
-    if (strValue != nullptr)
-    {
-        if (DateTimeString::isDateTimeKey(x))
-        {
-            return DateTimeString(*strValue);
-        }
-        return {*strValue};
-    }
-
-    BMCWEB_LOG_ERROR(
-        "Type for key {} was {} which does not have a comparison operator",
-        static_cast<std::string>(x), static_cast<int>(entry.type()));
-    return {};
+    return {out->count()};
 }
 
-struct ApplyFilter
-{
-    const nlohmann::json& body;
-    const filter_ast::LogicalAnd& filter;
-    using result_type = bool;
-    bool operator()(const filter_ast::LogicalNot& x);
-    bool operator()(const filter_ast::LogicalOr& x);
-    bool operator()(const filter_ast::LogicalAnd& x);
-    bool operator()(const filter_ast::Comparison& x);
-    bool operator()(const filter_ast::BooleanOp& x);
-
-  public:
-    bool matches();
-};
-
-bool ApplyFilter::operator()(const filter_ast::LogicalNot& x)
-{
-    bool subValue = (*this)(x.operand);
-    if (x.isLogicalNot)
-    {
-        return !subValue;
-    }
-    return subValue;
-}
+// A side of a comparison, resolved against the member being tested
+using Value = std::variant<std::monostate, double, int64_t, std::string_view,
+                           DateTimeValue>;
 
 // Helper function to reduce the number of permutations of a single comparison
 // For all possible types.
@@ -291,13 +185,237 @@ bool doStringComparison(std::string_view left,
     }
 }
 
-bool ApplyFilter::operator()(const filter_ast::Comparison& x)
+// Looks up a key, including paths with / in them
+const nlohmann::json* findKey(const std::vector<std::string>& path,
+                              const nlohmann::json& member)
+{
+    const nlohmann::json* value = &member;
+    for (size_t i = 0; i < path.size(); i++)
+    {
+        if (i + 1 < path.size())
+        {
+            const nlohmann::json::object_t* obj =
+                value->get_ptr<const nlohmann::json::object_t*>();
+            if (obj == nullptr || obj->empty())
+            {
+                BMCWEB_LOG_ERROR("Requested key wasn't an object");
+                return nullptr;
+            }
+        }
+        nlohmann::json::const_iterator it = value->find(path[i]);
+        if (it == value->end())
+        {
+            return nullptr;
+        }
+        value = &*it;
+    }
+    return value;
+}
+
+Value valueOfKey(const nlohmann::json& entry, std::string_view key,
+                 bool isTimeKey)
+{
+    const double* dValue = entry.get_ptr<const double*>();
+    if (dValue != nullptr)
+    {
+        return {*dValue};
+    }
+    const int64_t* iValue = entry.get_ptr<const int64_t*>();
+    if (iValue != nullptr)
+    {
+        return {*iValue};
+    }
+    const uint64_t* uValue = entry.get_ptr<const uint64_t*>();
+    if (uValue != nullptr)
+    {
+        // For now all values are coerced to signed
+        if (*uValue > std::numeric_limits<int64_t>::max())
+        {
+            BMCWEB_LOG_WARNING("Parsed uint is outside limits");
+            return {};
+        }
+        return {static_cast<int64_t>(*uValue)};
+    }
+    const std::string* strValue = entry.get_ptr<const std::string*>();
+    if (strValue != nullptr)
+    {
+        if (isTimeKey)
+        {
+            return parseDateTime(*strValue);
+        }
+        return {std::string_view(*strValue)};
+    }
+
+    BMCWEB_LOG_ERROR(
+        "Type for key {} was {} which does not have a comparison operator",
+        key, static_cast<int>(entry.type()));
+    return {};
+}
+
+} // namespace
+
+CompiledFilter::CompiledFilter(const filter_ast::LogicalAnd& filter)
+{
+    compile(filter);
+}
+
+CompiledFilter::Operand CompiledFilter::compileOperand(
+    const filter_ast::Argument& argument)
+{
+    struct OperandVisitor
+    {
+        using result_type = Operand;
+        Operand operator()(int64_t x) const
+        {
+            Operand operand;
+            operand.literal = x;
+            return operand;
+        }
+        Operand operator()(double n) const
+        {
+            Operand operand;
+            operand.literal = n;
+            return operand;
+        }
+        Operand operator()(const filter_ast::QuotedString& x) const
+        {
+            Operand operand;
+            operand.literal = std::string(x);
+            // Parsed now in case it's compared against a time
+            std::optional<time_utils::usSinceEpoch> time =
+                time_utils::dateStringToEpoch(x);
+            if (time)
+            {
+                operand.literalTime = time->count();
+            }
+            return operand;
+        }
+        Operand operator()(const filter_ast::UnquotedString& x) const
+        {
+            Operand operand;
+            operand.key = x;
+            operand.isTimeKey = isDateTimeKey(x);
+            std::string_view remaining = x;
+            size_t split = remaining.find('/');
+            while (split != std::string_view::npos)
+            {
+                operand.path.emplace_back(remaining.substr(0, split));
+                remaining = remaining.substr(split + 1);
+                split = remaining.find('/');
+            }
+            operand.path.emplace_back(remaining);
+            return operand;
+        }
+    };
+    return boost::apply_visitor(OperandVisitor(), argument);
+}
+
+void CompiledFilter::emit(OpCode op, size_t comparison)
+{
+    program.push_back({op, comparison});
+    if (op == OpCode::Compare)
+    {
+        depth++;
+        maxDepth = std::max(maxDepth, depth);
+    }
+    else if (op != OpCode::Not)
+    {
+        depth--;
+    }
+}
+
+void CompiledFilter::compile(const filter_ast::LogicalAnd& x)
 {
-    ValueVisitor numeric(body);
-    std::variant<std::monostate, double, int64_t, std::string, DateTimeString>
-        left = boost::apply_visitor(numeric, x.left);
-    std::variant<std::monostate, double, int64_t, std::string, DateTimeString>
-        right = boost::apply_visitor(numeric, x.right);
+    compile(x.first);
+    for (const filter_ast::LogicalOr& bOp : x.rest)
+    {
+        compile(bOp);
+        emit(OpCode::And);
+    }
+}
+
+void CompiledFilter::compile(const filter_ast::LogicalOr& x)
+{
+    compile(x.first);
+    for (const filter_ast::LogicalNot& bOp : x.rest)
+    {
+        compile(bOp);
+        emit(OpCode::Or);
+    }
+}
+
+void CompiledFilter::compile(const filter_ast::LogicalNot& x)
+{
+    compile(x.operand);
+    if (x.isLogicalNot)
+    {
+        emit(OpCode::Not);
+    }
+}
+
+void CompiledFilter::compile(const filter_ast::BooleanOp& x)
+{
+    struct OpVisitor
+    {
+        using result_type = void;
+        CompiledFilter& self;
+        void operator()(const filter_ast::Comparison& op) const
+        {
+            self.compile(op);
+        }
+        void operator()(const filter_ast::LogicalAnd& op) const
+        {
+            self.compile(op);
+        }
+    };
+    boost::apply_visitor(OpVisitor{*this}, x);
+}
+
+void CompiledFilter::compile(const filter_ast::Comparison& x)
+{
+    comparisons.push_back({compileOperand(x.left), x.token,
+                           compileOperand(x.right)});
+    emit(OpCode::Compare, comparisons.size() - 1);
+}
+
+bool CompiledFilter::compare(const Comparison& comparison,
+                             const nlohmann::json& member) const
+{
+    auto resolve = [&member](const Operand& operand) -> Value {
+        if (operand.path.empty())
+        {
+            return std::visit(
+                [](const auto& literal) -> Value { return {literal}; },
+                operand.literal);
+        }
+        const nlohmann::json* entry = findKey(operand.path, member);
+        if (entry == nullptr)
+        {
+            BMCWEB_LOG_ERROR("Key {} doesn't exist in output, cannot filter",
+                             operand.key);
+            return {};
+        }
+        return valueOfKey(*entry, operand.key, operand.isTimeKey);
+    };
+    // Strings compared against times are read as times too; literals were
+    // already parsed when the filter was compiled
+    auto asTime = [](const Operand& operand, std::string_view str) {
+        if (!operand.path.empty())
+        {
+            return parseDateTime(str);
+        }
+        if (!operand.literalTime)
+        {
+            BMCWEB_LOG_ERROR(
+                "Internal datetime value didn't parse as datetime?");
+            return DateTimeValue{};
+        }
+        return DateTimeValue{*operand.literalTime};
+    };
+
+    Value left = resolve(comparison.left);
+    Value right = resolve(comparison.right);
+    filter_ast::ComparisonOpEnum token = comparison.token;
 
     // Numeric comparisons
     const double* lDoubleValue = std::get_if<double>(&left);
@@ -310,12 +428,12 @@ bool ApplyFilter::operator()(const filter_ast::Comparison& x)
         if (rDoubleValue != nullptr)
         {
             // Both sides are doubles, do the comparison as doubles
-            return doDoubleComparison(*lDoubleValue, x.token, *rDoubleValue);
+            return doDoubleComparison(*lDoubleValue, token, *rDoubleValue);
         }
         if (rIntValue != nullptr)
         {
             // If right arg is int, promote right arg to double
-            return doDoubleComparison(*lDoubleValue, x.token,
+            return doDoubleComparison(*lDoubleValue, token,
                                       static_cast<double>(*rIntValue));
         }
     }
@@ -324,44 +442,45 @@ bool ApplyFilter::operator()(const filter_ast::Comparison& x)
         if (rIntValue != nullptr)
         {
             // Both sides are ints, do the comparison as ints
-            return doIntComparison(*lIntValue, x.token, *rIntValue);
+            return doIntComparison(*lIntValue, token, *rIntValue);
         }
 
         if (rDoubleValue != nullptr)
         {
             // Left arg is int, promote left arg to double
-            return doDoubleComparison(static_cast<double>(*lIntValue), x.token,
+            return doDoubleComparison(static_cast<double>(*lIntValue), token,
                                       *rDoubleValue);
         }
     }
 
     // String comparisons
-    const std::string* lStrValue = std::get_if<std::string>(&left);
-    const std::string* rStrValue = std::get_if<std::string>(&right);
+    const std::string_view* lStrValue = std::get_if<std::string_view>(&left);
+    const std::string_view* rStrValue = std::get_if<std::string_view>(&right);
 
-    const DateTimeString* lDateValue = std::get_if<DateTimeString>(&left);
-    const DateTimeString* rDateValue = std::get_if<DateTimeString>(&right);
+    const DateTimeValue* lDateValue = std::get_if<DateTimeValue>(&left);
+    const DateTimeValue* rDateValue = std::get_if<DateTimeValue>(&right);
 
-    // If we're trying to compare a date string to a string, construct a
-    // datestring from the string
+    // If we're trying to compare a date string to a string, read the string
+    // as a date
     if (lDateValue != nullptr && rStrValue != nullptr)
     {
-        rDateValue = &right.emplace<DateTimeString>(std::string(*rStrValue));
+        rDateValue = &right.emplace<DateTimeValue>(
+            asTime(comparison.right, *rStrValue));
     }
     if (lStrValue != nullptr && rDateValue != nullptr)
     {
-        lDateValue = &left.emplace<DateTimeString>(std::string(*lStrValue));
+        lDateValue =
+            &left.emplace<DateTimeValue>(asTime(comparison.left, *lStrValue));
     }
 
     if (lDateValue != nullptr && rDateValue != nullptr)
     {
-        return doIntComparison(lDateValue->value.count(), x.token,
-                               rDateValue->value.count());
+        return doIntComparison(lDateValue->value, token, rDateValue->value);
     }
 
     if (lStrValue != nullptr && rStrValue != nullptr)
     {
-        return doStringComparison(*lStrValue, x.token, *rStrValue);
+        return doStringComparison(*lStrValue, token, *rStrValue);
     }
 
     BMCWEB_LOG_ERROR(
@@ -370,43 +489,43 @@ bool ApplyFilter::operator()(const filter_ast::Comparison& x)
     return true;
 }
 
-bool ApplyFilter::operator()(const filter_ast::BooleanOp& x)
+bool CompiledFilter::matches(const nlohmann::json& member) const
 {
-    return boost::apply_visitor(*this, x);
-}
-
-bool ApplyFilter::operator()(const filter_ast::LogicalOr& x)
-{
-    bool value = (*this)(x.first);
-    for (const filter_ast::LogicalNot& bOp : x.rest)
+    boost::container::small_vector<bool, 16> stack;
+    stack.reserve(maxDepth);
+    for (const Instruction& instruction : program)
     {
-        value = value || (*this)(bOp);
+        switch (instruction.op)
+        {
+            case OpCode::Compare:
+                stack.push_back(
+                    compare(comparisons[instruction.comparison], member));
+                break;
+            case OpCode::Not:
+                stack.back() = !stack.back();
+                break;
+            case OpCode::And:
+            {
+                bool right = stack.back();
+                stack.pop_back();
+                stack.back() = stack.back() && right;
+                break;
+            }
+            case OpCode::Or:
+            {
+                bool right = stack.back();
+                stack.pop_back();
+                stack.back() = stack.back() || right;
+                break;
+            }
+        }
     }
-    return value;
-}
-
-bool ApplyFilter::operator()(const filter_ast::LogicalAnd& x)
-{
-    bool value = (*this)(x.first);
-    for (const filter_ast::LogicalOr& bOp : x.rest)
+    if (stack.size() != 1)
     {
-        value = value && (*this)(bOp);
+        BMCWEB_LOG_ERROR("Filter program left {} results", stack.size());
+        return false;
     }
-    return value;
-}
-
-bool ApplyFilter::matches()
-{
-    return (*this)(filter);
-}
-
-} // namespace
-
-bool memberMatches(const nlohmann::json& member,
-                   const filter_ast::LogicalAnd& filterParam)
-{
-    ApplyFilter filterApplier(member, filterParam);
-    return filterApplier.matches();
+    return stack.back();
 }
 
 // Applies a filter expression to a member array
@@ -434,20 +553,14 @@ bool applyFilterToCollection(nlohmann::json& body,
         return false;
     }
 
-    json::array_t::iterator it = memberArr->begin();
-    size_t index = 0;
-    while (it != memberArr->end())
-    {
-        if (!memberMatches(*it, filterParam))
-        {
-            BMCWEB_LOG_DEBUG("Removing item at index {}", index);
-            it = memberArr->erase(it);
-            index++;
-            continue;
-        }
-        it++;
-        index++;
-    }
+    // Compiled once for the whole collection.  Matching members are moved
+    // down in one pass, keeping their order, rather than erasing each
+    // non-matching member where it is.
+    CompiledFilter filter(filterParam);
+    size_t removed = std::erase_if(*memberArr, [&filter](const json& member) {
+        return !filter.matches(member);
+    });
+    BMCWEB_LOG_DEBUG("Removed {} members that didn't match", removed);
 
     return true;
 }
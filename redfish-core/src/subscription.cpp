@@ -32,7 +32,9 @@
 #include <chrono>
 #include <cstdint>
 #include <functional>
+#include <initializer_list>
 #include <memory>
+#include <optional>
 #include <span>
 #include <string>
 #include <string_view>
@@ -49,7 +51,9 @@ Subscription::Subscription(
     policy(std::make_shared<crow::ConnectionPolicy>()), hbTimer(ioc)
 {
     userSub->destinationUrl = url;
-    client.emplace(ioc, policy);
+    // Connections are shared with other subscriptions to the same
+    // destination; policy still governs retries of this one's events
+    client = &crow::getSharedHttpClient();
     // Subscription constructor
     policy->invalidResp = retryRespHandler;
 }
@@ -65,26 +69,28 @@ void Subscription::resHandler(const std::shared_ptr<Subscription>& /*self*/,
 {
     BMCWEB_LOG_DEBUG("Response handled with return code: {}", res.resultInt());
 
-    if (!client)
+    if (client == nullptr)
     {
         BMCWEB_LOG_ERROR(
             "Http client wasn't filled but http client callback was called.");
-        return;
     }
+}
 
+// Called by the http client once the retry policy has given up on an event,
+// which for TerminateAfterRetries ends the subscription
+void Subscription::onRetriesExhausted(
+    const std::shared_ptr<Subscription>& /*self*/)
+{
     if (userSub->retryPolicy != "TerminateAfterRetries")
     {
         return;
     }
-    if (client->isTerminated())
+    hbTimer.cancel();
+    if (deleter)
     {
-        hbTimer.cancel();
-        if (deleter)
-        {
-            BMCWEB_LOG_INFO("Subscription {} is deleted after MaxRetryAttempts",
-                            userSub->id);
-            deleter();
-        }
+        BMCWEB_LOG_INFO("Subscription {} is deleted after MaxRetryAttempts",
+                        userSub->id);
+        deleter();
     }
 }
 
@@ -165,6 +171,13 @@ void Subscription::onHbTimeout(const std::weak_ptr<Subscription>& weakSelf,
 }
 
 bool Subscription::sendEventToSubscriber(uint64_t eventId, std::string&& msg)
+{
+    return sendEventToSubscriber(
+        eventId, std::make_shared<const std::string>(std::move(msg)));
+}
+
+bool Subscription::sendEventToSubscriber(
+    uint64_t eventId, const std::shared_ptr<const std::string>& msg)
 {
     persistent_data::EventServiceConfig eventServiceConfig =
         persistent_data::EventServiceStore::getInstance()
@@ -174,30 +187,70 @@ bool Subscription::sendEventToSubscriber(uint64_t eventId, std::string&& msg)
         return false;
     }
 
-    if (client)
+    if (client != nullptr)
     {
         boost::beast::http::fields httpHeadersCopy(userSub->httpHeaders);
         httpHeadersCopy.set(boost::beast::http::field::content_type,
                             "application/json");
         client->sendDataWithCallback(
-            std::move(msg), userSub->destinationUrl,
+            msg, userSub->destinationUrl,
             static_cast<ensuressl::VerifyCertificate>(
                 userSub->verifyCertificate),
             httpHeadersCopy, boost::beast::http::verb::post,
             std::bind_front(&Subscription::resHandler, this,
+                            shared_from_this()),
+            policy,
+            std::bind_front(&Subscription::onRetriesExhausted, this,
                             shared_from_this()));
         return true;
     }
 
     if (sseConn != nullptr)
     {
-        sseConn->sendSseEvent(std::to_string(eventId), msg);
+        // Not shared past here; each line of msg gets a "data: " prefix, so
+        // the connection frames it into its own buffer
+        sseConn->sendSseEvent(std::to_string(eventId), *msg);
     }
     return true;
 }
 
 void Subscription::filterAndSendEventLogs(
     uint64_t eventId, const std::vector<EventLogObjectsType>& eventRecords)
+{
+    std::shared_ptr<const std::string> msg =
+        filterEventLogs(eventId, eventRecords);
+    if (msg == nullptr)
+    {
+        return;
+    }
+    sendEventToSubscriber(eventId, msg);
+}
+
+std::optional<std::string> Subscription::eventLogsKey() const
+{
+    if (filter)
+    {
+        return std::nullopt;
+    }
+    // Everything filterEventLogs() reads from the subscription
+    std::string key = userSub->customText;
+    for (const std::vector<std::string>* list :
+         {&userSub->registryMsgIds, &userSub->registryPrefixes,
+          &userSub->resourceTypes, &userSub->originResources})
+    {
+        key += '\0';
+        for (const std::string& item : *list)
+        {
+            key += item;
+            key += '\x1f';
+        }
+    }
+    return key;
+}
+
+std::shared_ptr<const std::string> Subscription::filterEventLogs(
+    uint64_t& eventId,
+    const std::vector<EventLogObjectsType>& eventRecords) const
 {
     nlohmann::json::array_t logEntryArray;
     for (const EventLogObjectsType& logEntry : eventRecords)
@@ -227,7 +280,7 @@ void Subscription::filterAndSendEventLogs(
 
         if (filter)
         {
-            if (!memberMatches(bmcLogEntry, *filter))
+            if (!filter->matches(bmcLogEntry))
             {
                 BMCWEB_LOG_DEBUG("Filter didn't match");
                 continue;
@@ -241,7 +294,7 @@ void Subscription::filterAndSendEventLogs(
     if (logEntryArray.empty())
     {
         BMCWEB_LOG_DEBUG("No log entries available to be transferred.");
-        return;
+        return nullptr;
     }
 
     nlohmann::json msg;
@@ -249,36 +302,50 @@ void Subscription::filterAndSendEventLogs(
     msg["Id"] = std::to_string(eventId);
     msg["Name"] = "Event Log";
     msg["Events"] = std::move(logEntryArray);
-    std::string strMsg =
-        msg.dump(2, ' ', true, nlohmann::json::error_handler_t::replace);
-    sendEventToSubscriber(eventId, std::move(strMsg));
+    return std::make_shared<const std::string>(
+        msg.dump(2, ' ', true, nlohmann::json::error_handler_t::replace));
 }
 
 void Subscription::filterAndSendReports(uint64_t eventId,
                                         const std::string& reportId,
                                         const telemetry::TimestampReadings& var)
 {
-    boost::urls::url mrdUri = boost::urls::format(
-        "/redfish/v1/TelemetryService/MetricReportDefinitions/{}", reportId);
+    if (!reportMatches(reportId))
+    {
+        return;
+    }
+    std::shared_ptr<const std::string> msg = makeReport(reportId, var);
+    if (msg == nullptr)
+    {
+        return;
+    }
+    sendEventToSubscriber(eventId, msg);
+}
 
+bool Subscription::reportMatches(const std::string& reportId) const
+{
     // Empty list means no filter. Send everything.
-    if (!userSub->metricReportDefinitions.empty())
+    if (userSub->metricReportDefinitions.empty())
     {
-        if (std::ranges::find(userSub->metricReportDefinitions,
-                              mrdUri.buffer()) ==
-            userSub->metricReportDefinitions.end())
-        {
-            return;
-        }
+        return true;
     }
+    boost::urls::url mrdUri = boost::urls::format(
+        "/redfish/v1/TelemetryService/MetricReportDefinitions/{}", reportId);
+    return std::ranges::find(userSub->metricReportDefinitions,
+                             mrdUri.buffer()) !=
+           userSub->metricReportDefinitions.end();
+}
 
+std::shared_ptr<const std::string> Subscription::makeReport(
+    const std::string& reportId, const telemetry::TimestampReadings& var) const
+{
     nlohmann::json msg;
     if (!telemetry::fillReport(msg, reportId, var))
     {
         BMCWEB_LOG_ERROR("Failed to fill the MetricReport for DBus "
                          "Report with id {}",
                          reportId);
-        return;
+        return nullptr;
     }
 
     // Context is set by user during Event subscription and it must be
@@ -288,9 +355,8 @@ void Subscription::filterAndSendReports(uint64_t eventId,
         msg["Context"] = userSub->customText;
     }
 
-    std::string strMsg =
-        msg.dump(2, ' ', true, nlohmann::json::error_handler_t::replace);
-    sendEventToSubscriber(eventId, std::move(strMsg));
+    return std::make_shared<const std::string>(
+        msg.dump(2, ' ', true, nlohmann::json::error_handler_t::replace));
 }
 
 void Subscription::updateRetryConfig(uint32_t retryAttempts,
@@ -6,11 +6,16 @@
 #include "boost_formatters.hpp"
 #include "dbus_singleton.hpp"
 #include "logging.hpp"
+#include "mapper_cache.hpp"
+#include "single_flight.hpp"
 
 #include <boost/system/errc.hpp>
 #include <boost/system/error_code.hpp>
 #include <sdbusplus/asio/connection.hpp>
 #include <sdbusplus/asio/property.hpp>
+#include <sdbusplus/bus/match.hpp>
+#include <sdbusplus/exception.hpp>
+#include <sdbusplus/message.hpp>
 #include <sdbusplus/message/native_types.hpp>
 
 #include <array>
@@ -21,6 +26,7 @@
 #include <string>
 #include <string_view>
 #include <utility>
+#include <vector>
 
 namespace dbus
 {
@@ -42,14 +48,41 @@ void logError(const boost::system::error_code& ec)
     }
 }
 
+// Pages that fan out to many resources tend to ask for the same properties
+// several times at once, so identical calls in flight share one reply
+static bmcweb::SingleFlight<DBusPropertiesMap>& getAllPropertiesCalls()
+{
+    static bmcweb::SingleFlight<DBusPropertiesMap> calls;
+    return calls;
+}
+
+static bmcweb::SingleFlight<ManagedObjectType>& getManagedObjectsCalls()
+{
+    static bmcweb::SingleFlight<ManagedObjectType> calls;
+    return calls;
+}
+
 void getAllProperties(const std::string& service, const std::string& objectPath,
                       const std::string& interface,
                       std::function<void(const boost::system::error_code&,
                                          const DBusPropertiesMap&)>&& callback)
 {
-    sdbusplus::asio::getAllProperties(*crow::connections::systemBus, service,
-                                      objectPath, interface,
-                                      std::move(callback));
+    // Keyed by path and interface first, so that propertiesWritten() can
+    // find the calls for them on any service
+    bool called = getAllPropertiesCalls().run(
+        bmcweb::singleFlightKey({objectPath, interface, service}),
+        std::move(callback),
+        [&service, &objectPath, &interface](
+            bmcweb::SingleFlight<DBusPropertiesMap>::Callback&& reply) {
+            sdbusplus::asio::getAllProperties(*crow::connections::systemBus,
+                                              service, objectPath, interface,
+                                              std::move(reply));
+        });
+    if (!called)
+    {
+        BMCWEB_LOG_DEBUG("Sharing GetAll {} {} {} already in flight", service,
+                         objectPath, interface);
+    }
 }
 
 void getAllProperties(sdbusplus::asio::connection& /*conn*/,
@@ -75,19 +108,36 @@ void checkDbusPathExists(const std::string& path,
         std::array<std::string, 0>());
 }
 
+static MapperCacheScope mapperCacheScope(
+    std::string_view path, bool subtree,
+    std::span<const std::string_view> interfaces)
+{
+    return {std::string(path), subtree,
+            std::vector<std::string>(interfaces.begin(), interfaces.end())};
+}
+
 void getSubTree(const std::string& path, int32_t depth,
                 std::span<const std::string_view> interfaces,
                 std::function<void(const boost::system::error_code&,
                                    const MapperGetSubTreeResponse&)>&& callback)
 {
-    dbus::utility::async_method_call(
-        [callback = std::move(callback)](
-            const boost::system::error_code& ec,
-            const MapperGetSubTreeResponse& subtree) { callback(ec, subtree); },
-        "xyz.openbmc_project.ObjectMapper",
-        "/xyz/openbmc_project/object_mapper",
-        "xyz.openbmc_project.ObjectMapper", "GetSubTree", path, depth,
-        interfaces);
+    std::array<std::string_view, 1> paths{path};
+    MapperCache::getInstance().subTree.get(
+        mapperCacheKey(paths, depth, interfaces),
+        mapperCacheScope(path, true, interfaces), std::move(callback),
+        [&](std::function<void(const boost::system::error_code&,
+                               const MapperGetSubTreeResponse&)>&& reply) {
+            dbus::utility::async_method_call(
+                [reply = std::move(reply)](
+                    const boost::system::error_code& ec,
+                    const MapperGetSubTreeResponse& subtree) {
+                    reply(ec, subtree);
+                },
+                "xyz.openbmc_project.ObjectMapper",
+                "/xyz/openbmc_project/object_mapper",
+                "xyz.openbmc_project.ObjectMapper", "GetSubTree", path, depth,
+                interfaces);
+        });
 }
 
 void getSubTreePaths(
@@ -96,27 +146,35 @@ void getSubTreePaths(
     std::function<void(const boost::system::error_code&,
                        const MapperGetSubTreePathsResponse&)>&& callback)
 {
-    dbus::utility::async_method_call(
-        // ast-grep-ignore: long-lambda
-        [callback = std::move(callback)](
-            const boost::system::error_code& ec,
-            const MapperGetSubTreePathsResponse& subtreePaths) {
-            // Treat io_error (which means no objects found) as success with
-            // empty list, not an error. This is a common case when querying
-            // for objects that may not exist (e.g., no certificates installed).
-            if (ec && ec.value() == boost::system::errc::io_error)
-            {
-                callback(boost::system::errc::make_error_code(
-                             boost::system::errc::success),
-                         MapperGetSubTreePathsResponse{});
-                return;
-            }
-            callback(ec, subtreePaths);
-        },
-        "xyz.openbmc_project.ObjectMapper",
-        "/xyz/openbmc_project/object_mapper",
-        "xyz.openbmc_project.ObjectMapper", "GetSubTreePaths", path, depth,
-        interfaces);
+    std::array<std::string_view, 1> paths{path};
+    MapperCache::getInstance().subTreePaths.get(
+        mapperCacheKey(paths, depth, interfaces),
+        mapperCacheScope(path, true, interfaces), std::move(callback),
+        [&](std::function<void(const boost::system::error_code&,
+                               const MapperGetSubTreePathsResponse&)>&& reply) {
+            dbus::utility::async_method_call(
+                // ast-grep-ignore: long-lambda
+                [reply = std::move(reply)](
+                    const boost::system::error_code& ec,
+                    const MapperGetSubTreePathsResponse& subtreePaths) {
+                    // Treat io_error (which means no objects found) as success
+                    // with empty list, not an error. This is a common case
+                    // when querying for objects that may not exist (e.g., no
+                    // certificates installed).
+                    if (ec && ec.value() == boost::system::errc::io_error)
+                    {
+                        reply(boost::system::errc::make_error_code(
+                                  boost::system::errc::success),
+                              MapperGetSubTreePathsResponse{});
+                        return;
+                    }
+                    reply(ec, subtreePaths);
+                },
+                "xyz.openbmc_project.ObjectMapper",
+                "/xyz/openbmc_project/object_mapper",
+                "xyz.openbmc_project.ObjectMapper", "GetSubTreePaths", path,
+                depth, interfaces);
+        });
 }
 
 void getAssociatedSubTree(
@@ -126,14 +184,23 @@ void getAssociatedSubTree(
     std::function<void(const boost::system::error_code&,
                        const MapperGetSubTreeResponse&)>&& callback)
 {
-    dbus::utility::async_method_call(
-        [callback = std::move(callback)](
-            const boost::system::error_code& ec,
-            const MapperGetSubTreeResponse& subtree) { callback(ec, subtree); },
-        "xyz.openbmc_project.ObjectMapper",
-        "/xyz/openbmc_project/object_mapper",
-        "xyz.openbmc_project.ObjectMapper", "GetAssociatedSubTree",
-        associatedPath, path, depth, interfaces);
+    std::array<std::string_view, 2> paths{associatedPath.str, path.str};
+    MapperCache::getInstance().associatedSubTree.get(
+        mapperCacheKey(paths, depth, interfaces),
+        mapperCacheScope(path.str, true, interfaces), std::move(callback),
+        [&](std::function<void(const boost::system::error_code&,
+                               const MapperGetSubTreeResponse&)>&& reply) {
+            dbus::utility::async_method_call(
+                [reply = std::move(reply)](
+                    const boost::system::error_code& ec,
+                    const MapperGetSubTreeResponse& subtree) {
+                    reply(ec, subtree);
+                },
+                "xyz.openbmc_project.ObjectMapper",
+                "/xyz/openbmc_project/object_mapper",
+                "xyz.openbmc_project.ObjectMapper", "GetAssociatedSubTree",
+                associatedPath, path, depth, interfaces);
+        });
 }
 
 void getAssociatedSubTreePaths(
@@ -220,14 +287,23 @@ void getDbusObject(const std::string& path,
                    std::function<void(const boost::system::error_code&,
                                       const MapperGetObject&)>&& callback)
 {
-    dbus::utility::async_method_call(
-        [callback = std::move(callback)](const boost::system::error_code& ec,
-                                         const MapperGetObject& object) {
-            callback(ec, object);
-        },
-        "xyz.openbmc_project.ObjectMapper",
-        "/xyz/openbmc_project/object_mapper",
-        "xyz.openbmc_project.ObjectMapper", "GetObject", path, interfaces);
+    // GetObject takes no depth; 0 keeps its keys apart from other lookups
+    std::array<std::string_view, 1> paths{path};
+    MapperCache::getInstance().object.get(
+        mapperCacheKey(paths, 0, interfaces),
+        mapperCacheScope(path, false, interfaces), std::move(callback),
+        [&](std::function<void(const boost::system::error_code&,
+                               const MapperGetObject&)>&& reply) {
+            dbus::utility::async_method_call(
+                [reply = std::move(reply)](const boost::system::error_code& ec,
+                                           const MapperGetObject& object) {
+                    reply(ec, object);
+                },
+                "xyz.openbmc_project.ObjectMapper",
+                "/xyz/openbmc_project/object_mapper",
+                "xyz.openbmc_project.ObjectMapper", "GetObject", path,
+                interfaces);
+        });
 }
 
 void getAssociationEndPoints(
@@ -245,13 +321,196 @@ void getManagedObjects(const std::string& service,
                        std::function<void(const boost::system::error_code&,
                                           const ManagedObjectType&)>&& callback)
 {
-    dbus::utility::async_method_call(
-        [callback = std::move(callback)](const boost::system::error_code& ec,
-                                         const ManagedObjectType& objects) {
-            callback(ec, objects);
-        },
-        service, path, "org.freedesktop.DBus.ObjectManager",
-        "GetManagedObjects");
+    bool called = getManagedObjectsCalls().run(
+        bmcweb::singleFlightKey({path.str, service}), std::move(callback),
+        [&service,
+         &path](bmcweb::SingleFlight<ManagedObjectType>::Callback&& reply) {
+            dbus::utility::async_method_call(
+                [reply = std::move(reply)](const boost::system::error_code& ec,
+                                           const ManagedObjectType& objects) {
+                    reply(ec, objects);
+                },
+                service, path, "org.freedesktop.DBus.ObjectManager",
+                "GetManagedObjects");
+        });
+    if (!called)
+    {
+        BMCWEB_LOG_DEBUG("Sharing GetManagedObjects {} {} already in flight",
+                         service, path.str);
+    }
+}
+
+// Whether objectPath is root, or below it
+static bool isUnderPath(std::string_view objectPath, std::string_view root)
+{
+    if (root == "/" || objectPath == root)
+    {
+        return true;
+    }
+    return objectPath.starts_with(root) &&
+           objectPath.substr(root.size(), 1) == "/";
+}
+
+// Objects below path were added, removed or changed, so GetManagedObjects
+// calls already in flight for them may reply with what was there before.
+static void objectsChanged(std::string_view path)
+{
+    getManagedObjectsCalls().detachIf([path](std::string_view key) {
+        return isUnderPath(path, key.substr(0, key.find('\0')));
+    });
+}
+
+static std::vector<std::function<void(std::string_view)>>&
+    propertyCallsDetachers()
+{
+    static std::vector<std::function<void(std::string_view)>> detachers;
+    return detachers;
+}
+
+namespace details
+{
+void addPropertyCallsDetacher(std::function<void(std::string_view)>&& detach)
+{
+    propertyCallsDetachers().emplace_back(std::move(detach));
+}
+} // namespace details
+
+void propertiesWritten(std::string_view path, std::string_view interface)
+{
+    std::string prefix = bmcweb::singleFlightKey({path, interface});
+    getAllPropertiesCalls().detachIf(
+        [&prefix](std::string_view key) { return key.starts_with(prefix); });
+    for (const std::function<void(std::string_view)>& detach :
+         propertyCallsDetachers())
+    {
+        detach(prefix);
+    }
+    objectsChanged(path);
+}
+
+static void onInterfacesAdded(sdbusplus::message_t& msg)
+{
+    sdbusplus::object_path path;
+    DBusInterfacesMap interfaces;
+    try
+    {
+        msg.read(path, interfaces);
+    }
+    catch (const sdbusplus::exception_t& e)
+    {
+        BMCWEB_LOG_ERROR("Failed to read InterfacesAdded signal: {}",
+                         e.what());
+        MapperCache::getInstance().invalidate();
+        return;
+    }
+    std::vector<std::string> names;
+    names.reserve(interfaces.size());
+    for (const auto& interface : interfaces)
+    {
+        names.emplace_back(interface.first);
+    }
+    MapperCache::getInstance().invalidate(path.str, names);
+    objectsChanged(path.str);
+}
+
+static void onInterfacesRemoved(sdbusplus::message_t& msg)
+{
+    sdbusplus::object_path path;
+    std::vector<std::string> interfaces;
+    try
+    {
+        msg.read(path, interfaces);
+    }
+    catch (const sdbusplus::exception_t& e)
+    {
+        BMCWEB_LOG_ERROR("Failed to read InterfacesRemoved signal: {}",
+                         e.what());
+        MapperCache::getInstance().invalidate();
+        return;
+    }
+    MapperCache::getInstance().invalidate(path.str, interfaces);
+    objectsChanged(path.str);
+}
+
+static void onAssociationChanged(sdbusplus::message_t& /*msg*/)
+{
+    // Only the associated subtree lookups follow endpoints
+    MapperCache::getInstance().associatedSubTree.invalidate();
+}
+
+static void onNameOwnerChanged(sdbusplus::message_t& msg)
+{
+    std::string name;
+    std::string oldOwner;
+    std::string newOwner;
+    try
+    {
+        msg.read(name, oldOwner, newOwner);
+    }
+    catch (const sdbusplus::exception_t& e)
+    {
+        BMCWEB_LOG_ERROR("Failed to read NameOwnerChanged signal: {}",
+                         e.what());
+        MapperCache::getInstance().invalidate();
+        return;
+    }
+    // The mapper only tracks services with well known names; every client
+    // that connects to the bus gets a unique name, and those can be ignored.
+    if (name.starts_with(':'))
+    {
+        return;
+    }
+    if (newOwner.empty())
+    {
+        // The mapper drops a service's objects as soon as it leaves
+        MapperCache::getInstance().invalidate();
+        return;
+    }
+    MapperCache::getInstance().serviceStarted(name);
+}
+
+static void onIntrospectionComplete(sdbusplus::message_t& msg)
+{
+    std::string name;
+    try
+    {
+        msg.read(name);
+    }
+    catch (const sdbusplus::exception_t& e)
+    {
+        BMCWEB_LOG_ERROR("Failed to read IntrospectionComplete signal: {}",
+                         e.what());
+        return;
+    }
+    MapperCache::getInstance().introspectionComplete(name);
+}
+
+void registerMapperCacheSignals()
+{
+    static sdbusplus::match interfacesAddedMatch(
+        *crow::connections::systemBus,
+        sdbusplus::match_rules::interfacesAdded(), onInterfacesAdded);
+    static sdbusplus::match interfacesRemovedMatch(
+        *crow::connections::systemBus,
+        sdbusplus::match_rules::interfacesRemoved(), onInterfacesRemoved);
+    // Association endpoints, which GetAssociatedSubTree follows, change
+    // through properties rather than interfaces.
+    static sdbusplus::match associationsChangedMatch(
+        *crow::connections::systemBus,
+        sdbusplus::match_rules::propertiesChangedNamespace(
+            "/", "xyz.openbmc_project.Association"),
+        onAssociationChanged);
+    static sdbusplus::match nameOwnerChangedMatch(
+        *crow::connections::systemBus,
+        sdbusplus::match_rules::nameOwnerChanged(), onNameOwnerChanged);
+    // Sent by the mapper once it knows the objects of a new service
+    static sdbusplus::match introspectionCompleteMatch(
+        *crow::connections::systemBus,
+        sdbusplus::match_rules::type::signal() +
+            sdbusplus::match_rules::member("IntrospectionComplete") +
+            sdbusplus::match_rules::interface(
+                "xyz.openbmc_project.ObjectMapper.Private"),
+        onIntrospectionComplete);
 }
 
 } // namespace utility
@@ -7,6 +7,7 @@
 #include "app.hpp"
 #include "dbus_monitor.hpp"
 #include "dbus_singleton.hpp"
+#include "dbus_utility.hpp"
 #include "event_service_manager.hpp"
 #include "google_service_root.hpp"
 #include "hostname_monitor.hpp"
@@ -129,6 +130,7 @@ int runWebserver()
         crow::hostname_monitor::registerHostnameSignal();
     }
 
+    dbus::utility::registerMapperCacheSignals();
     bmcweb::registerUserRemovedSignal();
     bmcweb::registerUserPropertiesChangedSignal();
     bmcweb::ServiceWatchdog watchdog;
@@ -58,7 +58,7 @@ struct FakeHandler
     }
 };
 
-std::string getDateStr()
+std::string_view getDateStr()
 {
     return "TestTime";
 }
@@ -126,7 +126,7 @@ TEST(http_connection, RequestPropogates)
 
     FakeHandler handler;
     boost::asio::steady_timer timer(io);
-    std::function<std::string()> date(getDateStr);
+    std::function<std::string_view()> date(getDateStr);
     boost::asio::ssl::context sslCtx(boost::asio::ssl::context::tls_server);
     auto conn = std::make_shared<HTTP2Connection<TestStream, FakeHandler>>(
         boost::asio::ssl::stream<TestStream>(std::move(stream), sslCtx),
@@ -3,14 +3,21 @@
 #include "duplicatable_file_handle.hpp"
 #include "http_body.hpp"
 
+#include <boost/beast/core/error.hpp>
 #include <boost/beast/core/file_base.hpp>
+#include <boost/beast/http/fields.hpp>
+#include <boost/beast/http/message.hpp>
 #include <boost/system/error_code.hpp>
+#include <nlohmann/json.hpp>
 
 #include <array>
 #include <cstddef>
 #include <cstdio>
+#include <memory>
+#include <optional>
 #include <span>
 #include <string>
+#include <string_view>
 #include <utility>
 
 #include <gmock/gmock.h>
@@ -136,5 +143,64 @@ TEST(HttpFileBodyValueType, SetFd)
     EXPECT_EQ(value.payloadSize(), 16);
 }
 
+TEST(HttpHttpBodyValueType, SharedBody)
+{
+    auto data = std::make_shared<const std::string>("shared contents");
+    HttpBody::value_type value;
+    value.setShared(data);
+    EXPECT_TRUE(value.isShared());
+    EXPECT_EQ(value.payloadSize(), data->size());
+
+    // Copies share the same contents
+    HttpBody::value_type copy = value;
+    EXPECT_EQ(copy.payloadSize(), data->size());
+    EXPECT_EQ(data.use_count(), 3);
+
+    boost::beast::http::header<false, boost::beast::http::fields> header;
+    HttpBody::writer writer(header, copy);
+    boost::beast::error_code ec;
+    auto chunk = writer.getWithMaxSize(ec, 6);
+    ASSERT_FALSE(ec);
+    ASSERT_TRUE(chunk);
+    EXPECT_EQ(std::string_view(static_cast<const char*>(chunk->first.data()),
+                               chunk->first.size()),
+              "shared");
+    EXPECT_TRUE(chunk->second);
+}
+
+TEST(HttpHttpBodyWriter, JsonChunksRespectMaxSize)
+{
+    nlohmann::json json;
+    for (size_t i = 0; i < 500; i++)
+    {
+        json["Members"].push_back(
+            {{"@odata.id", "/redfish/v1/" + std::to_string(i)}});
+    }
+    std::string expected = json.dump(2, ' ', true,
+                                     nlohmann::json::error_handler_t::replace);
+
+    HttpBody::value_type value;
+    value.setJson(std::move(json), 2);
+    EXPECT_TRUE(value.isJson());
+    EXPECT_EQ(value.payloadSize(), std::nullopt);
+
+    boost::beast::http::header<false, boost::beast::http::fields> header;
+    HttpBody::writer writer(header, value);
+    std::string out;
+    bool more = true;
+    while (more)
+    {
+        boost::beast::error_code ec;
+        auto chunk = writer.getWithMaxSize(ec, 100);
+        ASSERT_FALSE(ec);
+        ASSERT_TRUE(chunk);
+        EXPECT_LE(chunk->first.size(), 100U);
+        out.append(static_cast<const char*>(chunk->first.data()),
+                   chunk->first.size());
+        more = chunk->second;
+    }
+    EXPECT_EQ(out, expected);
+}
+
 } // namespace
 } // namespace bmcweb
@@ -0,0 +1,268 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+#include "http/http_client.hpp"
+#include "http_response.hpp"
+#include "ssl_key_handler.hpp"
+
+#include <boost/asio/buffer.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/address_v4.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/ssl/context.hpp>
+#include <boost/asio/ssl/stream.hpp>
+#include <boost/asio/ssl/stream_base.hpp>
+#include <boost/beast/core/flat_buffer.hpp>
+#include <boost/beast/http/fields.hpp>
+#include <boost/beast/http/message.hpp>
+#include <boost/beast/http/read.hpp>
+#include <boost/beast/http/status.hpp>
+#include <boost/beast/http/string_body.hpp>
+#include <boost/beast/http/verb.hpp>
+#include <boost/beast/http/write.hpp>
+#include <boost/system/errc.hpp>
+#include <boost/system/error_code.hpp>
+#include <boost/url/format.hpp>
+#include <boost/url/url.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include <gtest/gtest.h>
+
+namespace crow
+{
+namespace
+{
+
+namespace http = boost::beast::http;
+
+// An HTTPS server on localhost that answers every request with status, and
+// counts the connections and TLS handshakes it sees
+class HttpsSink
+{
+  public:
+    explicit HttpsSink(boost::asio::io_context& io) :
+        acceptor(io, boost::asio::ip::tcp::endpoint(
+                         boost::asio::ip::address_v4::loopback(), 0)),
+        ctx(boost::asio::ssl::context::tls_server)
+    {
+        std::string pem = ensuressl::generateSslCertificate("localhost");
+        ctx.use_certificate_chain(boost::asio::buffer(pem));
+        ctx.use_private_key(boost::asio::buffer(pem),
+                            boost::asio::ssl::context::pem);
+        accept();
+    }
+
+    boost::urls::url url() const
+    {
+        return boost::urls::format("https://127.0.0.1:{}/events",
+                                   acceptor.local_endpoint().port());
+    }
+
+    http::status status = http::status::ok;
+    size_t connections = 0;
+    size_t handshakes = 0;
+    size_t requests = 0;
+
+  private:
+    struct Session : std::enable_shared_from_this<Session>
+    {
+        Session(HttpsSink& sinkIn, boost::asio::ip::tcp::socket&& socket) :
+            sink(sinkIn), stream(std::move(socket), sinkIn.ctx)
+        {}
+
+        void start()
+        {
+            stream.async_handshake(
+                boost::asio::ssl::stream_base::server,
+                [self = shared_from_this()](
+                    const boost::system::error_code& ec) {
+                    if (ec)
+                    {
+                        return;
+                    }
+                    self->sink.handshakes++;
+                    self->read();
+                });
+        }
+
+        void read()
+        {
+            req = {};
+            http::async_read(
+                stream, buffer, req,
+                [self = shared_from_this()](
+                    const boost::system::error_code& ec, size_t /*size*/) {
+                    if (ec)
+                    {
+                        return;
+                    }
+                    self->sink.requests++;
+                    self->write();
+                });
+        }
+
+        void write()
+        {
+            res = {sink.status, 11};
+            res.keep_alive(true);
+            res.prepare_payload();
+            http::async_write(
+                stream, res,
+                [self = shared_from_this()](
+                    const boost::system::error_code& ec, size_t /*size*/) {
+                    if (!ec)
+                    {
+                        self->read();
+                    }
+                });
+        }
+
+        HttpsSink& sink;
+        boost::asio::ssl::stream<boost::asio::ip::tcp::socket> stream;
+        boost::beast::flat_buffer buffer;
+        http::request<http::string_body> req;
+        http::response<http::string_body> res;
+    };
+
+    void accept()
+    {
+        acceptor.async_accept([this](const boost::system::error_code& ec,
+                                     boost::asio::ip::tcp::socket socket) {
+            if (ec)
+            {
+                return;
+            }
+            connections++;
+            std::make_shared<Session>(*this, std::move(socket))->start();
+            accept();
+        });
+    }
+
+    boost::asio::ip::tcp::acceptor acceptor;
+    boost::asio::ssl::context ctx;
+};
+
+TEST(HttpClient, SendersToOneDestinationShareAConnection)
+{
+    boost::asio::io_context io;
+    HttpsSink sink(io);
+    HttpClient client(io, std::make_shared<ConnectionPolicy>());
+
+    // Like event subscriptions, each sender has its own policy
+    constexpr size_t senders = 10;
+    size_t responses = 0;
+    for (size_t i = 0; i < senders; i++)
+    {
+        client.sendDataWithCallback(
+            "{}", sink.url(), ensuressl::VerifyCertificate::NoVerify, {},
+            http::verb::post,
+            [&responses, &io](Response& res) {
+                EXPECT_EQ(res.result(), http::status::ok);
+                responses++;
+                if (responses == senders)
+                {
+                    io.stop();
+                }
+            },
+            std::make_shared<ConnectionPolicy>());
+    }
+    io.run_for(std::chrono::seconds(10));
+
+    EXPECT_EQ(responses, senders);
+    EXPECT_EQ(sink.requests, senders);
+    EXPECT_EQ(sink.connections, 1U);
+    EXPECT_EQ(sink.handshakes, 1U);
+}
+
+TEST(HttpClient, EachRequestUsesItsSendersRetryPolicy)
+{
+    boost::asio::io_context io;
+    HttpsSink sink(io);
+    HttpClient client(io, std::make_shared<ConnectionPolicy>());
+
+    // Rejects every response, and gives up without retrying
+    std::shared_ptr<ConnectionPolicy> strict =
+        std::make_shared<ConnectionPolicy>();
+    strict->maxRetryAttempts = 0;
+    strict->invalidResp = [](unsigned int /*respCode*/) {
+        return boost::system::errc::make_error_code(
+            boost::system::errc::result_out_of_range);
+    };
+
+    int replies = 0;
+    http::status lenientResult = http::status::unknown;
+    http::status strictResult = http::status::unknown;
+    auto reply = [&replies, &io](http::status& result) {
+        return [&replies, &io, &result](Response& res) {
+            result = res.result();
+            replies++;
+            if (replies == 2)
+            {
+                io.stop();
+            }
+        };
+    };
+    client.sendDataWithCallback(
+        "{}", sink.url(), ensuressl::VerifyCertificate::NoVerify, {},
+        http::verb::post, reply(lenientResult),
+        std::make_shared<ConnectionPolicy>());
+    client.sendDataWithCallback(
+        "{}", sink.url(), ensuressl::VerifyCertificate::NoVerify, {},
+        http::verb::post, reply(strictResult), strict);
+    io.run_for(std::chrono::seconds(10));
+
+    EXPECT_EQ(lenientResult, http::status::ok);
+    EXPECT_EQ(strictResult, http::status::bad_gateway);
+}
+
+TEST(HttpClient, ReportsRetriesExhaustedApartFromServer502)
+{
+    boost::asio::io_context io;
+    HttpsSink sink(io);
+    sink.status = http::status::bad_gateway;
+    HttpClient client(io, std::make_shared<ConnectionPolicy>());
+
+    // Passes every response on, like aggregation does
+    std::shared_ptr<ConnectionPolicy> acceptAll =
+        std::make_shared<ConnectionPolicy>();
+    acceptAll->invalidResp = [](unsigned int /*respCode*/) {
+        return boost::system::errc::make_error_code(
+            boost::system::errc::success);
+    };
+    // Gives up on the first 502
+    std::shared_ptr<ConnectionPolicy> giveUp =
+        std::make_shared<ConnectionPolicy>();
+    giveUp->maxRetryAttempts = 0;
+
+    int replies = 0;
+    int acceptAllExhausted = 0;
+    int giveUpExhausted = 0;
+    auto reply = [&replies, &io](Response& res) {
+        EXPECT_EQ(res.result(), http::status::bad_gateway);
+        replies++;
+        if (replies == 2)
+        {
+            io.stop();
+        }
+    };
+    client.sendDataWithCallback(
+        "{}", sink.url(), ensuressl::VerifyCertificate::NoVerify, {},
+        http::verb::post, reply, acceptAll,
+        [&acceptAllExhausted]() { acceptAllExhausted++; });
+    client.sendDataWithCallback(
+        "{}", sink.url(), ensuressl::VerifyCertificate::NoVerify, {},
+        http::verb::post, reply, giveUp,
+        [&giveUpExhausted]() { giveUpExhausted++; });
+    io.run_for(std::chrono::seconds(10));
+
+    EXPECT_EQ(replies, 2);
+    EXPECT_EQ(acceptAllExhausted, 0);
+    EXPECT_EQ(giveUpExhausted, 1);
+}
+
+} // namespace
+} // namespace crow
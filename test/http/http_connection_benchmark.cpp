@@ -0,0 +1,129 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+
+// Times a burst of pipelined requests whose handlers each wait on something
+// slow, like a D-Bus call, to show how much of that wait the connection
+// overlaps.  Run with `meson test --benchmark http_connection_benchmark -v`.
+
+#include "async_resp.hpp"
+#include "http/http_connection.hpp"
+#include "http/http_request.hpp"
+#include "http_connect_types.hpp"
+#include "logging.hpp"
+#include "test_stream.hpp"
+
+#include <boost/asio/buffer.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ssl/context.hpp>
+#include <boost/asio/ssl/stream.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/system/error_code.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace
+{
+
+constexpr size_t requests = 8;
+constexpr std::chrono::milliseconds handlerLatency(5);
+
+struct SlowHandler
+{
+    explicit SlowHandler(boost::asio::io_context& ioIn) : io(ioIn) {}
+
+    template <typename Adaptor>
+    static void handleUpgrade(
+        const std::shared_ptr<crow::Request>& /*req*/,
+        const std::shared_ptr<bmcweb::AsyncResp>& /*asyncResp*/,
+        Adaptor&& /*adaptor*/)
+    {}
+
+    void handle(const std::shared_ptr<crow::Request>& /*req*/,
+                const std::shared_ptr<bmcweb::AsyncResp>& asyncResp)
+    {
+        auto timer = std::make_shared<boost::asio::steady_timer>(io);
+        timer->expires_after(handlerLatency);
+        timer->async_wait(
+            [timer, asyncResp](const boost::system::error_code& /*ec*/) {
+                asyncResp->res.write("done");
+            });
+    }
+
+    boost::asio::io_context& io;
+};
+
+std::string_view benchmarkDateStr()
+{
+    return "BenchmarkTime";
+}
+
+// Sends requests with method back to back on one connection, and returns
+// how long it takes for all of them to be answered
+std::chrono::microseconds timeBurst(std::string_view method)
+{
+    boost::asio::io_context io;
+    crow::TestStream stream(io);
+    crow::TestStream out(io);
+    stream.connect(out);
+
+    std::string burst;
+    for (size_t i = 0; i < requests; i++)
+    {
+        burst += method;
+        burst += " /redfish/v1/ HTTP/1.1\r\nHost: localhost\r\n";
+        if (method != "GET")
+        {
+            burst += "Content-Length: 2\r\n";
+        }
+        if (i + 1 == requests)
+        {
+            burst += "Connection: close\r\n";
+        }
+        burst += "\r\n";
+        if (method != "GET")
+        {
+            burst += "{}";
+        }
+    }
+    out.write_some(boost::asio::buffer(burst));
+
+    SlowHandler handler(io);
+    std::function<std::string_view()> date(benchmarkDateStr);
+    boost::asio::ssl::context context{boost::asio::ssl::context::tls};
+    auto conn = std::make_shared<
+        crow::Connection<crow::TestStream, SlowHandler>>(
+        &handler, crow::HttpType::HTTP, boost::asio::steady_timer(io), date,
+        boost::asio::ssl::stream<crow::TestStream>(std::move(stream),
+                                                   context));
+    conn->disableAuth();
+
+    auto start = std::chrono::steady_clock::now();
+    conn->start();
+    io.run();
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start);
+}
+
+} // namespace
+
+int main()
+{
+    crow::getBmcwebCurrentLoggingLevel() = crow::LogLevel::Error;
+    std::printf("%zu requests, each handler waits %lld ms\n", requests,
+                static_cast<long long>(handlerLatency.count()));
+    // GETs are handled together; PATCHes wait for the one before them
+    for (std::string_view method : {"GET", "PATCH"})
+    {
+        std::chrono::microseconds elapsed = timeBurst(method);
+        std::printf("%-5s %8lld us\n", std::string(method).c_str(),
+                    static_cast<long long>(elapsed.count()));
+    }
+    return 0;
+}
@@ -24,6 +24,7 @@
 #include <functional>
 #include <memory>
 #include <string>
+#include <string_view>
 #include <utility>
 
 struct FuzzHandler
@@ -48,7 +49,7 @@ struct FuzzHandler
     }
 };
 
-std::string fuzzDateStr()
+std::string_view fuzzDateStr()
 {
     return "FuzzTime";
 }
@@ -125,7 +126,7 @@ int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size)
 
     FuzzHandler handler;
     boost::asio::steady_timer timer(io);
-    std::function<std::string()> date(&fuzzDateStr);
+    std::function<std::string_view()> date(&fuzzDateStr);
 
     boost::asio::ssl::context ctx{boost::asio::ssl::context::tls};
 
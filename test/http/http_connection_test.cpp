@@ -14,12 +14,16 @@
 #include <boost/beast/_experimental/test/stream.hpp>
 #include <boost/beast/http/field.hpp>
 #include <boost/beast/http/verb.hpp>
+#include <boost/system/error_code.hpp>
 
 #include <chrono>
+#include <cstddef>
 #include <functional>
 #include <memory>
 #include <string>
+#include <string_view>
 #include <utility>
+#include <vector>
 
 #include "gtest/gtest.h"
 namespace crow
@@ -56,7 +60,7 @@ struct FakeHandler
 struct ClockFake
 {
     bool wascalled = false;
-    std::string getDateStr()
+    std::string_view getDateStr()
     {
         wascalled = true;
         return "TestTime";
@@ -79,7 +83,7 @@ TEST(http_connection, RequestPropogates)
         "Hello, World!"));
     FakeHandler handler;
     boost::asio::steady_timer timer(io);
-    std::function<std::string()> date(
+    std::function<std::string_view()> date(
         std::bind_front(&ClockFake::getDateStr, &clock));
 
     boost::asio::ssl::context context{boost::asio::ssl::context::tls};
@@ -106,4 +110,158 @@ TEST(http_connection, RequestPropogates)
     EXPECT_TRUE(clock.wascalled);
 }
 
+struct PipelineHandler
+{
+    template <typename Adaptor>
+    static void handleUpgrade(
+        const std::shared_ptr<Request>& /*req*/,
+        const std::shared_ptr<bmcweb::AsyncResp>& /*asyncResp*/,
+        Adaptor&& /*adaptor*/)
+    {
+        EXPECT_FALSE(true);
+    }
+
+    // Holds on to every response until all requests have arrived, then
+    // completes them newest first.
+    void handle(const std::shared_ptr<Request>& req,
+                const std::shared_ptr<bmcweb::AsyncResp>& asyncResp)
+    {
+        asyncResp->res.write(std::string(req->target()));
+        held.push_back(asyncResp);
+        if (held.size() == expected)
+        {
+            while (!held.empty())
+            {
+                held.pop_back();
+            }
+        }
+    }
+
+    size_t expected = 0;
+    std::vector<std::shared_ptr<bmcweb::AsyncResp>> held;
+};
+
+TEST(http_connection, PipelinedResponsesAreInOrder)
+{
+    boost::asio::io_context io;
+    ClockFake clock;
+    TestStream stream(io);
+    TestStream out(io);
+    stream.connect(out);
+
+    out.write_some(boost::asio::buffer(
+        "GET /first HTTP/1.1\r\n"
+        "Host: openbmc_project.xyz\r\n\r\n"
+        "GET /second HTTP/1.1\r\n"
+        "Host: openbmc_project.xyz\r\n\r\n"
+        "GET /third HTTP/1.1\r\n"
+        "Host: openbmc_project.xyz\r\n"
+        "Connection: close\r\n\r\n"));
+    PipelineHandler handler;
+    handler.expected = 3;
+    boost::asio::steady_timer timer(io);
+    std::function<std::string_view()> date(
+        std::bind_front(&ClockFake::getDateStr, &clock));
+
+    boost::asio::ssl::context context{boost::asio::ssl::context::tls};
+    std::shared_ptr<Connection<TestStream, PipelineHandler>> conn =
+        std::make_shared<Connection<TestStream, PipelineHandler>>(
+            &handler, HttpType::HTTP, std::move(timer), date,
+            boost::asio::ssl::stream<TestStream>(std::move(stream), context));
+    conn->disableAuth();
+    conn->start();
+    io.run_for(std::chrono::seconds(1000));
+    EXPECT_TRUE(handler.held.empty());
+
+    std::string outStr = out.str();
+    size_t first = outStr.find("/first");
+    size_t second = outStr.find("/second");
+    size_t third = outStr.find("/third");
+    ASSERT_NE(first, std::string::npos);
+    ASSERT_NE(second, std::string::npos);
+    ASSERT_NE(third, std::string::npos);
+    EXPECT_LT(first, second);
+    EXPECT_LT(second, third);
+}
+
+// Holds the response to a PATCH for a while, and records when each request
+// reaches it
+struct UnsafePipelineHandler
+{
+    explicit UnsafePipelineHandler(boost::asio::io_context& io) : timer(io) {}
+
+    template <typename Adaptor>
+    static void handleUpgrade(
+        const std::shared_ptr<Request>& /*req*/,
+        const std::shared_ptr<bmcweb::AsyncResp>& /*asyncResp*/,
+        Adaptor&& /*adaptor*/)
+    {
+        EXPECT_FALSE(true);
+    }
+
+    void handle(const std::shared_ptr<Request>& req,
+                const std::shared_ptr<bmcweb::AsyncResp>& asyncResp)
+    {
+        std::string target(req->target());
+        events.emplace_back(std::string(req->methodString()) + " " + target);
+        asyncResp->res.write(std::move(target));
+        if (req->method() != boost::beast::http::verb::patch)
+        {
+            return;
+        }
+        timer.expires_after(std::chrono::milliseconds(50));
+        // The response is sent once the last copy of asyncResp goes
+        timer.async_wait(
+            [this, asyncResp](const boost::system::error_code& /*ec*/) {
+                events.emplace_back("done PATCH");
+            });
+    }
+
+    boost::asio::steady_timer timer;
+    std::vector<std::string> events;
+};
+
+TEST(http_connection, PipelinedRequestWaitsForUnsafeOne)
+{
+    boost::asio::io_context io;
+    ClockFake clock;
+    TestStream stream(io);
+    TestStream out(io);
+    stream.connect(out);
+
+    out.write_some(boost::asio::buffer(
+        "PATCH /first HTTP/1.1\r\n"
+        "Host: openbmc_project.xyz\r\n"
+        "Content-Length: 2\r\n\r\n"
+        "{}"
+        "GET /second HTTP/1.1\r\n"
+        "Host: openbmc_project.xyz\r\n"
+        "Connection: close\r\n\r\n"));
+    UnsafePipelineHandler handler(io);
+    boost::asio::steady_timer timer(io);
+    std::function<std::string_view()> date(
+        std::bind_front(&ClockFake::getDateStr, &clock));
+
+    boost::asio::ssl::context context{boost::asio::ssl::context::tls};
+    std::shared_ptr<Connection<TestStream, UnsafePipelineHandler>> conn =
+        std::make_shared<Connection<TestStream, UnsafePipelineHandler>>(
+            &handler, HttpType::HTTP, std::move(timer), date,
+            boost::asio::ssl::stream<TestStream>(std::move(stream), context));
+    conn->disableAuth();
+    conn->start();
+    io.run_for(std::chrono::seconds(1000));
+
+    // The GET isn't handled until the PATCH has finished
+    std::vector<std::string> expected = {"PATCH /first", "done PATCH",
+                                         "GET /second"};
+    EXPECT_EQ(handler.events, expected);
+
+    std::string outStr = out.str();
+    size_t first = outStr.find("/first");
+    size_t second = outStr.find("/second");
+    ASSERT_NE(first, std::string::npos);
+    ASSERT_NE(second, std::string::npos);
+    EXPECT_LT(first, second);
+}
+
 } // namespace crow
@@ -4,6 +4,7 @@
 #include "http/complete_response_fields.hpp"
 #include "http/http_body.hpp"
 #include "http/http_response.hpp"
+#include "json_stream_serializer.hpp"
 #include "utility.hpp"
 
 #include <boost/beast/core/buffers_to_string.hpp>
@@ -11,9 +12,12 @@
 #include <boost/beast/core/file_posix.hpp>
 #include <boost/beast/http/serializer.hpp>
 #include <boost/beast/http/status.hpp>
+#include <nlohmann/json.hpp>
 
+#include <cstddef>
 #include <cstdio>
 #include <filesystem>
+#include <optional>
 #include <string>
 
 #include "gtest/gtest.h"
@@ -218,5 +222,74 @@ TEST(HttpResponse, ZstdHandleEncodingDoesNotCloseFileFd)
     EXPECT_EQ(getData(res.response), data);
 }
 
+TEST(HttpResponse, SmallJsonIsSerializedUpFront)
+{
+    Response res;
+    res.jsonValue["Name"] = "small";
+    completeResponseFields("application/json", "", res);
+    EXPECT_FALSE(res.response.body().isJson());
+    EXPECT_EQ(*res.body(), "{\"Name\":\"small\"}");
+}
+
+TEST(HttpResponse, JsonIndentationIsNegotiated)
+{
+    Response pretty;
+    pretty.jsonValue["Name"] = "small";
+    completeResponseFields("*/*", "", pretty);
+    EXPECT_EQ(*pretty.body(), "{\n  \"Name\": \"small\"\n}");
+
+    Response requested;
+    requested.jsonValue["Name"] = "small";
+    completeResponseFields("application/json;indent=4", "", requested);
+    EXPECT_EQ(*requested.body(), "{\n    \"Name\": \"small\"\n}");
+
+    Response noAccept;
+    noAccept.jsonValue["Name"] = "small";
+    completeResponseFields("", "", noAccept);
+    EXPECT_EQ(*noAccept.body(), "{\n  \"Name\": \"small\"\n}");
+}
+
+TEST(HttpResponse, JsonEtagIsWeakAndVariesOnAccept)
+{
+    Response pretty;
+    pretty.jsonValue["Name"] = "small";
+    completeResponseFields("*/*", "", pretty);
+
+    Response compact;
+    compact.jsonValue["Name"] = "small";
+    completeResponseFields("application/json", "", compact);
+
+    // Both bodies carry the same data, so they share a weak tag
+    std::string etag(pretty.getHeaderValue("ETag"));
+    EXPECT_TRUE(etag.starts_with("W/\""));
+    EXPECT_EQ(compact.getHeaderValue("ETag"), etag);
+    EXPECT_EQ(pretty.getHeaderValue("Vary"), "Accept");
+    EXPECT_EQ(compact.getHeaderValue("Vary"), "Accept");
+
+    Response notModified;
+    notModified.jsonValue["Name"] = "small";
+    notModified.setExpectedEtag(etag);
+    completeResponseFields("application/json", "", notModified);
+    EXPECT_EQ(notModified.result(), boost::beast::http::status::not_modified);
+    EXPECT_EQ(notModified.getHeaderValue("Vary"), "Accept");
+}
+
+TEST(HttpResponse, LargeJsonIsStreamed)
+{
+    Response res;
+    for (size_t i = 0; i < bmcweb::jsonStreamMinNodes; i++)
+    {
+        res.jsonValue["Members"].push_back({{"Id", i}});
+    }
+    std::string expected = res.jsonValue.dump(
+        -1, ' ', true, nlohmann::json::error_handler_t::replace);
+    completeResponseFields("application/json", "", res);
+
+    EXPECT_TRUE(res.response.body().isJson());
+    EXPECT_EQ(res.size(), std::nullopt);
+    EXPECT_EQ(res.getHeaderValue("Content-Type"), "application/json");
+    EXPECT_EQ(getData(res.response), expected);
+}
+
 } // namespace
 } // namespace crow
@@ -16,7 +16,7 @@ TEST(HttpServer, getCachedDateStr)
     {};
     FakeHandler handler;
     crow::Server<FakeHandler> server(&handler, {});
-    std::string firstString = server.getCachedDateStrImpl();
+    std::string firstString(server.getCachedDateStrImpl());
     EXPECT_THAT(
         firstString,
         MatchesRegex(
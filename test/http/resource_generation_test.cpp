@@ -0,0 +1,131 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+#include "http/http_response.hpp"
+#include "http/resource_generation.hpp"
+
+#include <boost/beast/http/field.hpp>
+#include <boost/beast/http/status.hpp>
+
+#include <format>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace crow
+{
+namespace
+{
+
+TEST(ConditionalGetCache, NotModifiedUntilGenerationMoves)
+{
+    ResourceGeneration generation;
+    ConditionalGetCache cache;
+
+    std::vector<GenerationSnapshot> generations = {
+        {&generation, generation.get()}};
+    std::string etag = makeGenerationEtag("user /redfish/v1", generations);
+    cache.insert("user /redfish/v1", etag, generations);
+
+    EXPECT_EQ(cache.findCurrentEtag("user /redfish/v1"), etag);
+    EXPECT_EQ(cache.findCurrentEtag("other /redfish/v1"), std::nullopt);
+
+    generation.bump();
+    EXPECT_EQ(cache.findCurrentEtag("user /redfish/v1"), std::nullopt);
+    // The stale entry is dropped once it's found
+    EXPECT_EQ(cache.size(), 0U);
+
+    std::vector<GenerationSnapshot> bumped = {{&generation, generation.get()}};
+    EXPECT_NE(makeGenerationEtag("user /redfish/v1", bumped), etag);
+}
+
+TEST(ConditionalGetCache, StaleEntriesAreEvictedFirst)
+{
+    ResourceGeneration stale;
+    ResourceGeneration current;
+    ConditionalGetCache cache;
+    std::vector<GenerationSnapshot> staleGenerations = {{&stale, stale.get()}};
+    std::vector<GenerationSnapshot> currentGenerations = {
+        {&current, current.get()}};
+    cache.insert("a", "\"a\"", currentGenerations);
+    for (size_t i = 1; i < ConditionalGetCache::maxEntries; i++)
+    {
+        cache.insert("stale" + std::to_string(i), "\"s\"", staleGenerations);
+    }
+    stale.bump();
+    cache.insert("b", "\"b\"", currentGenerations);
+
+    EXPECT_EQ(cache.size(), 2U);
+    EXPECT_EQ(cache.findCurrentEtag("a"), "\"a\"");
+    EXPECT_EQ(cache.findCurrentEtag("b"), "\"b\"");
+}
+
+TEST(HttpResponse, GenerationEtagReplacesJsonHash)
+{
+    ResourceGeneration generation;
+    Response res;
+    res.jsonValue["Name"] = "Test";
+    res.result(boost::beast::http::status::ok);
+    std::string hashEtag = res.getCurrentEtag();
+
+    res.addGeneration(generation);
+    // Without a key from the router the json is still hashed
+    EXPECT_EQ(res.getCurrentEtag(), hashEtag);
+
+    res.setConditionalGetKey(" /redfish/v1/Test");
+    std::string etag = res.getCurrentEtag();
+    EXPECT_NE(etag, hashEtag);
+    EXPECT_EQ(etag, makeGenerationEtag(" /redfish/v1/Test",
+                                       {{&generation, generation.get()}}));
+
+    res.setResponseEtagAndHandleNotModified();
+    EXPECT_EQ(res.getHeaderValue(boost::beast::http::field::etag), etag);
+    EXPECT_EQ(
+        ConditionalGetCache::getInstance().findCurrentEtag(" /redfish/v1/Test"),
+        etag);
+    generation.bump();
+    EXPECT_EQ(
+        ConditionalGetCache::getInstance().findCurrentEtag(" /redfish/v1/Test"),
+        std::nullopt);
+}
+
+TEST(HttpResponse, IgnoredGenerationsKeepJsonHash)
+{
+    ResourceGeneration generation;
+    Response res;
+    res.jsonValue["Name"] = "Test";
+    res.result(boost::beast::http::status::ok);
+    res.setConditionalGetKey(" /redfish/v1/Ignored");
+    std::string hashEtag = res.getCurrentEtag();
+
+    res.addGeneration(generation);
+    res.ignoreGenerations();
+    EXPECT_EQ(res.getCurrentEtag(), hashEtag);
+    // Generations added afterwards are dropped too
+    res.addGeneration(generation);
+    EXPECT_EQ(res.getCurrentEtag(), hashEtag);
+
+    res.setResponseEtagAndHandleNotModified();
+    EXPECT_EQ(ConditionalGetCache::getInstance().findCurrentEtag(
+                  " /redfish/v1/Ignored"),
+              std::nullopt);
+}
+
+TEST(HttpResponse, NotModifiedByAnyTagInIfNoneMatch)
+{
+    Response res;
+    res.jsonValue["Name"] = "Test";
+    res.result(boost::beast::http::status::ok);
+    std::string etag = res.getCurrentEtag();
+    ASSERT_TRUE(etag.starts_with("W/"));
+
+    // Compared weakly, so the strong form of the same tag matches as well
+    res.setExpectedEtag(std::format("\"stale\", {}", etag.substr(2)));
+    res.setResponseEtagAndHandleNotModified();
+    EXPECT_EQ(res.result(), boost::beast::http::status::not_modified);
+    EXPECT_EQ(res.getHeaderValue(boost::beast::http::field::etag), etag);
+}
+
+} // namespace
+} // namespace crow
@@ -0,0 +1,164 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+
+// Times Router::findRoute() over a route set shaped like the Redfish tree.
+// Run with `meson test --benchmark router_benchmark -v`.
+
+#include "async_resp.hpp"
+#include "http_request.hpp"
+#include "routing.hpp"
+
+#include <boost/beast/http/verb.hpp>
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <system_error>
+
+namespace
+{
+
+using boost::beast::http::verb;
+
+constexpr size_t iterations = 200000;
+
+struct BenchmarkRoute
+{
+    std::string_view rule;
+    verb method;
+};
+
+// Most collections and resources are registered once per verb, like the
+// BMCWEB_ROUTE calls in redfish-core
+constexpr std::array<BenchmarkRoute, 40> routes{{
+    {"/redfish/", verb::get},
+    {"/redfish/v1/", verb::get},
+    {"/redfish/v1/odata/", verb::get},
+    {"/redfish/v1/$metadata/", verb::get},
+    {"/redfish/v1/AccountService/", verb::get},
+    {"/redfish/v1/AccountService/", verb::patch},
+    {"/redfish/v1/AccountService/Accounts/", verb::get},
+    {"/redfish/v1/AccountService/Accounts/", verb::post},
+    {"/redfish/v1/AccountService/Accounts/<str>/", verb::get},
+    {"/redfish/v1/AccountService/Accounts/<str>/", verb::patch},
+    {"/redfish/v1/AccountService/Accounts/<str>/", verb::delete_},
+    {"/redfish/v1/Chassis/", verb::get},
+    {"/redfish/v1/Chassis/<str>/", verb::get},
+    {"/redfish/v1/Chassis/<str>/", verb::patch},
+    {"/redfish/v1/Chassis/<str>/Sensors/", verb::get},
+    {"/redfish/v1/Chassis/<str>/Sensors/<str>/", verb::get},
+    {"/redfish/v1/Chassis/<str>/Thermal/", verb::get},
+    {"/redfish/v1/Chassis/<str>/Thermal/", verb::patch},
+    {"/redfish/v1/Chassis/<str>/Power/", verb::get},
+    {"/redfish/v1/Chassis/<str>/Power/", verb::patch},
+    {"/redfish/v1/Managers/", verb::get},
+    {"/redfish/v1/Managers/<str>/", verb::get},
+    {"/redfish/v1/Managers/<str>/", verb::patch},
+    {"/redfish/v1/Managers/<str>/EthernetInterfaces/<str>/", verb::get},
+    {"/redfish/v1/Managers/<str>/EthernetInterfaces/<str>/", verb::patch},
+    {"/redfish/v1/Managers/<str>/LogServices/<str>/Entries/<str>/",
+     verb::get},
+    {"/redfish/v1/SessionService/", verb::get},
+    {"/redfish/v1/SessionService/", verb::patch},
+    {"/redfish/v1/SessionService/Sessions/", verb::get},
+    {"/redfish/v1/SessionService/Sessions/", verb::post},
+    {"/redfish/v1/SessionService/Sessions/<str>/", verb::get},
+    {"/redfish/v1/SessionService/Sessions/<str>/", verb::delete_},
+    {"/redfish/v1/Systems/", verb::get},
+    {"/redfish/v1/Systems/<str>/", verb::get},
+    {"/redfish/v1/Systems/<str>/", verb::patch},
+    {"/redfish/v1/Systems/<str>/Actions/ComputerSystem.Reset/", verb::post},
+    {"/redfish/v1/Systems/<str>/Processors/<str>/", verb::get},
+    {"/redfish/v1/Systems/<str>/Processors/<str>/", verb::patch},
+    {"/redfish/v1/Systems/<str>/LogServices/<str>/Entries/<str>/", verb::get},
+    {"/redfish/v1/Systems/<str>/LogServices/<str>/Entries/<str>/",
+     verb::delete_},
+}};
+
+constexpr std::array<std::string_view, 8> urls{
+    "/redfish/v1/",
+    "/redfish/v1/AccountService/Accounts/root/",
+    "/redfish/v1/Chassis/chassis/Sensors/temperature_ambient/",
+    "/redfish/v1/Chassis/chassis/Power/",
+    "/redfish/v1/Managers/bmc/EthernetInterfaces/eth0/",
+    "/redfish/v1/Systems/system/Processors/cpu0/",
+    "/redfish/v1/Systems/system/LogServices/EventLog/Entries/1234/",
+    "/redfish/v1/NotAResource/",
+};
+
+void addRoute(crow::Router& router, const BenchmarkRoute& route)
+{
+    size_t params = 0;
+    for (size_t pos = route.rule.find("<str>"); pos != std::string_view::npos;
+         pos = route.rule.find("<str>", pos + 1))
+    {
+        params++;
+    }
+    crow::DynamicRule& rule =
+        router.newRuleDynamic(std::string(route.rule)).methods(route.method);
+    using AsyncResp = std::shared_ptr<bmcweb::AsyncResp>;
+    switch (params)
+    {
+        case 0:
+            rule([](const crow::Request&, const AsyncResp&) {});
+            break;
+        case 1:
+            rule([](const crow::Request&, const AsyncResp&, std::string_view) {
+            });
+            break;
+        case 2:
+            rule([](const crow::Request&, const AsyncResp&, std::string_view,
+                    std::string_view) {});
+            break;
+        default:
+            rule([](const crow::Request&, const AsyncResp&, std::string_view,
+                    std::string_view, std::string_view) {});
+            break;
+    }
+}
+
+} // namespace
+
+int main()
+{
+    crow::Router router;
+    for (const BenchmarkRoute& route : routes)
+    {
+        addRoute(router, route);
+    }
+    router.validate();
+
+    std::chrono::nanoseconds total{0};
+    for (std::string_view url : urls)
+    {
+        std::error_code ec;
+        crow::Request req{{verb::get, url, 11}, ec};
+        // Printed, so that the lookups can't be optimized away
+        size_t found = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < iterations; i++)
+        {
+            crow::Router::FindRouteResponse route = router.findRoute(req);
+            if (route.route.rule != nullptr)
+            {
+                found++;
+            }
+        }
+        std::chrono::nanoseconds elapsed =
+            std::chrono::steady_clock::now() - start;
+        total += elapsed;
+        std::printf("%-64s %8.1f ns/lookup, %zu found\n",
+                    std::string(url).c_str(),
+                    static_cast<double>(elapsed.count()) /
+                        static_cast<double>(iterations),
+                    found);
+    }
+    std::printf("%-64s %8.1f ns/lookup\n", "average",
+                static_cast<double>(total.count()) /
+                    static_cast<double>(iterations * urls.size()));
+    return 0;
+}
@@ -92,6 +92,79 @@ TEST(Router, OverlapingRoutes)
     EXPECT_TRUE(barCalled);
 }
 
+TEST(Router, OverlappingRoutesDifferentVerbs)
+{
+    // Callback handler that does nothing
+    auto nullCallback =
+        [](const Request&, const std::shared_ptr<bmcweb::AsyncResp>&) {};
+    auto strCallback = [](const Request&,
+                          const std::shared_ptr<bmcweb::AsyncResp>&,
+                          const std::string&) {};
+
+    Router router;
+    std::error_code ec;
+
+    router.newRuleTagged<getParameterTag("/foo/<str>")>("/foo/<str>")
+        .methods(boost::beast::http::verb::get)(strCallback);
+    router.newRuleTagged<getParameterTag("/foo/bar")>("/foo/bar")
+        .methods(boost::beast::http::verb::post)(nullCallback);
+    router.validate();
+
+    constexpr std::string_view url = "/foo/bar";
+
+    Request getReq{{boost::beast::http::verb::get, url, 11}, ec};
+    Router::FindRouteResponse getRoute = router.findRoute(getReq);
+    EXPECT_EQ(getRoute.allowHeader, "GET, POST");
+    ASSERT_NE(getRoute.route.rule, nullptr);
+    EXPECT_EQ(getRoute.route.rule->rule, "/foo/<str>");
+    ASSERT_EQ(getRoute.route.params.size(), 1U);
+    EXPECT_EQ(getRoute.route.params[0], "bar");
+
+    Request postReq{{boost::beast::http::verb::post, url, 11}, ec};
+    Router::FindRouteResponse postRoute = router.findRoute(postReq);
+    EXPECT_EQ(postRoute.allowHeader, "GET, POST");
+    ASSERT_NE(postRoute.route.rule, nullptr);
+    EXPECT_EQ(postRoute.route.rule->rule, "/foo/bar");
+    EXPECT_TRUE(postRoute.route.params.empty());
+
+    Request deleteReq{{boost::beast::http::verb::delete_, url, 11}, ec};
+    Router::FindRouteResponse deleteRoute = router.findRoute(deleteReq);
+    EXPECT_EQ(deleteRoute.allowHeader, "GET, POST");
+    EXPECT_EQ(deleteRoute.route.rule, nullptr);
+}
+
+TEST(Router, DynamicRuleStringViewParams)
+{
+    Router router;
+    std::error_code ec;
+
+    constexpr std::string_view url = "/foo/bar/baz";
+
+    auto req = std::make_shared<Request>(
+        Request::Body{boost::beast::http::verb::get, url, 11}, ec);
+
+    bool called = false;
+    router.newRuleDynamic("/foo/<str>/<str>")(
+        [&called, &req](const Request&,
+                        const std::shared_ptr<bmcweb::AsyncResp>&,
+                        std::string_view first, const std::string& second) {
+            called = true;
+            EXPECT_EQ(first, "bar");
+            EXPECT_EQ(second, "baz");
+            // string_view params refer directly into the request url
+            std::string_view path = req->url().encoded_path();
+            EXPECT_EQ(first.data(), path.substr(5).data());
+        });
+    router.validate();
+    {
+        std::shared_ptr<bmcweb::AsyncResp> asyncResp =
+            std::make_shared<bmcweb::AsyncResp>();
+
+        router.handle(req, asyncResp);
+    }
+    EXPECT_TRUE(called);
+}
+
 TEST(Router, 404)
 {
     bool notFoundCalled = false;
@@ -3,8 +3,16 @@
 #include "async_resp.hpp"
 #include "dbus_privileges.hpp"
 #include "dbus_utility.hpp"
+#include "io_context_singleton.hpp"
+#include "user_info_cache.hpp"
+
+#include <boost/asio/io_context.hpp>
+#include <boost/system/errc.hpp>
 
 #include <memory>
+#include <string>
+#include <utility>
+#include <vector>
 
 #include <gtest/gtest.h>
 
@@ -80,5 +88,106 @@ TEST(HandleRequestUserInfo, UnauthorizedError)
     EXPECT_FALSE(called);
     EXPECT_EQ(asyncResp->res.resultInt(), 401);
 }
+
+// Stands in for the user manager, recording GetUserInfo calls so tests can
+// complete them on demand.
+struct FakeUserManager
+{
+    std::vector<std::pair<std::string, UserInfoCallback>> pending;
+
+    UserInfoFetcher fetcher()
+    {
+        return [this](const std::string& username,
+                      UserInfoCallback&& callback) {
+            pending.emplace_back(username, std::move(callback));
+        };
+    }
+
+    void reply(const boost::system::error_code& ec)
+    {
+        dbus::utility::DBusPropertiesMap userInfo;
+        userInfo.emplace_back("UserPrivilege",
+                              std::string("priv-administrator"));
+        std::vector<std::pair<std::string, UserInfoCallback>> calls;
+        calls.swap(pending);
+        for (auto& [username, callback] : calls)
+        {
+            callback(ec, userInfo);
+        }
+    }
+};
+
+TEST(RequestUserInfo, CachesUserManagerReply)
+{
+    bmcweb::UserInfoCache cache;
+    FakeUserManager userManager;
+    const std::shared_ptr<bmcweb::AsyncResp> asyncResp =
+        std::make_shared<bmcweb::AsyncResp>();
+
+    int called = 0;
+    auto callback = [&called](const dbus::utility::DBusPropertiesMap&) {
+        called++;
+    };
+
+    requestUserInfo(cache, userManager.fetcher(), "admin", asyncResp,
+                    callback);
+    ASSERT_EQ(userManager.pending.size(), 1U);
+    EXPECT_EQ(userManager.pending[0].first, "admin");
+    userManager.reply({});
+    EXPECT_EQ(called, 1);
+
+    // Second request is served from the cache, but still called back later
+    requestUserInfo(cache, userManager.fetcher(), "admin", asyncResp,
+                    callback);
+    EXPECT_TRUE(userManager.pending.empty());
+    EXPECT_EQ(called, 1);
+    boost::asio::io_context& io = getIoContext();
+    io.restart();
+    io.run();
+    EXPECT_EQ(called, 2);
+    EXPECT_EQ(cache.getStats().hits, 1U);
+    EXPECT_EQ(cache.getStats().misses, 1U);
+
+    // After the user changes, the user manager is asked again
+    cache.invalidate("admin");
+    requestUserInfo(cache, userManager.fetcher(), "admin", asyncResp,
+                    callback);
+    EXPECT_EQ(userManager.pending.size(), 1U);
+    userManager.reply({});
+    EXPECT_EQ(called, 3);
+}
+
+TEST(RequestUserInfo, ErrorsAreNotCached)
+{
+    bmcweb::UserInfoCache cache;
+    FakeUserManager userManager;
+    const std::shared_ptr<bmcweb::AsyncResp> asyncResp =
+        std::make_shared<bmcweb::AsyncResp>();
+
+    bool called = false;
+    requestUserInfo(
+        cache, userManager.fetcher(), "admin", asyncResp,
+        [&called](const dbus::utility::DBusPropertiesMap&) { called = true; });
+    userManager.reply({boost::system::errc::host_unreachable,
+                       boost::system::system_category()});
+    EXPECT_FALSE(called);
+    EXPECT_EQ(asyncResp->res.resultInt(), 500);
+    EXPECT_EQ(cache.size(), 0U);
+}
+
+TEST(RequestUserInfo, InvalidateDuringFetchIsNotCached)
+{
+    bmcweb::UserInfoCache cache;
+    FakeUserManager userManager;
+    const std::shared_ptr<bmcweb::AsyncResp> asyncResp =
+        std::make_shared<bmcweb::AsyncResp>();
+
+    requestUserInfo(cache, userManager.fetcher(), "admin", asyncResp,
+                    [](const dbus::utility::DBusPropertiesMap&) {});
+    // User changed while the GetUserInfo call was outstanding
+    cache.invalidate("admin");
+    userManager.reply({});
+    EXPECT_EQ(cache.size(), 0U);
+}
 } // namespace
 } // namespace crow
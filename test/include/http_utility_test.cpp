@@ -3,6 +3,7 @@
 #include "http_utility.hpp"
 
 #include <array>
+#include <optional>
 
 #include <gtest/gtest.h>
 
@@ -160,5 +161,58 @@ TEST(getPreferredEncoding, NegativeTest)
     EXPECT_EQ(getPreferredEncoding("zstd", contentType2), Encoding::NoMatch);
 }
 
+TEST(getJsonIndent, PositiveTest)
+{
+    EXPECT_EQ(getJsonIndent("application/json;indent=2"), 2);
+    EXPECT_EQ(getJsonIndent("application/json;indent=0"), 0);
+    EXPECT_EQ(getJsonIndent("APPLICATION/JSON; q=1; indent=4"), 4);
+    EXPECT_EQ(getJsonIndent("text/html, application/json;indent=3"), 3);
+}
+
+TEST(getJsonIndent, NegativeTest)
+{
+    EXPECT_EQ(getJsonIndent(""), std::nullopt);
+    EXPECT_EQ(getJsonIndent("application/json"), std::nullopt);
+    EXPECT_EQ(getJsonIndent("application/json;indent=x"), std::nullopt);
+    EXPECT_EQ(getJsonIndent("application/json;indent=100"), std::nullopt);
+    EXPECT_EQ(getJsonIndent("application/json;indent=-1"), std::nullopt);
+    EXPECT_EQ(getJsonIndent("text/html;indent=2"), std::nullopt);
+}
+
+TEST(getResponseJsonIndent, ReadableUnlessJsonIsAskedFor)
+{
+    EXPECT_EQ(getResponseJsonIndent("*/*", ContentType::ANY), 2);
+    EXPECT_EQ(getResponseJsonIndent("application/json", ContentType::JSON),
+              -1);
+    EXPECT_EQ(getResponseJsonIndent("application/json;indent=4",
+                                    ContentType::JSON),
+              4);
+}
+
+TEST(ifNoneMatchMatches, ListsAndWeakTags)
+{
+    EXPECT_TRUE(ifNoneMatchMatches("\"A1\"", "\"A1\""));
+    EXPECT_TRUE(ifNoneMatchMatches("\"B2\", \"A1\"", "\"A1\""));
+    EXPECT_TRUE(ifNoneMatchMatches("\"B2\",\"A1\"", "\"A1\""));
+    EXPECT_TRUE(ifNoneMatchMatches(" *", "\"A1\""));
+    // Weak comparison ignores W/ on either side
+    EXPECT_TRUE(ifNoneMatchMatches("W/\"A1\"", "\"A1\""));
+    EXPECT_TRUE(ifNoneMatchMatches("\"A1\"", "W/\"A1\""));
+    // Commas may be part of a tag
+    EXPECT_TRUE(ifNoneMatchMatches("\"x,y\", \"A1\"", "\"A1\""));
+    EXPECT_FALSE(ifNoneMatchMatches("\"x,y\"", "\"y\""));
+}
+
+TEST(ifNoneMatchMatches, NegativeTest)
+{
+    EXPECT_FALSE(ifNoneMatchMatches("", "\"A1\""));
+    EXPECT_FALSE(ifNoneMatchMatches("\"B2\"", "\"A1\""));
+    EXPECT_FALSE(ifNoneMatchMatches("\"a1\"", "\"A1\""));
+    EXPECT_FALSE(ifNoneMatchMatches("A1", "\"A1\""));
+    EXPECT_FALSE(ifNoneMatchMatches("\"A1", "\"A1\""));
+    EXPECT_FALSE(ifNoneMatchMatches("*, \"B2\"", "\"A1\""));
+    EXPECT_FALSE(ifNoneMatchMatches("*", ""));
+}
+
 } // namespace
 } // namespace http_helpers
@@ -0,0 +1,133 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+#include "json_stream_serializer.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <string_view>
+
+#include <gtest/gtest.h>
+
+namespace bmcweb
+{
+namespace
+{
+
+std::string serialize(const nlohmann::json& value, int indent, size_t chunk)
+{
+    JsonStreamSerializer serializer(value, indent);
+    std::string out;
+    while (!serializer.done())
+    {
+        std::string piece;
+        serializer.next(piece, chunk);
+        EXPECT_FALSE(piece.empty());
+        out += piece;
+    }
+    return out;
+}
+
+std::string dump(const nlohmann::json& value, int indent)
+{
+    return value.dump(indent, ' ', true,
+                      nlohmann::json::error_handler_t::replace);
+}
+
+nlohmann::json sampleDocument()
+{
+    nlohmann::json::object_t members;
+    nlohmann::json::array_t sensors;
+    for (int i = 0; i < 20; i++)
+    {
+        nlohmann::json::object_t sensor;
+        sensor["@odata.id"] =
+            "/redfish/v1/Chassis/chassis/Sensors/temp" + std::to_string(i);
+        sensor["Reading"] = 20.5 + i;
+        sensor["ReadingRangeMax"] = 127;
+        sensor["ReadingRangeMin"] = -128;
+        sensor["Enabled"] = (i % 2) == 0;
+        sensor["Oem"] = nlohmann::json::object();
+        sensor["Links"] = nlohmann::json::array();
+        sensor["Status"] = nullptr;
+        sensors.emplace_back(std::move(sensor));
+    }
+    members["Members"] = std::move(sensors);
+    members["Members@odata.count"] = 20;
+    members["Name"] = "Sensors \"collection\"\n\t\\";
+    members["Nested"] = {{"a", {{"b", {1, 2, {3, 4}}}}}};
+    return members;
+}
+
+TEST(JsonStreamSerializer, MatchesDump)
+{
+    nlohmann::json doc = sampleDocument();
+    for (int indent : {-1, 0, 2, 4})
+    {
+        for (size_t chunk : {1U, 7U, 64U, 4096U, 1048576U})
+        {
+            EXPECT_EQ(serialize(doc, indent, chunk), dump(doc, indent));
+        }
+    }
+}
+
+TEST(JsonStreamSerializer, Scalars)
+{
+    for (const nlohmann::json& value :
+         {nlohmann::json(nullptr), nlohmann::json(true), nlohmann::json(42),
+          nlohmann::json(-7), nlohmann::json(18446744073709551615U),
+          nlohmann::json(std::numeric_limits<int64_t>::min()),
+          nlohmann::json(3.25), nlohmann::json(1e300), nlohmann::json("str"),
+          nlohmann::json::object(), nlohmann::json::array()})
+    {
+        EXPECT_EQ(serialize(value, 2, 16), dump(value, 2));
+    }
+}
+
+TEST(JsonStreamSerializer, EscapesLikeDump)
+{
+    for (std::string_view str : {
+             std::string_view("plain"),
+             std::string_view("\x01\x1f\x7f", 3),
+             std::string_view("caf\xc3\xa9"),
+             std::string_view("\xe2\x82\xac euro"),
+             std::string_view("\xf0\x9f\x98\x80 emoji"),
+             std::string_view("\xff invalid lead"),
+             std::string_view("\xc3 truncated"),
+             std::string_view("\xe2\x82"),
+             std::string_view("\xe0\x80\x80 overlong"),
+             std::string_view("\xed\xa0\x80 surrogate"),
+             std::string_view("\xf4\x90\x80\x80 too large"),
+         })
+    {
+        nlohmann::json value = std::string(str);
+        EXPECT_EQ(serialize(value, -1, 16), dump(value, -1));
+
+        nlohmann::json keyed;
+        keyed[std::string(str)] = 1;
+        EXPECT_EQ(serialize(keyed, 2, 16), dump(keyed, 2));
+    }
+}
+
+TEST(JsonStreamSerializer, SerializeJson)
+{
+    nlohmann::json doc = sampleDocument();
+    EXPECT_EQ(serializeJson(doc, -1), dump(doc, -1));
+    EXPECT_EQ(serializeJson(doc, 2), dump(doc, 2));
+    EXPECT_EQ(serializeJson(nlohmann::json(0.1), 2), "0.1");
+}
+
+TEST(JsonStreamSerializer, CountJsonNodes)
+{
+    nlohmann::json doc = {{"a", {1, 2, 3}}, {"b", nullptr}};
+    EXPECT_EQ(countJsonNodes(doc, 100), 6U);
+    EXPECT_LE(countJsonNodes(doc, 3), 6U);
+    EXPECT_GE(countJsonNodes(doc, 3), 3U);
+    EXPECT_EQ(countJsonNodes(nlohmann::json(1), 100), 1U);
+}
+
+} // namespace
+} // namespace bmcweb
@@ -0,0 +1,364 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+#include "dbus_utility.hpp"
+#include "mapper_cache.hpp"
+
+#include <boost/asio/io_context.hpp>
+#include <boost/system/errc.hpp>
+#include <boost/system/error_code.hpp>
+
+#include <array>
+#include <chrono>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace dbus::utility
+{
+namespace
+{
+
+using Cache = MapperResponseCache<MapperGetSubTreePathsResponse>;
+
+// Stands in for the ObjectMapper.  Calls are held until reply() is called,
+// like a D-Bus call that hasn't returned yet.
+struct FakeMapper
+{
+    void operator()(Cache::Callback&& callback)
+    {
+        calls.emplace_back(std::move(callback));
+    }
+
+    void reply(const boost::system::error_code& ec,
+               const MapperGetSubTreePathsResponse& response)
+    {
+        std::vector<Cache::Callback> replying = std::move(calls);
+        calls.clear();
+        for (Cache::Callback& callback : replying)
+        {
+            callback(ec, response);
+        }
+    }
+
+    std::vector<Cache::Callback> calls;
+};
+
+struct Result
+{
+    int called = 0;
+    boost::system::error_code ec;
+    MapperGetSubTreePathsResponse response;
+
+    Cache::Callback callback()
+    {
+        return [this](const boost::system::error_code& ecIn,
+                      const MapperGetSubTreePathsResponse& responseIn) {
+            called++;
+            ec = ecIn;
+            response = responseIn;
+        };
+    }
+};
+
+const MapperGetSubTreePathsResponse chassis = {
+    "/xyz/openbmc_project/inventory/system/chassis"};
+
+MapperCacheScope inventory()
+{
+    return {"/xyz/openbmc_project/inventory", true,
+            {"xyz.openbmc_project.Inventory.Item.Chassis"}};
+}
+
+TEST(MapperCache, KeyIncludesEveryArgument)
+{
+    constexpr std::array<std::string_view, 1> path{"/xyz"};
+    constexpr std::array<std::string_view, 2> paths{"/xyz", "/abc"};
+    constexpr std::array<std::string_view, 1> board{
+        "xyz.openbmc_project.Inventory.Item.Board"};
+    constexpr std::array<std::string_view, 1> chassisInterface{
+        "xyz.openbmc_project.Inventory.Item.Chassis"};
+
+    std::string key = mapperCacheKey(path, 0, board);
+    EXPECT_EQ(key, mapperCacheKey(path, 0, board));
+    EXPECT_NE(key, mapperCacheKey(path, 1, board));
+    EXPECT_NE(key, mapperCacheKey(path, 0, chassisInterface));
+    EXPECT_NE(key, mapperCacheKey(paths, 0, board));
+    EXPECT_NE(key, mapperCacheKey(path, 0, {}));
+}
+
+TEST(MapperCache, MissThenHit)
+{
+    boost::asio::io_context io;
+    Cache cache(io);
+    FakeMapper mapper;
+
+    Result first;
+    cache.get("key", inventory(), first.callback(), std::ref(mapper));
+    ASSERT_EQ(mapper.calls.size(), 1U);
+    mapper.reply({}, chassis);
+    EXPECT_EQ(first.called, 1);
+    EXPECT_EQ(first.response, chassis);
+
+    // Cached replies are posted rather than called in place
+    Result second;
+    cache.get("key", inventory(), second.callback(), std::ref(mapper));
+    EXPECT_TRUE(mapper.calls.empty());
+    EXPECT_EQ(second.called, 0);
+    io.run();
+    EXPECT_EQ(second.called, 1);
+    EXPECT_FALSE(second.ec);
+    EXPECT_EQ(second.response, chassis);
+
+    EXPECT_EQ(cache.getStats().hits, 1U);
+    EXPECT_EQ(cache.getStats().misses, 1U);
+}
+
+TEST(MapperCache, ConcurrentLookupsShareOneCall)
+{
+    boost::asio::io_context io;
+    Cache cache(io);
+    FakeMapper mapper;
+
+    std::array<Result, 3> results;
+    for (Result& result : results)
+    {
+        cache.get("key", inventory(), result.callback(), std::ref(mapper));
+    }
+    EXPECT_EQ(mapper.calls.size(), 1U);
+    mapper.reply({}, chassis);
+    for (const Result& result : results)
+    {
+        EXPECT_EQ(result.called, 1);
+        EXPECT_EQ(result.response, chassis);
+    }
+    EXPECT_EQ(cache.getStats().misses, 1U);
+    EXPECT_EQ(cache.getStats().coalesced, 2U);
+}
+
+TEST(MapperCache, ErrorsAreNotCached)
+{
+    boost::asio::io_context io;
+    Cache cache(io);
+    FakeMapper mapper;
+
+    Result first;
+    cache.get("key", inventory(), first.callback(), std::ref(mapper));
+    mapper.reply(boost::system::errc::make_error_code(
+                     boost::system::errc::timed_out),
+                 {});
+    EXPECT_EQ(first.called, 1);
+    EXPECT_TRUE(first.ec);
+    EXPECT_EQ(cache.size(), 0U);
+
+    Result second;
+    cache.get("key", inventory(), second.callback(), std::ref(mapper));
+    EXPECT_EQ(mapper.calls.size(), 1U);
+}
+
+TEST(MapperCache, InvalidateDropsEntries)
+{
+    boost::asio::io_context io;
+    Cache cache(io);
+    FakeMapper mapper;
+
+    Result first;
+    cache.get("key", inventory(), first.callback(), std::ref(mapper));
+    mapper.reply({}, chassis);
+    EXPECT_EQ(cache.size(), 1U);
+
+    cache.invalidate();
+    EXPECT_EQ(cache.size(), 0U);
+    Result second;
+    cache.get("key", inventory(), second.callback(), std::ref(mapper));
+    EXPECT_EQ(mapper.calls.size(), 1U);
+}
+
+TEST(MapperCache, ReplyRacingInvalidateIsNotCached)
+{
+    boost::asio::io_context io;
+    Cache cache(io);
+    FakeMapper mapper;
+
+    Result stale;
+    cache.get("key", inventory(), stale.callback(), std::ref(mapper));
+    cache.invalidate();
+
+    // A lookup after the change must not wait on the call made before it
+    Result fresh;
+    cache.get("key", inventory(), fresh.callback(), std::ref(mapper));
+    EXPECT_EQ(mapper.calls.size(), 2U);
+
+    std::vector<Cache::Callback> calls = std::move(mapper.calls);
+    calls[0]({}, {});
+    EXPECT_EQ(stale.called, 1);
+    EXPECT_EQ(fresh.called, 0);
+    EXPECT_EQ(cache.size(), 0U);
+
+    calls[1]({}, chassis);
+    EXPECT_EQ(fresh.called, 1);
+    EXPECT_EQ(fresh.response, chassis);
+    EXPECT_EQ(cache.size(), 1U);
+}
+
+TEST(MapperCache, EntriesExpire)
+{
+    boost::asio::io_context io;
+    Cache cache(io, std::chrono::seconds(10));
+    FakeMapper mapper;
+
+    Result first;
+    cache.get("key", inventory(), first.callback(), std::ref(mapper));
+    mapper.reply({}, chassis);
+
+    Result second;
+    cache.get("key", inventory(), second.callback(), std::ref(mapper),
+              Cache::Clock::now() + std::chrono::seconds(11));
+    EXPECT_EQ(mapper.calls.size(), 1U);
+    EXPECT_EQ(cache.getStats().misses, 2U);
+}
+
+TEST(MapperCache, ScopeCoversChangedObjects)
+{
+    std::vector<std::string> chassisInterface = {
+        "xyz.openbmc_project.Inventory.Item.Chassis"};
+    std::vector<std::string> sensorInterface = {
+        "xyz.openbmc_project.Sensor.Value"};
+
+    MapperCacheScope subtree = inventory();
+    EXPECT_TRUE(subtree.affectedBy(
+        "/xyz/openbmc_project/inventory/system/chassis", chassisInterface));
+    EXPECT_TRUE(
+        subtree.affectedBy("/xyz/openbmc_project/inventory", chassisInterface));
+    EXPECT_TRUE(subtree.affectedBy(
+        "/xyz/openbmc_project/inventory/system/chassis", {}));
+    EXPECT_FALSE(subtree.affectedBy(
+        "/xyz/openbmc_project/inventory/system/chassis", sensorInterface));
+    EXPECT_FALSE(subtree.affectedBy("/xyz/openbmc_project/inventory2/chassis",
+                                    chassisInterface));
+    EXPECT_FALSE(subtree.affectedBy("/xyz/openbmc_project/sensors/temp",
+                                    chassisInterface));
+
+    MapperCacheScope root{"/", true, {}};
+    EXPECT_TRUE(
+        root.affectedBy("/xyz/openbmc_project/sensors/temp", sensorInterface));
+
+    MapperCacheScope object{"/xyz/openbmc_project/inventory", false, {}};
+    EXPECT_TRUE(
+        object.affectedBy("/xyz/openbmc_project/inventory", sensorInterface));
+    EXPECT_FALSE(object.affectedBy(
+        "/xyz/openbmc_project/inventory/system/chassis", sensorInterface));
+}
+
+TEST(MapperCache, InvalidateOnlyDropsAffectedEntries)
+{
+    boost::asio::io_context io;
+    Cache cache(io);
+    FakeMapper mapper;
+
+    Result chassisResult;
+    cache.get("chassis", inventory(), chassisResult.callback(),
+              std::ref(mapper));
+    Result sensorsResult;
+    cache.get("sensors",
+              {"/xyz/openbmc_project/sensors", true,
+               {"xyz.openbmc_project.Sensor.Value"}},
+              sensorsResult.callback(), std::ref(mapper));
+    mapper.reply({}, chassis);
+    EXPECT_EQ(cache.size(), 2U);
+
+    // A sensor appearing doesn't change which chassis there are
+    std::vector<std::string> sensorInterface = {
+        "xyz.openbmc_project.Sensor.Value"};
+    cache.invalidate("/xyz/openbmc_project/sensors/temperature/cpu",
+                     sensorInterface);
+    EXPECT_EQ(cache.size(), 1U);
+
+    Result again;
+    cache.get("chassis", inventory(), again.callback(), std::ref(mapper));
+    EXPECT_TRUE(mapper.calls.empty());
+}
+
+TEST(MapperCache, ReplyRacingAffectedChangeIsNotCached)
+{
+    boost::asio::io_context io;
+    Cache cache(io);
+    FakeMapper mapper;
+
+    Result stale;
+    cache.get("key", inventory(), stale.callback(), std::ref(mapper));
+    std::vector<std::string> chassisInterface = {
+        "xyz.openbmc_project.Inventory.Item.Chassis"};
+    cache.invalidate("/xyz/openbmc_project/inventory/system/chassis2",
+                     chassisInterface);
+
+    // A lookup after the change doesn't wait on the call made before it
+    Result fresh;
+    cache.get("key", inventory(), fresh.callback(), std::ref(mapper));
+    EXPECT_EQ(mapper.calls.size(), 2U);
+
+    std::vector<Cache::Callback> calls = std::move(mapper.calls);
+    calls[0]({}, chassis);
+    EXPECT_EQ(stale.called, 1);
+    EXPECT_EQ(cache.size(), 0U);
+    calls[1]({}, chassis);
+    EXPECT_EQ(fresh.called, 1);
+    EXPECT_EQ(cache.size(), 1U);
+}
+
+TEST(MapperCache, NotCachedWhileServiceIsIntrospected)
+{
+    boost::asio::io_context io;
+    MapperCache cache(io, std::chrono::seconds(60));
+    FakeMapper mapper;
+    auto fetch = [&mapper](Cache::Callback&& reply) {
+        mapper(std::move(reply));
+    };
+    auto lookup = [&](Result& result) {
+        cache.subTreePaths.get("key", inventory(), result.callback(), fetch);
+    };
+
+    cache.serviceStarted("xyz.openbmc_project.EntityManager");
+    Result early;
+    lookup(early);
+    mapper.reply({}, {});
+    EXPECT_EQ(early.called, 1);
+    EXPECT_EQ(cache.subTreePaths.size(), 0U);
+
+    // Made before introspection finished, so its reply may be incomplete
+    Result racing;
+    lookup(racing);
+    cache.introspectionComplete("xyz.openbmc_project.EntityManager");
+    mapper.reply({}, {});
+    EXPECT_EQ(racing.called, 1);
+    EXPECT_EQ(cache.subTreePaths.size(), 0U);
+
+    Result settled;
+    lookup(settled);
+    mapper.reply({}, chassis);
+    EXPECT_EQ(cache.subTreePaths.size(), 1U);
+}
+
+TEST(MapperCache, IntrospectionWaitTimesOut)
+{
+    boost::asio::io_context io;
+    MapperCache cache(io, std::chrono::seconds(0));
+    FakeMapper mapper;
+    auto fetch = [&mapper](Cache::Callback&& reply) {
+        mapper(std::move(reply));
+    };
+
+    // The mapper never introspects some services, so never signals them
+    cache.serviceStarted("org.example.NotIntrospected");
+    io.run_for(std::chrono::seconds(5));
+
+    Result result;
+    cache.subTreePaths.get("key", inventory(), result.callback(), fetch);
+    mapper.reply({}, chassis);
+    EXPECT_EQ(cache.subTreePaths.size(), 1U);
+}
+
+} // namespace
+} // namespace dbus::utility
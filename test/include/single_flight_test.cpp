@@ -0,0 +1,210 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+#include "dbus_utility.hpp"
+#include "single_flight.hpp"
+
+#include <boost/system/errc.hpp>
+#include <boost/system/error_code.hpp>
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace bmcweb
+{
+namespace
+{
+
+using Flight = SingleFlight<std::string>;
+
+// Holds calls until the test replies to them, like D-Bus calls in flight
+struct FakeCalls
+{
+    void operator()(Flight::Callback&& callback)
+    {
+        calls.emplace_back(std::move(callback));
+    }
+
+    std::vector<Flight::Callback> calls;
+};
+
+struct Replies
+{
+    Flight::Callback callback()
+    {
+        return [this](const boost::system::error_code& ec,
+                      const std::string& response) {
+            if (ec)
+            {
+                errors++;
+                return;
+            }
+            responses.emplace_back(response);
+        };
+    }
+
+    int errors = 0;
+    std::vector<std::string> responses;
+};
+
+TEST(SingleFlight, KeyKeepsPartsApart)
+{
+    EXPECT_EQ(singleFlightKey({"a", "bc"}), singleFlightKey({"a", "bc"}));
+    EXPECT_NE(singleFlightKey({"a", "bc"}), singleFlightKey({"ab", "c"}));
+}
+
+TEST(SingleFlight, ManyConcurrentCallersShareOneCall)
+{
+    constexpr size_t callers = 100;
+    Flight flight;
+    FakeCalls fake;
+    Replies replies;
+
+    size_t made = 0;
+    for (size_t i = 0; i < callers; i++)
+    {
+        if (flight.run("key", replies.callback(), std::ref(fake)))
+        {
+            made++;
+        }
+    }
+    EXPECT_EQ(made, 1U);
+    ASSERT_EQ(fake.calls.size(), 1U);
+    EXPECT_EQ(flight.outstanding(), 1U);
+
+    fake.calls[0]({}, "reply");
+    ASSERT_EQ(replies.responses.size(), callers);
+    for (const std::string& response : replies.responses)
+    {
+        EXPECT_EQ(response, "reply");
+    }
+    EXPECT_EQ(flight.outstanding(), 0U);
+    EXPECT_EQ(flight.getStats().calls, 1U);
+    EXPECT_EQ(flight.getStats().saved, callers - 1);
+
+    // Nothing is kept once replied to
+    flight.run("key", replies.callback(), std::ref(fake));
+    EXPECT_EQ(fake.calls.size(), 2U);
+}
+
+TEST(SingleFlight, DistinctKeysMakeTheirOwnCalls)
+{
+    Flight flight;
+    FakeCalls fake;
+    Replies first;
+    Replies second;
+
+    EXPECT_TRUE(flight.run("first", first.callback(), std::ref(fake)));
+    EXPECT_TRUE(flight.run("second", second.callback(), std::ref(fake)));
+    ASSERT_EQ(fake.calls.size(), 2U);
+
+    fake.calls[1]({}, "two");
+    EXPECT_TRUE(first.responses.empty());
+    ASSERT_EQ(second.responses.size(), 1U);
+    EXPECT_EQ(second.responses[0], "two");
+    EXPECT_EQ(flight.outstanding(), 1U);
+}
+
+TEST(SingleFlight, ErrorsReachEveryWaiter)
+{
+    Flight flight;
+    FakeCalls fake;
+    Replies replies;
+
+    flight.run("key", replies.callback(), std::ref(fake));
+    flight.run("key", replies.callback(), std::ref(fake));
+    ASSERT_EQ(fake.calls.size(), 1U);
+    fake.calls[0](
+        boost::system::errc::make_error_code(boost::system::errc::timed_out),
+        "");
+    EXPECT_EQ(replies.errors, 2);
+    EXPECT_TRUE(replies.responses.empty());
+}
+
+TEST(SingleFlight, DetachStartsANewCall)
+{
+    Flight flight;
+    FakeCalls fake;
+    Replies stale;
+    Replies fresh;
+
+    flight.run("key", stale.callback(), std::ref(fake));
+    flight.detach();
+    EXPECT_TRUE(flight.run("key", fresh.callback(), std::ref(fake)));
+    ASSERT_EQ(fake.calls.size(), 2U);
+
+    // The old call finishing must not take the new one's waiters with it
+    fake.calls[0]({}, "old");
+    ASSERT_EQ(stale.responses.size(), 1U);
+    EXPECT_TRUE(fresh.responses.empty());
+    EXPECT_EQ(flight.outstanding(), 1U);
+
+    fake.calls[1]({}, "new");
+    ASSERT_EQ(fresh.responses.size(), 1U);
+    EXPECT_EQ(fresh.responses[0], "new");
+}
+
+TEST(SingleFlight, CallersAfterAWriteDontJoinOlderCalls)
+{
+    Flight flight;
+    FakeCalls fake;
+    Replies beforeWrite;
+    Replies afterWrite;
+    Replies otherKey;
+
+    std::string key = singleFlightKey({"/xyz/openbmc_project/led", "Led"});
+    flight.run(key, beforeWrite.callback(), std::ref(fake));
+    flight.run("other", otherKey.callback(), std::ref(fake));
+    flight.detachIf(
+        [&key](std::string_view outstanding) { return outstanding == key; });
+    EXPECT_EQ(flight.outstanding(), 1U);
+
+    EXPECT_TRUE(flight.run(key, afterWrite.callback(), std::ref(fake)));
+    // Calls for keys that weren't written are still shared
+    EXPECT_FALSE(flight.run("other", otherKey.callback(), std::ref(fake)));
+    ASSERT_EQ(fake.calls.size(), 3U);
+
+    fake.calls[0]({}, "off");
+    fake.calls[2]({}, "on");
+    ASSERT_EQ(beforeWrite.responses.size(), 1U);
+    EXPECT_EQ(beforeWrite.responses[0], "off");
+    ASSERT_EQ(afterWrite.responses.size(), 1U);
+    EXPECT_EQ(afterWrite.responses[0], "on");
+}
+
+TEST(SingleFlight, PropertiesWrittenDetachesPropertyGets)
+{
+    Flight& flight = dbus::utility::details::getPropertyCalls<std::string>();
+    FakeCalls fake;
+    Replies replies;
+
+    std::string written = singleFlightKey(
+        {"/xyz/openbmc_project/led/groups/enclosure_identify",
+         "xyz.openbmc_project.Led.Group", "Asserted", "service"});
+    std::string other = singleFlightKey(
+        {"/xyz/openbmc_project/led/groups/enclosure_identify_blink",
+         "xyz.openbmc_project.Led.Group", "Asserted", "service"});
+    flight.run(written, replies.callback(), std::ref(fake));
+    flight.run(other, replies.callback(), std::ref(fake));
+
+    dbus::utility::propertiesWritten(
+        "/xyz/openbmc_project/led/groups/enclosure_identify",
+        "xyz.openbmc_project.Led.Group");
+    EXPECT_EQ(flight.outstanding(), 1U);
+    EXPECT_TRUE(flight.run(written, replies.callback(), std::ref(fake)));
+
+    for (Flight::Callback& call : fake.calls)
+    {
+        call({}, "done");
+    }
+    EXPECT_EQ(flight.outstanding(), 0U);
+    EXPECT_EQ(replies.responses.size(), 3U);
+}
+
+} // namespace
+} // namespace bmcweb
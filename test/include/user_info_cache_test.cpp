@@ -0,0 +1,94 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+#include "dbus_utility.hpp"
+#include "user_info_cache.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include <gtest/gtest.h>
+
+namespace bmcweb
+{
+namespace
+{
+
+dbus::utility::DBusPropertiesMap makeUserInfo(const std::string& role)
+{
+    dbus::utility::DBusPropertiesMap userInfo;
+    userInfo.emplace_back("UserPrivilege", role);
+    return userInfo;
+}
+
+TEST(UserInfoCache, HitAndMiss)
+{
+    UserInfoCache cache;
+    UserInfoCache::Clock::time_point now = UserInfoCache::Clock::now();
+
+    EXPECT_EQ(cache.find("admin", now), nullptr);
+    cache.insert("admin", cache.beginFetch(),
+                 makeUserInfo("priv-administrator"), now);
+
+    std::shared_ptr<const dbus::utility::DBusPropertiesMap> userInfo =
+        cache.find("admin", now);
+    ASSERT_NE(userInfo, nullptr);
+    EXPECT_EQ(*userInfo, makeUserInfo("priv-administrator"));
+    EXPECT_EQ(cache.find("operator", now), nullptr);
+
+    EXPECT_EQ(cache.getStats().hits, 1U);
+    EXPECT_EQ(cache.getStats().misses, 2U);
+}
+
+TEST(UserInfoCache, Expires)
+{
+    UserInfoCache cache(std::chrono::seconds(10));
+    UserInfoCache::Clock::time_point now = UserInfoCache::Clock::now();
+
+    cache.insert("admin", cache.beginFetch(),
+                 makeUserInfo("priv-administrator"), now);
+    EXPECT_NE(cache.find("admin", now + std::chrono::seconds(9)), nullptr);
+    EXPECT_EQ(cache.find("admin", now + std::chrono::seconds(10)), nullptr);
+    EXPECT_EQ(cache.size(), 0U);
+}
+
+TEST(UserInfoCache, InvalidateDropsEntryAndInflightFetches)
+{
+    UserInfoCache cache;
+    UserInfoCache::Clock::time_point now = UserInfoCache::Clock::now();
+
+    cache.insert("admin", cache.beginFetch(),
+                 makeUserInfo("priv-administrator"), now);
+    uint64_t generation = cache.beginFetch();
+    cache.invalidate("admin");
+    EXPECT_EQ(cache.find("admin", now), nullptr);
+
+    // A fetch started before the invalidation is not cached
+    cache.insert("admin", generation, makeUserInfo("priv-administrator"), now);
+    EXPECT_EQ(cache.find("admin", now), nullptr);
+
+    cache.insert("admin", cache.beginFetch(), makeUserInfo("priv-operator"),
+                 now);
+    std::shared_ptr<const dbus::utility::DBusPropertiesMap> userInfo =
+        cache.find("admin", now);
+    ASSERT_NE(userInfo, nullptr);
+    EXPECT_EQ(*userInfo, makeUserInfo("priv-operator"));
+}
+
+TEST(UserInfoCache, Bounded)
+{
+    UserInfoCache cache;
+    UserInfoCache::Clock::time_point now = UserInfoCache::Clock::now();
+
+    for (size_t i = 0; i < UserInfoCache::maxEntries * 2; i++)
+    {
+        cache.insert("user" + std::to_string(i), cache.beginFetch(),
+                     makeUserInfo("priv-user"), now);
+    }
+    EXPECT_EQ(cache.size(), UserInfoCache::maxEntries);
+}
+
+} // namespace
+} // namespace bmcweb
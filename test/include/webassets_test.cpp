@@ -1,6 +1,19 @@
 // SPDX-License-Identifier: Apache-2.0
 // SPDX-FileCopyrightText: Copyright OpenBMC Authors
+#include "duplicatable_file_handle.hpp"
 #include "webassets.hpp"
+#include "worker_pool.hpp"
+
+#include <zlib.h>
+
+#include <boost/asio/io_context.hpp>
+
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <string>
 
 #include <gtest/gtest.h>
 
@@ -46,5 +59,100 @@ TEST(GetStaticEtagTest, CorrectValues)
     EXPECT_EQ(getStaticEtag("app.63e2c45_.css"), "");
 }
 
+std::string gunzip(const std::string& data)
+{
+    z_stream stream{};
+    EXPECT_EQ(inflateInit2(&stream, MAX_WBITS + 16), Z_OK);
+    std::string out(1024UL * 1024UL, '\0');
+    stream.next_in = std::bit_cast<Bytef*>(data.data());
+    stream.avail_in = static_cast<uInt>(data.size());
+    stream.next_out = std::bit_cast<Bytef*>(out.data());
+    stream.avail_out = static_cast<uInt>(out.size());
+    EXPECT_EQ(inflate(&stream, Z_FINISH), Z_STREAM_END);
+    out.resize(stream.total_out);
+    inflateEnd(&stream);
+    return out;
+}
+
+TEST(LoadStaticFile, CachesContentsAndCompressedCopies)
+{
+    std::string contents;
+    for (size_t i = 0; i < 1000; i++)
+    {
+        contents += "function f() { return 42; }\n";
+    }
+    DuplicatableFileHandle temporaryFile(contents);
+    StaticFile file;
+    file.absolutePath = temporaryFile.filePath;
+
+    size_t cacheRemaining = staticCacheMaxBytes;
+    loadStaticFile(file, cacheRemaining);
+    ASSERT_NE(file.contents, nullptr);
+    EXPECT_EQ(*file.contents, contents);
+    // Unhashed names get an etag from the contents
+    EXPECT_FALSE(file.etag.empty());
+    EXPECT_FALSE(file.hashedName);
+
+    ASSERT_NE(file.gzipContents, nullptr);
+    EXPECT_LT(file.gzipContents->size(), contents.size());
+    EXPECT_EQ(gunzip(*file.gzipContents), contents);
+
+    size_t used = contents.size() + file.gzipContents->size();
+    if (file.zstdContents)
+    {
+        used += file.zstdContents->size();
+    }
+    EXPECT_EQ(cacheRemaining, staticCacheMaxBytes - used);
+}
+
+TEST(LoadStaticFile, SkipsFilesOverBudget)
+{
+    DuplicatableFileHandle temporaryFile("some file contents");
+    StaticFile file;
+    file.absolutePath = temporaryFile.filePath;
+
+    size_t cacheRemaining = 4;
+    loadStaticFile(file, cacheRemaining);
+    EXPECT_EQ(file.contents, nullptr);
+    EXPECT_TRUE(file.etag.empty());
+    EXPECT_EQ(cacheRemaining, 4U);
+}
+
+TEST(LoadStaticFile, DoesNotCompressSmallFiles)
+{
+    DuplicatableFileHandle temporaryFile("small");
+    StaticFile file;
+    file.absolutePath = temporaryFile.filePath;
+
+    size_t cacheRemaining = staticCacheMaxBytes;
+    loadStaticFile(file, cacheRemaining);
+    ASSERT_NE(file.contents, nullptr);
+    EXPECT_EQ(file.gzipContents, nullptr);
+    EXPECT_EQ(file.zstdContents, nullptr);
+}
+
+TEST(LoadStaticFileLater, LoadsOnceOnWorkerPool)
+{
+    DuplicatableFileHandle temporaryFile("some file contents");
+    auto file = std::make_shared<StaticFile>();
+    file->absolutePath = temporaryFile.filePath;
+
+    boost::asio::io_context io;
+    bmcweb::WorkerPool pool(io, 1);
+    size_t cacheRemaining = staticCacheMaxBytes;
+
+    loadStaticFileLater(file, pool, cacheRemaining);
+    // Requests arriving while it loads don't start another load
+    loadStaticFileLater(file, pool, cacheRemaining);
+    EXPECT_EQ(pool.inFlight(), 1U);
+    EXPECT_EQ(file->contents, nullptr);
+
+    io.run_for(std::chrono::seconds(10));
+    EXPECT_EQ(file->cacheState, StaticFile::CacheState::Done);
+    ASSERT_NE(file->contents, nullptr);
+    EXPECT_EQ(*file->contents, "some file contents");
+    EXPECT_EQ(cacheRemaining, staticCacheMaxBytes - file->contents->size());
+}
+
 } // namespace
 } // namespace crow::webassets
@@ -0,0 +1,184 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+#include "worker_pool.hpp"
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/system/error_code.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <future>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+namespace bmcweb
+{
+namespace
+{
+
+using ::testing::ElementsAre;
+using ::testing::UnorderedElementsAre;
+
+TEST(WorkerPool, RunsWorkOffThread)
+{
+    boost::asio::io_context io;
+    WorkerPool pool(io, 2);
+
+    std::thread::id ioThread = std::this_thread::get_id();
+    std::vector<int> results;
+    for (int i = 0; i < 3; i++)
+    {
+        pool.run(
+            [i, ioThread]() {
+                EXPECT_NE(std::this_thread::get_id(), ioThread);
+                return i * 2;
+            },
+            [&results, ioThread](int result) {
+                EXPECT_EQ(std::this_thread::get_id(), ioThread);
+                results.push_back(result);
+            });
+    }
+    EXPECT_EQ(pool.inFlight(), 3U);
+    io.run_for(std::chrono::seconds(10));
+
+    EXPECT_THAT(results, UnorderedElementsAre(0, 2, 4));
+    EXPECT_EQ(pool.inFlight(), 0U);
+}
+
+TEST(WorkerPool, SlowWorkDoesNotBlockIoContext)
+{
+    boost::asio::io_context io;
+    WorkerPool pool(io, 1);
+
+    bool slowDone = false;
+    pool.run(
+        []() {
+            std::this_thread::sleep_for(std::chrono::milliseconds(200));
+            return true;
+        },
+        [&slowDone](bool result) { slowDone = result; });
+
+    bool posted = false;
+    boost::asio::post(io, [&posted, &slowDone]() {
+        // Other io_context work runs while the slow work is in flight
+        EXPECT_FALSE(slowDone);
+        posted = true;
+    });
+    io.run_for(std::chrono::seconds(10));
+    EXPECT_TRUE(posted);
+    EXPECT_TRUE(slowDone);
+}
+
+TEST(WorkerPool, NoThreadsRunsInline)
+{
+    boost::asio::io_context io;
+    WorkerPool pool(io, 0);
+
+    int result = 0;
+    pool.run([]() { return 42; }, [&result](int value) { result = value; });
+    EXPECT_EQ(result, 42);
+}
+
+TEST(WorkerPool, FullOnceEnoughWorkIsQueued)
+{
+    boost::asio::io_context io;
+    WorkerPool pool(io, 1);
+
+    std::promise<void> release;
+    std::shared_future<void> released = release.get_future().share();
+    size_t done = 0;
+    for (size_t i = 0; i < WorkerPool::maxQueuedPerThread; i++)
+    {
+        EXPECT_FALSE(pool.isFull());
+        pool.run(
+            [released]() {
+                released.wait();
+                return true;
+            },
+            [&done](bool /*result*/) { done++; });
+    }
+    EXPECT_TRUE(pool.isFull());
+
+    release.set_value();
+    io.run_for(std::chrono::seconds(10));
+    EXPECT_EQ(done, WorkerPool::maxQueuedPerThread);
+    EXPECT_FALSE(pool.isFull());
+}
+
+TEST(WorkerPool, SlowFileReadsKeepLatencyLow)
+{
+    boost::asio::io_context io;
+    WorkerPool pool(io, 2);
+
+    std::filesystem::path path =
+        std::filesystem::temp_directory_path() / "worker_pool_slow_read";
+    {
+        std::ofstream file(path);
+        file << "log line\n";
+    }
+
+    // Each read stalls the way a large read from slow eMMC does
+    constexpr std::chrono::milliseconds readTime(300);
+    std::vector<std::string> reads;
+    for (int i = 0; i < 4; i++)
+    {
+        pool.run(
+            [&path, readTime]() {
+                std::this_thread::sleep_for(readTime);
+                std::ifstream file(path);
+                std::string line;
+                std::getline(file, line);
+                return line;
+            },
+            [&reads](std::string line) {
+                reads.emplace_back(std::move(line));
+            });
+    }
+
+    // Meanwhile, other requests keep getting handled promptly
+    using Clock = std::chrono::steady_clock;
+    constexpr std::chrono::milliseconds interval(20);
+    boost::asio::steady_timer timer(io);
+    Clock::duration worstDelay{};
+    int handled = 0;
+    Clock::time_point due = Clock::now() + interval;
+    std::function<void(const boost::system::error_code&)> onTimer =
+        [&](const boost::system::error_code& ec) {
+            if (ec)
+            {
+                return;
+            }
+            worstDelay = std::max(worstDelay, Clock::now() - due);
+            handled++;
+            if (handled < 20)
+            {
+                due += interval;
+                timer.expires_at(due);
+                timer.async_wait(onTimer);
+            }
+        };
+    timer.expires_at(due);
+    timer.async_wait(onTimer);
+
+    io.run_for(std::chrono::seconds(10));
+    std::filesystem::remove(path);
+
+    EXPECT_EQ(handled, 20);
+    EXPECT_LT(worstDelay, readTime / 2);
+    EXPECT_THAT(reads, ElementsAre("log line", "log line", "log line",
+                                   "log line"));
+}
+
+} // namespace
+} // namespace bmcweb
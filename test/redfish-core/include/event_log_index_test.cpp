@@ -0,0 +1,161 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+#include "event_log_index.hpp"
+
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace redfish::event_log
+{
+namespace
+{
+
+constexpr std::string_view created = "ResourceEvent.1.0.ResourceCreated";
+constexpr std::string_view unknown = "Unknown.1.0.Message";
+
+class LogIndexTest : public ::testing::Test
+{
+  protected:
+    LogIndexTest() :
+        dir(std::filesystem::temp_directory_path() / "event_log_index_test")
+    {
+        std::filesystem::remove_all(dir);
+        std::filesystem::create_directory(dir);
+    }
+
+    ~LogIndexTest() override
+    {
+        std::filesystem::remove_all(dir);
+    }
+
+    LogIndexTest(const LogIndexTest&) = delete;
+    LogIndexTest(LogIndexTest&&) = delete;
+    LogIndexTest& operator=(const LogIndexTest&) = delete;
+    LogIndexTest& operator=(LogIndexTest&&) = delete;
+
+    void append(const std::string& name, std::string_view time,
+                std::string_view messageId)
+    {
+        std::ofstream file(dir / name, std::ios::app);
+        file << time << " " << messageId << "\n";
+    }
+
+    std::string readAt(const LogIndex::Location& location)
+    {
+        std::ifstream file(location.file);
+        file.seekg(static_cast<std::streamoff>(location.offset));
+        std::string line;
+        std::getline(file, line);
+        return line;
+    }
+
+    std::filesystem::path dir;
+};
+
+TEST_F(LogIndexTest, PagesAcrossFiles)
+{
+    // redfish.1 is older than redfish
+    append("redfish.1", "2000-08-02T03:04:05", created);
+    append("redfish.1", "2000-08-02T03:04:05", unknown);
+    append("redfish", "2000-08-02T03:04:05", created);
+    append("redfish", "2000-08-02T03:04:06", created);
+    append("other", "2000-08-02T03:04:07", created);
+
+    LogIndex index(dir, "redfish");
+    index.update();
+    EXPECT_EQ(index.listedCount(), 3U);
+
+    LogIndex::Page result = index.page(1, 5);
+    EXPECT_EQ(result.listedCount, 3U);
+    std::vector<LogIndex::Location> page = result.locations;
+    ASSERT_EQ(page.size(), 2U);
+    // The unlisted entry still counts towards the IDs
+    EXPECT_EQ(page[0].id, "965185445_2");
+    EXPECT_EQ(page[0].file, dir / "redfish");
+    EXPECT_EQ(readAt(page[0]), "2000-08-02T03:04:05 " + std::string(created));
+    EXPECT_EQ(page[1].id, "965185446");
+
+    page = index.page(0, 1).locations;
+    ASSERT_EQ(page.size(), 1U);
+    EXPECT_EQ(page[0].id, "965185445");
+    EXPECT_EQ(page[0].file, dir / "redfish.1");
+
+    EXPECT_TRUE(index.page(3, 5).locations.empty());
+}
+
+TEST_F(LogIndexTest, FindById)
+{
+    append("redfish.1", "2000-08-02T03:04:05", created);
+    append("redfish", "2000-08-02T03:04:05", unknown);
+    append("redfish", "2000-08-02T03:04:06", created);
+
+    LogIndex index(dir, "redfish");
+    index.update();
+
+    std::optional<LogIndex::Location> location = index.find("965185445_1");
+    ASSERT_TRUE(location);
+    EXPECT_EQ(location->file, dir / "redfish");
+    EXPECT_EQ(location->offset, 0U);
+
+    location = index.find("965185446");
+    ASSERT_TRUE(location);
+    EXPECT_EQ(readAt(*location), "2000-08-02T03:04:06 " + std::string(created));
+
+    EXPECT_FALSE(index.find("965185445_2"));
+    EXPECT_FALSE(index.find("965185445_0"));
+    EXPECT_FALSE(index.find("0965185446"));
+    EXPECT_FALSE(index.find("abc"));
+}
+
+TEST_F(LogIndexTest, AppendAndRotate)
+{
+    append("redfish", "2000-08-02T03:04:05", created);
+    LogIndex index(dir, "redfish");
+    index.update();
+    EXPECT_EQ(index.listedCount(), 1U);
+
+    // A line that is still being written isn't indexed until it's finished
+    {
+        std::ofstream file(dir / "redfish", std::ios::app);
+        file << "2000-08-02T03:04:06 " << created;
+    }
+    index.update();
+    EXPECT_EQ(index.listedCount(), 1U);
+    {
+        std::ofstream file(dir / "redfish", std::ios::app);
+        file << "\n";
+    }
+    index.update();
+    EXPECT_EQ(index.listedCount(), 2U);
+
+    // Rotation keeps the entries already indexed under the new name
+    std::filesystem::rename(dir / "redfish", dir / "redfish.1");
+    append("redfish", "2000-08-02T03:04:07", created);
+    index.update();
+    EXPECT_EQ(index.listedCount(), 3U);
+    std::vector<LogIndex::Location> page = index.page(1, 1).locations;
+    ASSERT_EQ(page.size(), 1U);
+    EXPECT_EQ(page[0].file, dir / "redfish.1");
+    EXPECT_EQ(readAt(page[0]), "2000-08-02T03:04:06 " + std::string(created));
+
+    // A file that is truncated and rewritten is indexed again
+    std::filesystem::remove(dir / "redfish.1");
+    {
+        std::ofstream file(dir / "redfish", std::ios::trunc);
+    }
+    append("redfish", "2000-08-02T03:04:08", created);
+    index.update();
+    EXPECT_EQ(index.listedCount(), 1U);
+    ASSERT_TRUE(index.find("965185448"));
+    EXPECT_FALSE(index.find("965185445"));
+}
+
+} // namespace
+} // namespace redfish::event_log
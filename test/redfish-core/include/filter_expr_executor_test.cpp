@@ -6,8 +6,11 @@
 
 #include <nlohmann/json.hpp>
 
+#include <cstddef>
+#include <cstdint>
 #include <optional>
 #include <string_view>
+#include <utility>
 
 #include <gtest/gtest.h>
 
@@ -268,4 +271,52 @@ TEST(FilterParser, NestedProperty)
     filterFalse("Oem/OEM/ErrorId ne 'SWITCH_EC_STRAP_MISMATCH'", members);
 }
 
+TEST(FilterParser, LogicalOperators)
+{
+    const nlohmann::json members =
+        R"({"Members": [{"Count": 2, "Name": "fan"}]})"_json;
+    filterTrue("Count eq 2 and Name eq 'fan'", members);
+    filterTrue("Count eq 3 or Name eq 'fan'", members);
+    filterTrue("not (Count eq 3)", members);
+    filterTrue("Count eq 2 and (Name eq 'psu' or Count lt 3)", members);
+    filterFalse("Count eq 2 and Name eq 'psu'", members);
+    filterFalse("Count eq 3 or Name eq 'psu'", members);
+    filterFalse("not (Count eq 2)", members);
+    filterFalse("Count eq 2 and not (Name eq 'psu' or Count lt 3)", members);
+}
+
+TEST(FilterParser, KeepsMatchingMembersInOrder)
+{
+    nlohmann::json::array_t memberArr;
+    for (int64_t i = 0; i < 1000; i++)
+    {
+        nlohmann::json::object_t member;
+        member["Count"] = i;
+        memberArr.emplace_back(std::move(member));
+    }
+    nlohmann::json json;
+    json["Members"] = std::move(memberArr);
+
+    std::optional<filter_ast::LogicalAnd> ast =
+        parseFilter("Count ge 100 and Count lt 900");
+    ASSERT_TRUE(ast);
+    EXPECT_TRUE(applyFilterToCollection(json, *ast));
+    ASSERT_EQ(json["Members"].size(), 800);
+    for (size_t i = 0; i < 800; i++)
+    {
+        EXPECT_EQ(json["Members"][i]["Count"], static_cast<int64_t>(i) + 100);
+    }
+}
+
+TEST(FilterParser, CompiledFilterIsReusable)
+{
+    std::optional<filter_ast::LogicalAnd> ast =
+        parseFilter("Severity eq 'Critical'");
+    ASSERT_TRUE(ast);
+    CompiledFilter filter(*ast);
+    EXPECT_TRUE(filter.matches(R"({"Severity": "Critical"})"_json));
+    EXPECT_FALSE(filter.matches(R"({"Severity": "OK"})"_json));
+    EXPECT_TRUE(filter.matches(R"({"Severity": "Critical"})"_json));
+}
+
 } // namespace redfish
@@ -0,0 +1,167 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+#include "gzfile.hpp"
+
+#include <sys/stat.h>
+#include <zlib.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+
+struct Page
+{
+    std::vector<std::string> logEntries;
+    size_t logCount = 0;
+    std::string lastMessage;
+    bool ok = false;
+};
+
+class GzFileReaderTest : public ::testing::Test
+{
+  protected:
+    GzFileReaderTest() :
+        dir(std::filesystem::temp_directory_path() / "gzfile_test")
+    {
+        std::filesystem::remove_all(dir);
+        std::filesystem::create_directory(dir);
+    }
+
+    ~GzFileReaderTest() override
+    {
+        std::filesystem::remove_all(dir);
+    }
+
+    GzFileReaderTest(const GzFileReaderTest&) = delete;
+    GzFileReaderTest(GzFileReaderTest&&) = delete;
+    GzFileReaderTest& operator=(const GzFileReaderTest&) = delete;
+    GzFileReaderTest& operator=(GzFileReaderTest&&) = delete;
+
+    std::string write(const std::string& name, const std::string& contents)
+    {
+        std::string path = (dir / name).string();
+        gzFile file = gzopen(path.c_str(), "wb");
+        EXPECT_NE(file, nullptr);
+        EXPECT_EQ(gzwrite(file, contents.data(),
+                          static_cast<unsigned int>(contents.size())),
+                  static_cast<int>(contents.size()));
+        gzclose(file);
+        return path;
+    }
+
+    static Page read(const std::vector<std::string>& files, uint64_t skip,
+                     uint64_t top, GzFileIndexCache* cache)
+    {
+        Page page;
+        GzFileReader reader(cache);
+        for (const std::string& file : files)
+        {
+            if (!reader.gzGetLines(file, skip, top, page.logEntries,
+                                   page.logCount))
+            {
+                return page;
+            }
+        }
+        page.lastMessage = reader.getLastMessage();
+        page.ok = true;
+        return page;
+    }
+
+    static void expectSamePages(const std::vector<std::string>& files,
+                                GzFileIndexCache& cache)
+    {
+        for (uint64_t skip :
+             {0U, 1U, 9999U, 21000U, 22850U, 24000U, 41000U, 44000U, 60000U})
+        {
+            Page expected = read(files, skip, 20, nullptr);
+            ASSERT_TRUE(expected.ok);
+            // The first read builds the indexes, and the second uses them
+            for (int pass = 0; pass < 2; pass++)
+            {
+                Page page = read(files, skip, 20, &cache);
+                ASSERT_TRUE(page.ok);
+                EXPECT_EQ(page.logEntries, expected.logEntries)
+                    << "skip " << skip;
+                EXPECT_EQ(page.logCount, expected.logCount) << "skip " << skip;
+                EXPECT_EQ(page.lastMessage, expected.lastMessage)
+                    << "skip " << skip;
+            }
+        }
+    }
+
+    std::filesystem::path dir;
+};
+
+std::string makeLog(size_t first, size_t count)
+{
+    std::string log;
+    for (size_t i = first; i < first + count; i++)
+    {
+        log += "host console line " + std::to_string(i);
+        // Mix in the delimiters the parser treats differently
+        log += (i % 7 == 0) ? "\n\n" : "\r\n";
+    }
+    return log;
+}
+
+TEST_F(GzFileReaderTest, IndexedReadsMatchFullReads)
+{
+    // The older file ends part way through an entry that the newer one
+    // finishes
+    std::vector<std::string> files = {
+        write("hostlog.1.gz", makeLog(0, 20000) + "split "),
+        write("hostlog.gz", "entry\r\n" + makeLog(20000, 20000))};
+
+    GzFileIndexCache cache;
+    expectSamePages(files, cache);
+
+    struct stat st{};
+    ASSERT_EQ(stat(files[0].c_str(), &st), 0);
+    std::shared_ptr<const GzFileIndex> index = cache.find(st);
+    ASSERT_NE(index, nullptr);
+    EXPECT_FALSE(index->checkpoints.empty());
+    EXPECT_EQ(index->endMessage, "split ");
+}
+
+TEST_F(GzFileReaderTest, RewrittenFileIsIndexedAgain)
+{
+    std::vector<std::string> files = {write("hostlog.gz", makeLog(0, 30000))};
+    GzFileIndexCache cache;
+    expectSamePages(files, cache);
+
+    std::filesystem::remove(files[0]);
+    files[0] = write("hostlog.gz", makeLog(100000, 45000));
+    expectSamePages(files, cache);
+}
+
+TEST_F(GzFileReaderTest, MultipleMembersAreReadWithoutIndex)
+{
+    std::string path = write("hostlog.gz", makeLog(0, 20000));
+    std::string second = write("second.gz", makeLog(20000, 20000));
+    {
+        // gzip files can be concatenated, and gzread() reads every member
+        std::ifstream in(second, std::ios::binary);
+        std::ofstream out(path, std::ios::binary | std::ios::app);
+        out << in.rdbuf();
+    }
+    std::vector<std::string> files = {path};
+    GzFileIndexCache cache;
+    expectSamePages(files, cache);
+
+    struct stat st{};
+    ASSERT_EQ(stat(path.c_str(), &st), 0);
+    EXPECT_EQ(cache.find(st), nullptr);
+    // Both members are counted
+    EXPECT_GT(read(files, 0, 1, &cache).logCount, 40000U);
+}
+
+} // namespace
@@ -2,6 +2,7 @@
 // SPDX-FileCopyrightText: Copyright OpenBMC Authors
 #include "utils/journal_read_state.hpp"
 
+#include "utils/journal_cursor_cache.hpp"
 #include "utils/journal_utils.hpp"
 
 #include <optional>
@@ -54,5 +55,36 @@ TEST(JournalReadState, TestDataFile)
               "Received client request to rotate journal, rotating.");
     EXPECT_EQ(getJournalMetadataInt(*state, "PRIORITY"), 6);
 }
+
+TEST(JournalReadState, SkipUsesCheckpoints)
+{
+    std::string journalFile(TEST_DATA_DIR "/vacuum.journal");
+    std::optional<JournalReadState> state =
+        JournalReadState::openFile(journalFile);
+    ASSERT_TRUE(state);
+    if (!state)
+    {
+        return;
+    }
+    const std::string second =
+        "s=bf184a6f61fc4619886c6a7c63681ec8;"
+        "i=1210;b=6b5b037894684e1fb93498a9469c8f79;"
+        "m=7882f714;t=63649493027a3;"
+        "x=fbf01ac34e1fade";
+
+    JournalCursorCache cache(1);
+    ASSERT_EQ(state->next(), 1);
+    EXPECT_EQ(skipJournalEntries(*state, cache, 1), 1);
+    EXPECT_EQ(state->getCursor(), second);
+    EXPECT_EQ(cache.size(), 1U);
+    EXPECT_EQ(cache.getStats().misses, 1U);
+
+    // The second time, the checkpoint is used instead of stepping
+    ASSERT_GE(state->seekHead(), 0);
+    ASSERT_EQ(state->next(), 1);
+    EXPECT_EQ(skipJournalEntries(*state, cache, 1), 1);
+    EXPECT_EQ(state->getCursor(), second);
+    EXPECT_EQ(cache.getStats().hits, 1U);
+}
 } // namespace
 } // namespace redfish
@@ -1,6 +1,7 @@
 // SPDX-License-Identifier: Apache-2.0
 // SPDX-FileCopyrightText: Copyright OpenBMC Authors
 #include "async_resp.hpp"
+#include "dbus_utility.hpp"
 #include "error_messages.hpp"
 #include "http_request.hpp"
 #include "http_response.hpp"
@@ -11,12 +12,20 @@
 #include <boost/beast/http/status.hpp>
 #include <boost/beast/http/verb.hpp>
 #include <nlohmann/json.hpp>
+#include <sdbusplus/message/native_types.hpp>
 
+#include <algorithm>
 #include <array>
+#include <cstdint>
+#include <format>
+#include <functional>
 #include <memory>
+#include <optional>
 #include <string>
+#include <string_view>
 #include <system_error>
 #include <utility>
+#include <variant>
 
 #include <gtest/gtest.h>
 
@@ -271,6 +280,92 @@ TEST(addPrefixes, FixHttpHeadersInResponseBody)
         "Location: /redfish/v1/Managers/5B247A_bmc/LogServices/Dump/Entries/0");
 }
 
+TEST(addPrefixesToBody, MatchesAddPrefixes)
+{
+    std::string body = R"(
+    {
+      "@odata.id": "/redfish/v1/TaskService/Tasks/0",
+      "Name": "/redfish/v1/Chassis/fakeName",
+      "Description": "Escaped \"quotes\" and \u00e9",
+      "Payload": {
+        "HttpHeaders": [
+          "Accept: */*",
+          "Location: /redfish/v1/Managers/bmc/LogServices/Dump/Entries/0",
+          {"@odata.id": "/redfish/v1/Chassis/NotAHeader"}
+        ],
+        "TargetUri": "/redfish/v1/Systems/system"
+      },
+      "Links": {
+        "Chassis": [
+          {"@odata.id": "/redfish/v1/Chassis/TestChassis"},
+          {"@odata.id": "/redfish/v1/Chassis/TestChassis2"}
+        ]
+      },
+      "PercentComplete": 100,
+      "Offset": -2,
+      "Reading": 12.5,
+      "Exponent": -1.5e-7,
+      "Matrix": [[1, 2.25], [], [[null, "/redfish/v1/Chassis/InArray"]]],
+      "Enabled": true,
+      "Location": null,
+      "Members": []
+    }
+    )";
+
+    std::optional<PrefixedBody> rewritten = addPrefixesToBody(body, "5B247A");
+    ASSERT_TRUE(rewritten);
+    nlohmann::json expected = nlohmann::json::parse(body);
+    addPrefixes(expected, "5B247A");
+    EXPECT_EQ(nlohmann::json::parse(rewritten->body), expected);
+    EXPECT_EQ(expected["Links"]["Chassis"][1]["@odata.id"],
+              "/redfish/v1/Chassis/5B247A_TestChassis2");
+    EXPECT_FALSE(rewritten->empty);
+}
+
+TEST(addPrefixesToBody, IndentsLikeDump)
+{
+    // Sorted, so that the members are in the same order as in a tree
+    std::string body = R"({"@odata.id": "/redfish/v1/Chassis/TestChassis",
+        "Empty": {}, "Links": {"Chassis": [
+        {"@odata.id": "/redfish/v1/Chassis/A"},
+        {"@odata.id": "/redfish/v1/Chassis/B"}]}, "Members": [],
+        "Values": [1, -2, true, null, "x"]})";
+    nlohmann::json expected = nlohmann::json::parse(body);
+    addPrefixes(expected, "prefix");
+    for (int indent : {-1, 0, 2, 4})
+    {
+        std::optional<PrefixedBody> rewritten =
+            addPrefixesToBody(body, "prefix", indent);
+        ASSERT_TRUE(rewritten);
+        EXPECT_EQ(rewritten->body, expected.dump(indent)) << indent;
+    }
+
+    std::optional<PrefixedBody> empty = addPrefixesToBody(" {} ", "prefix");
+    ASSERT_TRUE(empty);
+    EXPECT_EQ(empty->body, "{}");
+    EXPECT_TRUE(empty->empty);
+    for (std::string_view emptyBody : {"[ ]", "null"})
+    {
+        empty = addPrefixesToBody(emptyBody, "prefix");
+        ASSERT_TRUE(empty);
+        EXPECT_TRUE(empty->empty) << emptyBody;
+    }
+    for (std::string_view value : {"[[]]", "{\"A\": {}}", "0", "\"\"", "false"})
+    {
+        std::optional<PrefixedBody> notEmpty =
+            addPrefixesToBody(value, "prefix");
+        ASSERT_TRUE(notEmpty);
+        EXPECT_FALSE(notEmpty->empty) << value;
+    }
+}
+
+TEST(addPrefixesToBody, InvalidJson)
+{
+    EXPECT_FALSE(addPrefixesToBody("", "prefix"));
+    EXPECT_FALSE(addPrefixesToBody(R"({"@odata.id": )", "prefix"));
+    EXPECT_FALSE(addPrefixesToBody("{} {}", "prefix"));
+}
+
 // Attempts to perform prefix fixing on a response with response code "result".
 // Fixing should always occur
 void assertProcessResponse(unsigned result)
@@ -318,6 +413,74 @@ TEST(processResponse, validResponseCodes)
     assertProcessResponse(507);
 }
 
+TEST(processStreamedResponse, WritesPrefixedBody)
+{
+    crow::Response resp;
+    resp.write(R"({"@odata.id": "/redfish/v1/Chassis/TestChassis",
+                  "Name": "Test"})");
+    resp.addHeader("Content-Type", "application/json");
+    resp.addHeader("ETag", "\"ABCD\"");
+    resp.addHeader("Location", "/redfish/v1/Chassis/TestChassis");
+    resp.result(200);
+
+    auto asyncResp = std::make_shared<bmcweb::AsyncResp>();
+    RedfishAggregator::processStreamedResponse("prefix", 2, asyncResp, resp);
+
+    EXPECT_EQ(asyncResp->res.resultInt(), 200);
+    EXPECT_TRUE(asyncResp->res.jsonValue.empty());
+    EXPECT_EQ(asyncResp->res.getHeaderValue("Content-Type"),
+              "application/json");
+    EXPECT_EQ(asyncResp->res.getHeaderValue("Location"),
+              "/redfish/v1/Chassis/prefix_TestChassis");
+    auto treeResp = std::make_shared<bmcweb::AsyncResp>();
+    RedfishAggregator::processResponse("prefix", treeResp, resp);
+    ASSERT_NE(asyncResp->res.body(), nullptr);
+    std::string body = *asyncResp->res.body();
+    EXPECT_EQ(body,
+              treeResp->res.jsonValue.dump(
+                  2, ' ', true, nlohmann::json::error_handler_t::replace));
+    // The ETag is over the bytes sent, not the satellite's
+    std::string etag =
+        std::format("\"{:08X}\"", std::hash<std::string_view>{}(body));
+    EXPECT_EQ(asyncResp->res.getHeaderValue("ETag"), etag);
+    EXPECT_EQ(asyncResp->res.getHeaderValue("Vary"), "Accept");
+
+    // A compact body is a different representation, with its own ETag
+    auto compactResp = std::make_shared<bmcweb::AsyncResp>();
+    RedfishAggregator::processStreamedResponse("prefix", -1, compactResp,
+                                               resp);
+    EXPECT_NE(compactResp->res.getHeaderValue("ETag"), etag);
+    EXPECT_NE(compactResp->res.getHeaderValue("ETag"), "");
+}
+
+TEST(processStreamedResponse, NotModified)
+{
+    crow::Response resp;
+    resp.write(R"({"@odata.id": "/redfish/v1/Chassis/TestChassis"})");
+    resp.addHeader("Content-Type", "application/json");
+    resp.result(200);
+
+    auto firstResp = std::make_shared<bmcweb::AsyncResp>();
+    RedfishAggregator::processStreamedResponse("prefix", 2, firstResp, resp);
+    std::string etag(firstResp->res.getHeaderValue("ETag"));
+    ASSERT_FALSE(etag.empty());
+
+    auto asyncResp = std::make_shared<bmcweb::AsyncResp>();
+    asyncResp->res.setExpectedEtag(etag);
+    RedfishAggregator::processStreamedResponse("prefix", 2, asyncResp, resp);
+    EXPECT_EQ(asyncResp->res.result(),
+              boost::beast::http::status::not_modified);
+    EXPECT_EQ(asyncResp->res.getHeaderValue("ETag"), etag);
+    EXPECT_EQ(asyncResp->res.getHeaderValue("Vary"), "Accept");
+    ASSERT_NE(asyncResp->res.body(), nullptr);
+    EXPECT_TRUE(asyncResp->res.body()->empty());
+
+    auto staleResp = std::make_shared<bmcweb::AsyncResp>();
+    staleResp->res.setExpectedEtag("\"0000\"");
+    RedfishAggregator::processStreamedResponse("prefix", 2, staleResp, resp);
+    EXPECT_EQ(staleResp->res.result(), boost::beast::http::status::ok);
+}
+
 TEST(processResponse, preserveHeaders)
 {
     auto asyncResp = std::make_shared<bmcweb::AsyncResp>();
@@ -930,5 +1093,60 @@ TEST(createNewRequest, FiltersAuthTokenKeepsHostAndContentType)
     EXPECT_FALSE(hasAuthToken);
 }
 
+TEST(SatelliteConfigCache, FollowsInventorySignals)
+{
+    const std::string path =
+        "/xyz/openbmc_project/inventory/system/board/bmc/satellite";
+    dbus::utility::DBusPropertiesMap properties = {
+        {"Name", std::string("5B247A")},
+        {"Hostname", std::string("127.0.0.1")},
+        {"Port", uint64_t(443)},
+        {"AuthType", std::string("None")}};
+
+    SatelliteConfigCache cache;
+    dbus::utility::ManagedObjectType objects;
+    objects.emplace_back(
+        sdbusplus::object_path(path),
+        dbus::utility::DBusInterfacesMap{
+            {"xyz.openbmc_project.Inventory.Item", {}},
+            {std::string(SatelliteConfigCache::interface), properties}});
+    objects.emplace_back(
+        sdbusplus::object_path("/xyz/openbmc_project/inventory/system/board"),
+        dbus::utility::DBusInterfacesMap{
+            {"xyz.openbmc_project.Inventory.Item.Board", {}}});
+    cache.insert(objects);
+    ASSERT_EQ(cache.get().size(), 1U);
+    EXPECT_EQ(cache.get().begin()->first, path);
+    EXPECT_EQ(cache.get().begin()->second, properties);
+
+    cache.propertiesChanged(path, SatelliteConfigCache::interface,
+                            {{"Port", uint64_t(8443)}});
+    cache.propertiesChanged(path, "xyz.openbmc_project.Inventory.Item",
+                            {{"Port", uint64_t(1)}});
+    const dbus::utility::DBusPropertiesMap& cached =
+        cache.get().begin()->second;
+    auto port = std::ranges::find(
+        cached, "Port",
+        &std::pair<std::string, dbus::utility::DbusVariantType>::first);
+    ASSERT_NE(port, cached.end());
+    EXPECT_EQ(std::get<uint64_t>(port->second), 8443);
+
+    // Removing other interfaces leaves the config alone
+    cache.interfacesRemoved(path, {"xyz.openbmc_project.Inventory.Item"});
+    EXPECT_EQ(cache.get().size(), 1U);
+    cache.interfacesRemoved(path,
+                            {std::string(SatelliteConfigCache::interface)});
+    EXPECT_TRUE(cache.get().empty());
+
+    cache.interfacesAdded(
+        path, {{std::string(SatelliteConfigCache::interface), properties}});
+    ASSERT_EQ(cache.get().size(), 1U);
+    EXPECT_EQ(cache.get().begin()->second, properties);
+
+    // A later fetch replaces everything
+    cache.insert({});
+    EXPECT_TRUE(cache.get().empty());
+}
+
 } // namespace
 } // namespace redfish
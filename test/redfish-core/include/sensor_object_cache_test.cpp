@@ -0,0 +1,169 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+#include "dbus_utility.hpp"
+#include "sensor_object_cache.hpp"
+
+#include <sdbusplus/message/native_types.hpp>
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace redfish
+{
+namespace
+{
+
+constexpr std::string_view service = "xyz.openbmc_project.HwmonTempSensor";
+constexpr std::string_view owner = ":1.42";
+const std::string cpuTemp = "/xyz/openbmc_project/sensors/temperature/cpu";
+const std::string dimmTemp = "/xyz/openbmc_project/sensors/temperature/dimm";
+const std::string valueInterface = "xyz.openbmc_project.Sensor.Value";
+
+dbus::utility::ManagedObjectType makeObjects()
+{
+    dbus::utility::DBusPropertiesMap value;
+    value.emplace_back("Value", 40.0);
+    dbus::utility::DBusInterfacesMap interfaces;
+    interfaces.emplace_back(valueInterface, std::move(value));
+
+    dbus::utility::ManagedObjectType objects;
+    objects.emplace_back(sdbusplus::object_path(dimmTemp), interfaces);
+    objects.emplace_back(sdbusplus::object_path(cpuTemp), interfaces);
+    return objects;
+}
+
+const dbus::utility::DbusVariantType* findProperty(
+    const dbus::utility::ManagedObjectType& objects, const std::string& path,
+    const std::string& interface, const std::string& property)
+{
+    for (const auto& [objectPath, interfaces] : objects)
+    {
+        if (objectPath.str != path)
+        {
+            continue;
+        }
+        for (const auto& [name, properties] : interfaces)
+        {
+            if (name != interface)
+            {
+                continue;
+            }
+            for (const auto& [propertyName, value] : properties)
+            {
+                if (propertyName == property)
+                {
+                    return &value;
+                }
+            }
+        }
+    }
+    return nullptr;
+}
+
+TEST(SensorObjectCache, InsertAndExpire)
+{
+    SensorObjectCache cache;
+    SensorObjectCache::Clock::time_point now =
+        SensorObjectCache::Clock::now();
+    EXPECT_EQ(cache.find(std::string(service), now), nullptr);
+
+    cache.insert(std::string(service), std::string(owner), makeObjects(), now);
+    std::shared_ptr<const dbus::utility::ManagedObjectType> objects =
+        cache.find(std::string(service), now);
+    ASSERT_NE(objects, nullptr);
+    ASSERT_EQ(objects->size(), 2U);
+    // Kept sorted, so that signals can find their object quickly
+    EXPECT_EQ((*objects)[0].first.str, cpuTemp);
+
+    EXPECT_EQ(
+        cache.find(std::string(service), now + SensorObjectCache::maxAge),
+        nullptr);
+}
+
+TEST(SensorObjectCache, PropertiesChanged)
+{
+    SensorObjectCache cache;
+    cache.insert(std::string(service), std::string(owner), makeObjects());
+
+    dbus::utility::DBusPropertiesMap changed;
+    changed.emplace_back("Value", 55.5);
+    changed.emplace_back("MaxValue", 127.0);
+    cache.propertiesChanged(owner, cpuTemp, valueInterface, changed);
+
+    // From a different sender, even for the same path
+    dbus::utility::DBusPropertiesMap other;
+    other.emplace_back("Value", 99.0);
+    cache.propertiesChanged(":1.99", dimmTemp, valueInterface, other);
+
+    std::shared_ptr<const dbus::utility::ManagedObjectType> objects =
+        cache.find(std::string(service));
+    ASSERT_NE(objects, nullptr);
+    const dbus::utility::DbusVariantType* value =
+        findProperty(*objects, cpuTemp, valueInterface, "Value");
+    ASSERT_NE(value, nullptr);
+    EXPECT_EQ(std::get<double>(*value), 55.5);
+    const dbus::utility::DbusVariantType* maxValue =
+        findProperty(*objects, cpuTemp, valueInterface, "MaxValue");
+    ASSERT_NE(maxValue, nullptr);
+    EXPECT_EQ(std::get<double>(*maxValue), 127.0);
+
+    const dbus::utility::DbusVariantType* dimmValue =
+        findProperty(*objects, dimmTemp, valueInterface, "Value");
+    ASSERT_NE(dimmValue, nullptr);
+    EXPECT_EQ(std::get<double>(*dimmValue), 40.0);
+}
+
+TEST(SensorObjectCache, InterfacesAddedAndRemoved)
+{
+    SensorObjectCache cache;
+    cache.insert(std::string(service), std::string(owner), makeObjects());
+
+    const std::string fanPath = "/xyz/openbmc_project/sensors/fan_tach/fan0";
+    const std::string warningInterface =
+        "xyz.openbmc_project.Sensor.Threshold.Warning";
+    dbus::utility::DBusPropertiesMap value;
+    value.emplace_back("Value", 3000.0);
+    dbus::utility::DBusInterfacesMap added;
+    added.emplace_back(valueInterface, value);
+    dbus::utility::DBusPropertiesMap warning;
+    warning.emplace_back("WarningHigh", 9000.0);
+    added.emplace_back(warningInterface, warning);
+    cache.interfacesAdded(owner, fanPath, added);
+
+    std::shared_ptr<const dbus::utility::ManagedObjectType> objects =
+        cache.find(std::string(service));
+    ASSERT_NE(objects, nullptr);
+    ASSERT_EQ(objects->size(), 3U);
+    EXPECT_EQ((*objects)[0].first.str, fanPath);
+    EXPECT_NE(findProperty(*objects, fanPath, warningInterface, "WarningHigh"),
+              nullptr);
+
+    cache.interfacesRemoved(owner, fanPath, {warningInterface});
+    EXPECT_EQ(findProperty(*objects, fanPath, warningInterface, "WarningHigh"),
+              nullptr);
+    EXPECT_NE(findProperty(*objects, fanPath, valueInterface, "Value"),
+              nullptr);
+
+    cache.interfacesRemoved(owner, fanPath, {valueInterface});
+    EXPECT_EQ(objects->size(), 2U);
+}
+
+TEST(SensorObjectCache, OwnerChangeDropsService)
+{
+    SensorObjectCache cache;
+    cache.insert(std::string(service), std::string(owner), makeObjects());
+    cache.ownerChanged("xyz.openbmc_project.FanSensor");
+    EXPECT_NE(cache.find(std::string(service)), nullptr);
+    cache.ownerChanged(service);
+    EXPECT_EQ(cache.find(std::string(service)), nullptr);
+}
+
+} // namespace
+} // namespace redfish
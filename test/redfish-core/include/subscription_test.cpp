@@ -0,0 +1,66 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+#include "event_service_store.hpp"
+#include "filter_expr_parser_ast.hpp"
+#include "filter_expr_printer.hpp"
+#include "subscription.hpp"
+
+#include <boost/asio/io_context.hpp>
+#include <boost/url/url.hpp>
+
+#include <memory>
+#include <optional>
+#include <string>
+
+#include <gtest/gtest.h>
+
+namespace redfish
+{
+namespace
+{
+
+std::shared_ptr<Subscription> makeSubscription(boost::asio::io_context& io,
+                                               const std::string& context)
+{
+    std::shared_ptr<persistent_data::UserSubscription> userSub =
+        std::make_shared<persistent_data::UserSubscription>();
+    userSub->customText = context;
+    userSub->registryPrefixes = {"OpenBMC"};
+    return std::make_shared<Subscription>(
+        userSub, boost::urls::url("https://10.0.0.1/events"), io);
+}
+
+TEST(Subscription, EventLogsKeyGroupsIdenticalFilters)
+{
+    boost::asio::io_context io;
+    std::shared_ptr<Subscription> first = makeSubscription(io, "ctx");
+    std::shared_ptr<Subscription> second = makeSubscription(io, "ctx");
+    std::shared_ptr<Subscription> otherContext = makeSubscription(io, "other");
+
+    std::optional<std::string> key = first->eventLogsKey();
+    ASSERT_TRUE(key);
+    EXPECT_EQ(key, second->eventLogsKey());
+    EXPECT_NE(key, otherContext->eventLogsKey());
+
+    second->userSub->registryPrefixes.emplace_back("Base");
+    EXPECT_NE(key, second->eventLogsKey());
+
+    // Lists are kept apart, so moving an item between them changes the key
+    second->userSub->registryPrefixes = {};
+    second->userSub->registryMsgIds = {"OpenBMC"};
+    EXPECT_NE(key, second->eventLogsKey());
+}
+
+TEST(Subscription, EventLogsKeyNotGroupedWithFilter)
+{
+    boost::asio::io_context io;
+    std::shared_ptr<Subscription> sub = makeSubscription(io, "ctx");
+    std::optional<filter_ast::LogicalAnd> ast =
+        parseFilter("MessageId eq 'OpenBMC.0.1.PowerButtonPressed'");
+    ASSERT_TRUE(ast);
+    sub->filter.emplace(*ast);
+    EXPECT_EQ(sub->eventLogsKey(), std::nullopt);
+}
+
+} // namespace
+} // namespace redfish
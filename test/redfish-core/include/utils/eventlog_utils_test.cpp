@@ -0,0 +1,83 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+#include "bmcweb_config.h"
+
+#include "async_resp.hpp"
+#include "http_response.hpp"
+#include "io_context_singleton.hpp"
+#include "utils/eventlog_utils.hpp"
+#include "utils/query_param.hpp"
+
+#include <boost/asio/io_context.hpp>
+#include <boost/beast/http/status.hpp>
+#include <nlohmann/json.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <utility>
+
+#include <gtest/gtest.h>
+
+namespace redfish::eventlog_utils
+{
+namespace
+{
+
+// Runs handler the way the router does, and returns the response once the
+// file I/O pool has handed its read back to the io_context
+std::optional<crow::Response> runHandler(
+    const std::function<void(const std::shared_ptr<bmcweb::AsyncResp>&)>&
+        handler)
+{
+    std::optional<crow::Response> completed;
+    {
+        auto asyncResp = std::make_shared<bmcweb::AsyncResp>();
+        asyncResp->res.setCompleteRequestHandler(
+            [&completed](crow::Response& res) { completed = std::move(res); });
+        handler(asyncResp);
+    }
+    if constexpr (BMCWEB_FILE_IO_THREADS > 0)
+    {
+        // The read is still on the pool, which holds the response
+        EXPECT_FALSE(completed);
+    }
+    boost::asio::io_context& io = getIoContext();
+    io.restart();
+    while (!completed && io.run_one_for(std::chrono::seconds(10)) > 0)
+    {}
+    return completed;
+}
+
+TEST(EventLogEntryCollection, ReadsOnFileIoPool)
+{
+    std::optional<crow::Response> res =
+        runHandler([](const std::shared_ptr<bmcweb::AsyncResp>& asyncResp) {
+            query_param::Query query;
+            handleSystemsAndManagersLogServiceEventLogLogEntryCollection(
+                asyncResp, query, LogServiceParentCollection::Systems);
+        });
+    ASSERT_TRUE(res);
+    nlohmann::json& json = res->jsonValue;
+    EXPECT_EQ(json["@odata.type"], "#LogEntryCollection.LogEntryCollection");
+    ASSERT_TRUE(json["Members"].is_array());
+    ASSERT_TRUE(json["Members@odata.count"].is_number_unsigned());
+    EXPECT_LE(json["Members"].size(),
+              json["Members@odata.count"].get<size_t>());
+}
+
+TEST(EventLogEntry, UnknownIdIsNotFound)
+{
+    std::optional<crow::Response> res =
+        runHandler([](const std::shared_ptr<bmcweb::AsyncResp>& asyncResp) {
+            handleSystemsAndManagersLogServiceEventLogEntriesGet(
+                asyncResp, "notanid", LogServiceParentCollection::Managers);
+        });
+    ASSERT_TRUE(res);
+    EXPECT_EQ(res->result(), boost::beast::http::status::not_found);
+}
+
+} // namespace
+} // namespace redfish::eventlog_utils
@@ -0,0 +1,83 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+#include "utils/journal_cursor_cache.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+
+#include <gtest/gtest.h>
+
+namespace redfish
+{
+namespace
+{
+
+TEST(JournalCursorCache, FindsDeepestCheckpointBefore)
+{
+    JournalCursorCache cache;
+    cache.setHead("head");
+    uint64_t generation = cache.getGeneration();
+    cache.insert(generation, 1000, "c1000");
+    cache.insert(generation, 2000, "c2000");
+    cache.insert(generation, 2050, "c2050");
+
+    EXPECT_FALSE(cache.findBefore(999));
+
+    std::optional<JournalCursorCache::Checkpoint> checkpoint =
+        cache.findBefore(2049);
+    ASSERT_TRUE(checkpoint);
+    EXPECT_EQ(checkpoint->index, 2000U);
+    EXPECT_EQ(checkpoint->cursor, "c2000");
+
+    checkpoint = cache.findBefore(2050);
+    ASSERT_TRUE(checkpoint);
+    EXPECT_EQ(checkpoint->cursor, "c2050");
+
+    cache.erase(2050);
+    checkpoint = cache.findBefore(5000);
+    ASSERT_TRUE(checkpoint);
+    EXPECT_EQ(checkpoint->index, 2000U);
+}
+
+TEST(JournalCursorCache, HeadChangeDropsCheckpoints)
+{
+    JournalCursorCache cache;
+    cache.setHead("head");
+    uint64_t generation = cache.getGeneration();
+    cache.insert(generation, 1000, "c1000");
+
+    cache.setHead("head");
+    EXPECT_EQ(cache.size(), 1U);
+
+    // Entries were vacuumed, so every index has moved
+    cache.setHead("newhead");
+    EXPECT_EQ(cache.size(), 0U);
+
+    // A checkpoint found before the head moved is ignored
+    cache.insert(generation, 2000, "c2000");
+    EXPECT_EQ(cache.size(), 0U);
+}
+
+TEST(JournalCursorCache, Bounded)
+{
+    JournalCursorCache cache;
+    uint64_t generation = cache.getGeneration();
+    for (size_t i = 1; i <= JournalCursorCache::maxCheckpoints + 10; i++)
+    {
+        cache.insert(generation, i, "cursor" + std::to_string(i));
+    }
+    EXPECT_EQ(cache.size(), JournalCursorCache::maxCheckpoints);
+    // The shallowest went first
+    EXPECT_FALSE(cache.findBefore(10));
+    EXPECT_TRUE(cache.findBefore(11));
+
+    // Index 0 is the head, which needs no checkpoint
+    JournalCursorCache empty;
+    empty.insert(empty.getGeneration(), 0, "head");
+    EXPECT_EQ(empty.size(), 0U);
+}
+
+} // namespace
+} // namespace redfish
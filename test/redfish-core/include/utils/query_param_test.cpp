@@ -2,18 +2,28 @@
 // SPDX-FileCopyrightText: Copyright OpenBMC Authors
 #include "bmcweb_config.h"
 
+#include "app.hpp"
+#include "async_resp.hpp"
+#include "http_request.hpp"
 #include "http_response.hpp"
+#include "query.hpp"
+#include "sessions.hpp"
 #include "utils/query_param.hpp"
 
 #include <boost/beast/http/status.hpp>
+#include <boost/beast/http/verb.hpp>
 #include <boost/system/result.hpp>
 #include <boost/url/parse.hpp>
 #include <boost/url/url_view.hpp>
 #include <nlohmann/json.hpp>
 
+#include <algorithm>
+#include <cstddef>
+#include <memory>
 #include <optional>
 #include <span>
 #include <string>
+#include <system_error>
 #include <utility>
 #include <vector>
 
@@ -783,5 +793,118 @@ TEST(QueryParams, PartiallyPreviouslyExpanded)
                        "/redfish/v1/Chassis/5B247A_Sat1/Sensors"}));
 }
 
+// A Chassis collection whose members all link to the same Manager.  Handlers
+// hold on to their responses until the test releases them, so that sub-requests
+// stay in flight the way they do while waiting on D-Bus.
+TEST(ExpandEngine, SharesLinkedResourcesAndLimitsFanOut)
+{
+    constexpr size_t chassisCount = 40;
+    crow::App app;
+    std::vector<std::shared_ptr<bmcweb::AsyncResp>> pending;
+    size_t chassisCalls = 0;
+    size_t managerCalls = 0;
+
+    BMCWEB_ROUTE(app, "/redfish/v1/Chassis/")
+        .methods(boost::beast::http::verb::get)(
+            [&app, &pending](
+                const crow::Request& req,
+                const std::shared_ptr<bmcweb::AsyncResp>& asyncResp) {
+                if (!redfish::setUpRedfishRoute(app, req, asyncResp))
+                {
+                    return;
+                }
+                nlohmann::json::array_t members;
+                for (size_t i = 0; i < chassisCount; i++)
+                {
+                    nlohmann::json::object_t member;
+                    member["@odata.id"] =
+                        "/redfish/v1/Chassis/" + std::to_string(i);
+                    members.emplace_back(std::move(member));
+                }
+                asyncResp->res.jsonValue["@odata.id"] = "/redfish/v1/Chassis";
+                asyncResp->res.jsonValue["Members"] = std::move(members);
+                pending.push_back(asyncResp);
+            });
+    BMCWEB_ROUTE(app, "/redfish/v1/Chassis/<str>/")
+        .methods(boost::beast::http::verb::get)(
+            [&app, &pending, &chassisCalls](
+                const crow::Request& req,
+                const std::shared_ptr<bmcweb::AsyncResp>& asyncResp,
+                const std::string& id) {
+                if (!redfish::setUpRedfishRoute(app, req, asyncResp))
+                {
+                    return;
+                }
+                chassisCalls++;
+                asyncResp->res.jsonValue["@odata.id"] =
+                    "/redfish/v1/Chassis/" + id;
+                asyncResp->res.jsonValue["Id"] = id;
+                asyncResp->res.jsonValue["Links"]["ManagedBy"][0]["@odata.id"] =
+                    "/redfish/v1/Managers/bmc";
+                pending.push_back(asyncResp);
+            });
+    BMCWEB_ROUTE(app, "/redfish/v1/Managers/<str>/")
+        .methods(boost::beast::http::verb::get)(
+            [&app, &pending, &managerCalls](
+                const crow::Request& req,
+                const std::shared_ptr<bmcweb::AsyncResp>& asyncResp,
+                const std::string& id) {
+                if (!redfish::setUpRedfishRoute(app, req, asyncResp))
+                {
+                    return;
+                }
+                managerCalls++;
+                asyncResp->res.jsonValue["@odata.id"] =
+                    "/redfish/v1/Managers/" + id;
+                asyncResp->res.jsonValue["Id"] = id;
+                pending.push_back(asyncResp);
+            });
+    app.validate();
+
+    std::error_code ec;
+    auto req = std::make_shared<crow::Request>(
+        crow::Request::Body{boost::beast::http::verb::get,
+                            "/redfish/v1/Chassis?$expand=*($levels=2)", 11},
+        ec);
+    ASSERT_FALSE(ec);
+    req->session = std::make_shared<persistent_data::UserSession>();
+    req->session->userRole = "priv-admin";
+    // Stands in for the user info fetched when the request was authenticated
+    req->userInfoPopulated = true;
+
+    nlohmann::json result;
+    {
+        auto asyncResp = std::make_shared<bmcweb::AsyncResp>();
+        asyncResp->res.setCompleteRequestHandler(
+            [&result](crow::Response& res) { result = res.jsonValue; });
+        app.handle(req, asyncResp);
+    }
+
+    size_t peakInFlight = 0;
+    while (!pending.empty())
+    {
+        peakInFlight = std::max(peakInFlight, pending.size());
+        std::vector<std::shared_ptr<bmcweb::AsyncResp>> completing;
+        completing.swap(pending);
+        // Completing responses starts the sub-requests waiting on them
+        completing.clear();
+    }
+
+    EXPECT_EQ(chassisCalls, chassisCount);
+    EXPECT_EQ(managerCalls, 1U);
+    EXPECT_LE(peakInFlight, static_cast<size_t>(BMCWEB_EXPAND_MAX_IN_FLIGHT));
+
+    const nlohmann::json::array_t* members =
+        result["Members"].get_ptr<const nlohmann::json::array_t*>();
+    ASSERT_NE(members, nullptr);
+    ASSERT_EQ(members->size(), chassisCount);
+    for (size_t i = 0; i < chassisCount; i++)
+    {
+        const nlohmann::json& member = (*members)[i];
+        EXPECT_EQ(member["Id"], std::to_string(i));
+        EXPECT_EQ(member["Links"]["ManagedBy"][0]["Id"], "bmc");
+    }
+}
+
 } // namespace
 } // namespace redfish::query_param
@@ -4,12 +4,14 @@
 
 #include "async_resp.hpp"
 #include "http_response.hpp"
+#include "persistent_data.hpp"
 #include "service_root.hpp"
 
 #include <nlohmann/json.hpp>
 
 #include <cstddef>
 #include <memory>
+#include <string>
 
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
@@ -139,5 +141,28 @@ TEST(HandleServiceRootGet, ServiceRootStaticAttributesAreExpected)
     redfish::handleServiceRootGetImpl(shareAsyncResp);
 }
 
+std::string getServiceRootEtag()
+{
+    std::string etag;
+    {
+        auto asyncResp = std::make_shared<bmcweb::AsyncResp>();
+        asyncResp->res.setConditionalGetKey(" /redfish/v1");
+        asyncResp->res.setCompleteRequestHandler(
+            [&etag](crow::Response& res) { etag = res.getCurrentEtag(); });
+        redfish::handleServiceRootGetImpl(asyncResp);
+    }
+    return etag;
+}
+
+TEST(HandleServiceRootGet, EtagFollowsConfigGeneration)
+{
+    std::string etag = getServiceRootEtag();
+    EXPECT_FALSE(etag.empty());
+    EXPECT_EQ(getServiceRootEtag(), etag);
+
+    persistent_data::getConfig().generation.bump();
+    EXPECT_NE(getServiceRootEtag(), etag);
+}
+
 } // namespace
 } // namespace redfish
@@ -0,0 +1,64 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: Copyright OpenBMC Authors
+#include "bmcweb_config.h"
+
+#include "app.hpp"
+#include "async_resp.hpp"
+#include "http_request.hpp"
+#include "http_response.hpp"
+#include "io_context_singleton.hpp"
+#include "systems_logservices_hostlogger.hpp"
+
+#include <boost/asio/io_context.hpp>
+#include <boost/beast/http/verb.hpp>
+#include <nlohmann/json.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <system_error>
+#include <utility>
+
+#include <gtest/gtest.h>
+
+namespace redfish
+{
+namespace
+{
+
+TEST(HandleSystemsLogServicesHostloggerEntriesGet, ReadsOnFileIoPool)
+{
+    std::optional<crow::Response> completed;
+    {
+        auto asyncResp = std::make_shared<bmcweb::AsyncResp>();
+        asyncResp->res.setCompleteRequestHandler(
+            [&completed](crow::Response& res) { completed = std::move(res); });
+        std::error_code err;
+        crow::Request request{{boost::beast::http::verb::get, "/whatever", 11},
+                              err};
+        crow::App app;
+        handleSystemsLogServicesHostloggerEntriesGet(
+            app, request, asyncResp, BMCWEB_REDFISH_SYSTEM_URI_NAME);
+    }
+    if constexpr (BMCWEB_FILE_IO_THREADS > 0)
+    {
+        // The logs are still being read on the pool, which holds the response
+        EXPECT_FALSE(completed);
+    }
+    boost::asio::io_context& io = getIoContext();
+    io.restart();
+    while (!completed && io.run_one_for(std::chrono::seconds(10)) > 0)
+    {}
+
+    ASSERT_TRUE(completed);
+    nlohmann::json& json = completed->jsonValue;
+    EXPECT_EQ(json["Name"], "HostLogger Entries");
+    ASSERT_TRUE(json["Members"].is_array());
+    ASSERT_TRUE(json["Members@odata.count"].is_number_unsigned());
+    EXPECT_LE(json["Members"].size(),
+              json["Members@odata.count"].get<size_t>());
+}
+
+} // namespace
+} // namespace redfish